@@ -0,0 +1,218 @@
+#include "G4EventCache.hh"
+#include "WirechamberCalibrator.hh"
+#include "SMExcept.hh"
+#include <TChain.h>
+#include <string.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+static const char cacheMagic[8] = {'G','4','E','V','C','0','0','1'};
+
+const char* G4EventCache::colName(G4CacheColumn c) {
+	static const char* names[G4C_NCOLUMNS] = {
+		"EdepQ","Edep","MWPCEnergy","ScintPos","MWPCPos","time","primTheta","primKE","primPos",
+		"Cath_EX","Cath_EY","Cath_WX","Cath_WY",
+		"EdepSD","thetaInSD","thetaOutSD","keInSD","keOutSD" };
+	smassert(c < G4C_NCOLUMNS);
+	return names[c];
+}
+
+/// whether column is read from a float (rather than double) branch
+static bool isFloatColumn(unsigned int c) { return c >= G4C_CATH_EX && c <= G4C_CATH_WY; }
+
+/// align byte offset up to multiple of a
+static uint64_t alignUp(uint64_t x, uint64_t a) { return ((x+a-1)/a)*a; }
+
+void G4EventCache::build(const std::vector<std::string>& files, const std::string& fname) {
+	smassert(files.size());
+	
+	// assemble input chain, counting events in each file
+	TChain ch("anaTree");
+	std::vector<unsigned int> nn;
+	unsigned int nEvts = 0;
+	for(std::vector<std::string>::const_iterator it = files.begin(); it != files.end(); it++) {
+		if(!ch.Add(it->c_str(),0)) {
+			SMExcept e("missingFiles");
+			e.insert("fileName",*it);
+			throw e;
+		}
+		unsigned int n1 = ch.GetEntries();
+		nn.push_back(n1-nEvts);
+		nEvts = n1;
+	}
+	printf("Building columnar cache '%s' for %i events in %i files...\n",fname.c_str(),nEvts,(int)files.size());
+	smassert(nEvts);
+	ch.LoadTree(0);
+	
+	// column widths; optional columns only if present in input
+	uint32_t w[G4C_NCOLUMNS] = { BOTH, BOTH, BOTH, BOTH*3, BOTH*3, BOTH, 1, 1, 4,
+		kMaxCathodes, kMaxCathodes, kMaxCathodes, kMaxCathodes, N_SD, N_SD, N_SD, N_SD, N_SD };
+	for(unsigned int c = G4C_CATH_EX; c < G4C_NCOLUMNS; c++)
+		if(!ch.GetBranch(colName(G4CacheColumn(c)))) w[c] = 0;
+	
+	// read points
+	std::vector<double> dbuf[G4C_NCOLUMNS];
+	std::vector<float> fbuf[G4C_NCOLUMNS];
+	for(unsigned int c = 0; c < G4C_NCOLUMNS; c++) {
+		if(!w[c]) continue;
+		if(isFloatColumn(c)) {
+			fbuf[c].resize(w[c]);
+			ch.SetBranchAddress(colName(G4CacheColumn(c)),&fbuf[c][0]);
+		} else {
+			dbuf[c].resize(w[c]);
+			ch.SetBranchAddress(colName(G4CacheColumn(c)),&dbuf[c][0]);
+		}
+	}
+	
+	// header layout
+	uint64_t hsize = sizeof(cacheMagic) + 3*sizeof(uint32_t) + G4C_NCOLUMNS*(sizeof(uint32_t)+sizeof(uint64_t));
+	for(std::vector<std::string>::const_iterator it = files.begin(); it != files.end(); it++)
+		hsize += 2*sizeof(uint32_t)+it->size();
+	uint64_t offset[G4C_NCOLUMNS];
+	uint64_t pos = alignUp(hsize,4096);
+	for(unsigned int c = 0; c < G4C_NCOLUMNS; c++) {
+		offset[c] = pos;
+		pos = alignUp(pos + (uint64_t)nEvts*w[c]*sizeof(float), 64);
+	}
+	
+	// write header
+	std::string tmpname = fname+".tmp";
+	FILE* f = fopen(tmpname.c_str(),"wb");
+	if(!f) {
+		SMExcept e("fileWriteError");
+		e.insert("fileName",tmpname);
+		throw e;
+	}
+	uint32_t nf = files.size();
+	uint32_t nc = G4C_NCOLUMNS;
+	fwrite(cacheMagic,sizeof(cacheMagic),1,f);
+	fwrite(&nEvts,sizeof(uint32_t),1,f);
+	fwrite(&nf,sizeof(uint32_t),1,f);
+	fwrite(&nc,sizeof(uint32_t),1,f);
+	for(unsigned int c = 0; c < G4C_NCOLUMNS; c++) {
+		fwrite(&w[c],sizeof(uint32_t),1,f);
+		fwrite(&offset[c],sizeof(uint64_t),1,f);
+	}
+	for(unsigned int i=0; i<files.size(); i++) {
+		uint32_t n = nn[i];
+		uint32_t l = files[i].size();
+		fwrite(&n,sizeof(uint32_t),1,f);
+		fwrite(&l,sizeof(uint32_t),1,f);
+		fwrite(files[i].data(),1,l,f);
+	}
+	
+	// transpose events into columns, one chunk at a time
+	const unsigned int nChunk = 1<<16;
+	std::vector<float> chunk[G4C_NCOLUMNS];
+	for(unsigned int c = 0; c < G4C_NCOLUMNS; c++) chunk[c].resize(nChunk*w[c]);
+	for(unsigned int e0 = 0; e0 < nEvts; e0 += nChunk) {
+		const unsigned int n = (nEvts-e0 < nChunk)?nEvts-e0:nChunk;
+		for(unsigned int i = 0; i < n; i++) {
+			ch.GetEntry(e0+i);
+			for(unsigned int c = 0; c < G4C_NCOLUMNS; c++) {
+				if(!w[c]) continue;
+				float* dest = &chunk[c][0]+i*w[c];
+				if(isFloatColumn(c)) for(unsigned int j=0; j<w[c]; j++) dest[j] = fbuf[c][j];
+				else for(unsigned int j=0; j<w[c]; j++) dest[j] = dbuf[c][j];
+			}
+		}
+		for(unsigned int c = 0; c < G4C_NCOLUMNS; c++) {
+			if(!w[c]) continue;
+			fseeko(f, offset[c]+(uint64_t)e0*w[c]*sizeof(float), SEEK_SET);
+			fwrite(&chunk[c][0],sizeof(float),(size_t)n*w[c],f);
+		}
+		printf("*"); fflush(stdout);
+	}
+	printf("\n");
+	
+	if(fclose(f) || rename(tmpname.c_str(),fname.c_str())) {
+		SMExcept e("fileWriteError");
+		e.insert("fileName",fname);
+		throw e;
+	}
+}
+
+G4EventCache::G4EventCache(const std::string& fn, bool useMmap): fname(fn), nEvts(0), fin(NULL), mapped(NULL), mapLen(0) {
+	for(unsigned int c = 0; c < G4C_NCOLUMNS; c++) isLoaded[c] = false;
+	
+	fin = fopen(fname.c_str(),"rb");
+	if(!fin) {
+		SMExcept e("missingFiles");
+		e.insert("fileName",fname);
+		throw e;
+	}
+	char magic[sizeof(cacheMagic)];
+	uint32_t nf = 0;
+	uint32_t nc = 0;
+	bool ok = fread(magic,sizeof(magic),1,fin) == 1 && !memcmp(magic,cacheMagic,sizeof(magic));
+	ok = ok && fread(&nEvts,sizeof(uint32_t),1,fin) == 1;
+	ok = ok && fread(&nf,sizeof(uint32_t),1,fin) == 1;
+	ok = ok && fread(&nc,sizeof(uint32_t),1,fin) == 1 && nc == G4C_NCOLUMNS;
+	for(unsigned int c = 0; ok && c < G4C_NCOLUMNS; c++)
+		ok = fread(&cols[c].width,sizeof(uint32_t),1,fin) == 1 && fread(&cols[c].offset,sizeof(uint64_t),1,fin) == 1;
+	unsigned int e0 = 0;
+	for(unsigned int i=0; ok && i<nf; i++) {
+		uint32_t n,l;
+		ok = fread(&n,sizeof(uint32_t),1,fin) == 1 && fread(&l,sizeof(uint32_t),1,fin) == 1;
+		if(!ok) break;
+		std::string s(l,' ');
+		ok = !l || fread(&s[0],1,l,fin) == l;
+		srcFiles.push_back(s);
+		srcStart.push_back(e0);
+		srcN.push_back(n);
+		e0 += n;
+	}
+	if(!ok || e0 != nEvts) {
+		fclose(fin);
+		SMExcept e("badCacheFile");
+		e.insert("fileName",fname);
+		throw e;
+	}
+	
+	if(useMmap) {
+		int fd = open(fname.c_str(),O_RDONLY);
+		struct stat st;
+		if(fd >= 0 && !fstat(fd,&st)) {
+			mapLen = st.st_size;
+			mapped = mmap(NULL,mapLen,PROT_READ,MAP_SHARED,fd,0);
+			if(mapped == MAP_FAILED) { mapped = NULL; mapLen = 0; }
+		}
+		if(fd >= 0) close(fd);
+		if(!mapped) printf("Memory-mapping '%s' failed; reading columns on demand.\n",fname.c_str());
+	}
+}
+
+G4EventCache::~G4EventCache() {
+	if(mapped) munmap(mapped,mapLen);
+	if(fin) fclose(fin);
+}
+
+const float* G4EventCache::column(G4CacheColumn c) {
+	smassert(c < G4C_NCOLUMNS);
+	if(!cols[c].width) return NULL;
+	if(mapped) return (const float*)((const char*)mapped+cols[c].offset);
+	std::lock_guard<std::mutex> l(loadLock);
+	if(!isLoaded[c]) {
+		loaded[c].resize((size_t)nEvts*cols[c].width);
+		if(fseeko(fin,cols[c].offset,SEEK_SET) || fread(&loaded[c][0],sizeof(float),loaded[c].size(),fin) != loaded[c].size()) {
+			SMExcept e("badCacheFile");
+			e.insert("fileName",fname);
+			e.insert("column",colName(c));
+			throw e;
+		}
+		isLoaded[c] = true;
+	}
+	return &loaded[c][0];
+}
+
+bool G4EventCache::fileRange(const std::string& fn, unsigned int& e0, unsigned int& n) const {
+	for(unsigned int i=0; i<srcFiles.size(); i++) {
+		if(srcFiles[i] != fn) continue;
+		e0 = srcStart[i];
+		n = srcN[i];
+		return true;
+	}
+	return false;
+}
@@ -0,0 +1,83 @@
+#ifndef G4EVENTCACHE_HH
+#define G4EVENTCACHE_HH
+
+#include "Types.hh"
+#include <string>
+#include <vector>
+#include <mutex>
+#include <stdio.h>
+#include <stdint.h>
+
+/// number of Geant4 sensitive detector volumes in ``extended'' anaTree branches
+#define N_SD 24
+
+/// columns stored in G4EventCache (named after anaTree branches)
+enum G4CacheColumn {
+	G4C_EDEPQ,		///< EdepQ[side]
+	G4C_EDEP,		///< Edep[side]
+	G4C_MWPCE,		///< MWPCEnergy[side]
+	G4C_SCINTPOS,	///< ScintPos[side][xyz]
+	G4C_MWPCPOS,	///< MWPCPos[side][xyz]
+	G4C_TIME,		///< time[side]
+	G4C_PRIMTHETA,	///< primTheta
+	G4C_PRIMKE,		///< primKE
+	G4C_PRIMPOS,	///< primPos[xyzr]
+	G4C_CATH_EX,	///< Cath_EX[cathode] (optional)
+	G4C_CATH_EY,	///< Cath_EY[cathode] (optional)
+	G4C_CATH_WX,	///< Cath_WX[cathode] (optional)
+	G4C_CATH_WY,	///< Cath_WY[cathode] (optional)
+	G4C_EDEPSD,		///< EdepSD[detector] (optional, ``extended'')
+	G4C_THETAINSD,	///< thetaInSD[detector] (optional, ``extended'')
+	G4C_THETAOUTSD,	///< thetaOutSD[detector] (optional, ``extended'')
+	G4C_KEINSD,		///< keInSD[detector] (optional, ``extended'')
+	G4C_KEOUTSD,	///< keOutSD[detector] (optional, ``extended'')
+	G4C_NCOLUMNS	///< number of columns
+};
+
+/// Columnar (struct-of-arrays, float32) cache of Geant4 anaTree events, written once per simulation set
+/// to a local binary file and read back without ROOT decompression. Columns are memory-mapped (or read
+/// on first access), so unused columns such as the ``extended'' branches are never loaded.
+class G4EventCache: private NoCopy {
+public:
+	/// constructor, opening cache file, memory-mapped or read on demand
+	G4EventCache(const std::string& fname, bool useMmap = true);
+	/// destructor
+	~G4EventCache();
+
+	/// write cache file from list of Geant4 anaTree files
+	static void build(const std::vector<std::string>& files, const std::string& fname);
+
+	/// total number of cached events
+	unsigned int nEvents() const { return nEvts; }
+	/// number of floats per event in column (0 if not stored)
+	unsigned int width(G4CacheColumn c) const { return cols[c].width; }
+	/// column data, [event][width], loaded on first access (thread-safe)
+	const float* column(G4CacheColumn c);
+	/// get first cached event and number of events for source file name (as passed to build); false if not cached
+	bool fileRange(const std::string& fname, unsigned int& e0, unsigned int& n) const;
+	/// anaTree branch name for column
+	static const char* colName(G4CacheColumn c);
+
+protected:
+	/// column location in file
+	struct colInfo {
+		uint32_t width;		///< floats per event
+		uint64_t offset;	///< byte offset of data in file
+	};
+
+	std::string fname;					///< cache file name
+	unsigned int nEvts;					///< total number of events
+	colInfo cols[G4C_NCOLUMNS];			///< column locations
+	std::vector<std::string> srcFiles;	///< source file names
+	std::vector<unsigned int> srcStart;	///< first event for each source file
+	std::vector<unsigned int> srcN;		///< number of events in each source file
+
+	FILE* fin;									///< file handle for on-demand reads
+	void* mapped;								///< memory-mapped file (NULL if not mapped)
+	size_t mapLen;								///< length of memory-mapped region
+	std::vector<float> loaded[G4C_NCOLUMNS];	///< on-demand loaded column data
+	bool isLoaded[G4C_NCOLUMNS];				///< whether column has been loaded
+	std::mutex loadLock;						///< lock for on-demand column loading
+};
+
+#endif
@@ -25,7 +25,7 @@ void G4toPMT::setReadpoints() {
 
 void G4toPMT::runCathodeSim(bool b) {
 	simCathodes = b;
-	if(!b) return;
+	if(!b || cache) return;
 	for(Side s = EAST; s <= WEST; ++s) {
 		for(AxisDirection d=X_DIRECTION; d<=Y_DIRECTION; ++d) {
 			std::string cbranchname =sideSubst("Cath_%c",s)+(d==X_DIRECTION?"X":"Y");
@@ -34,6 +34,103 @@ void G4toPMT::runCathodeSim(bool b) {
 	}
 }
 
+Sim2PMT* G4toPMT::makeCursor() const {
+	if(SP) return NULL;
+	G4toPMT* G = newSame();
+	G->setCache(cache);
+	for(std::vector<std::string>::const_iterator it = fileNames.begin(); it != fileNames.end(); it++)
+		G->addFile(*it);
+	G->copySimSettings(*this);
+	G->runCathodeSim(simCathodes);
+	return G;
+}
+
+int G4toPMT::addFile(const std::string& filename) {
+	if(!cache) return Sim2PMT::addFile(filename);
+	unsigned int e0,n;
+	if(!cache->fileRange(filename,e0,n)) {
+		SMExcept e("fileNotInCache");
+		e.insert("fileName",filename);
+		throw e;
+	}
+	if(!n) {
+		SMExcept e("noEventsInFile");
+		e.insert("fileName",filename);
+		throw e;
+	}
+	cacheStart.push_back(e0);
+	nnEvents.push_back(n);
+	fileNames.push_back(filename);
+	nEvents += n;
+	nFiles++;
+	return 1;
+}
+
+void G4toPMT::gotoEvent(unsigned int e) {
+	if(!cache) { Sim2PMT::gotoEvent(e); return; }
+	currentEvent = e;
+	speedload(e);
+}
+
+const float* G4toPMT::cacheColumn(G4CacheColumn c) {
+	if(!ccol[c]) {
+		ccol[c] = cache->column(c);
+		if(!ccol[c]) {
+			SMExcept e("missingCacheColumn");
+			e.insert("column",G4EventCache::colName(c));
+			throw e;
+		}
+	}
+	return ccol[c];
+}
+
+/// copy one row of float column into double array
+static inline void copyRow(const float* col, unsigned int w, size_t r, double* dest) {
+	col += r*w;
+	for(unsigned int j=0; j<w; j++) dest[j] = col[j];
+}
+
+void G4toPMT::speedload(unsigned int e) {
+	if(!cache) { Sim2PMT::speedload(e); return; }
+	smassert(e < nEvents);
+	if(e < noffset || e-noffset >= nLocalEvents) {
+		unsigned int i = 0;
+		noffset = 0;
+		while(e-noffset >= nnEvents[i]) noffset += nnEvents[i++];
+		nLocalEvents = nnEvents[i];
+		cacheRow0 = cacheStart[i];
+		evtRun = i;
+	}
+	const size_t r = cacheRow0+(e-noffset);
+	
+	copyRow(cacheColumn(G4C_EDEPQ),BOTH,r,eQ);
+	copyRow(cacheColumn(G4C_EDEP),BOTH,r,eDep);
+	copyRow(cacheColumn(G4C_MWPCE),BOTH,r,eW);
+	copyRow(cacheColumn(G4C_SCINTPOS),BOTH*(Z_DIRECTION+1),r,scintPos[0]);
+	copyRow(cacheColumn(G4C_MWPCPOS),BOTH*(Z_DIRECTION+1),r,mwpcPos[0]);
+	copyRow(cacheColumn(G4C_TIME),BOTH,r,time);
+	copyRow(cacheColumn(G4C_PRIMTHETA),1,r,&costheta);
+	copyRow(cacheColumn(G4C_PRIMKE),1,r,&ePrim);
+	copyRow(cacheColumn(G4C_PRIMPOS),Z_DIRECTION+2,r,primPos);
+	
+	if(simCathodes) {
+		for(Side s = EAST; s <= WEST; ++s) {
+			for(AxisDirection d=X_DIRECTION; d<=Y_DIRECTION; ++d) {
+				const float* col = cacheColumn(G4CacheColumn(G4C_CATH_EX+2*s+d)) + r*kMaxCathodes;
+				for(unsigned int j=0; j<kMaxCathodes; j++) cath_chg[s][d][j] = col[j];
+			}
+		}
+	}
+	
+	if(extended) {
+		copyRow(cacheColumn(G4C_EDEPSD),N_SD,r,eDepSD);
+		copyRow(cacheColumn(G4C_THETAINSD),N_SD,r,thetaInSD);
+		copyRow(cacheColumn(G4C_THETAOUTSD),N_SD,r,thetaOutSD);
+		copyRow(cacheColumn(G4C_KEINSD),N_SD,r,keInSD);
+		copyRow(cacheColumn(G4C_KEOUTSD),N_SD,r,keOutSD);
+	}
+}
+
 void G4toPMT::doUnits() {
 	
 	for(AxisDirection d=X_DIRECTION; d<=T_DIRECTION; ++d)
@@ -119,6 +216,7 @@ void G4SegmentMultiplier::startScan(bool startRandom) {
 bool G4SegmentMultiplier::nextPoint() {
 	if(!nrots) {
 		morePts = ProcessedDataScanner::nextPoint();
+		if(!morePts) nScanPasses++;
 		reverseCalibrate();
 		rcurrent = SC.getRing(SC.sector(primPos[X_DIRECTION],primPos[Y_DIRECTION]));
 		rcurrent = rcurrent<SC.n?rcurrent:SC.n-1;
@@ -148,6 +246,10 @@ void G4SegmentMultiplier::applyOffset(Sim2PMT& S) {
 	rotpt(S.primPos[X_DIRECTION],S.primPos[Y_DIRECTION]);
 }
 
+void G4SegmentMultiplier::selectRNGStream() {
+	simRNG.setStream(rngRun?rngRun:evtRun, rngEventIndex(), (rngSubstream<<16)+nrots);
+}
+
 void G4SegmentMultiplier::doUnits() {
 	if(!nrots) G4toPMT::doUnits();
 }
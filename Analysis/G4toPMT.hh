@@ -2,21 +2,34 @@
 #define G4TOPMT_HH
 
 #include "Sim2PMT.hh"
-#define N_SD 24
+#include "G4EventCache.hh"
 
 /// converts Geant 4 simulation results to PMT spectra
 class G4toPMT: public Sim2PMT {
 public:
 	/// constructor
-	G4toPMT(bool ext = false): Sim2PMT("anaTree"), extended(ext) { }
+	G4toPMT(bool ext = false): Sim2PMT("anaTree"), extended(ext), cache(NULL), cacheRow0(0) { for(unsigned int c=0; c<G4C_NCOLUMNS; c++) ccol[c] = NULL; }
 	/// unit conversions
 	virtual void doUnits();
 	/// set whether to simulate cathodes response
 	virtual void runCathodeSim(bool b = true);
+	/// create independent reader on same input files (not supported with a SimPositioner)
+	virtual Sim2PMT* makeCursor() const;
+	
+	/// read input events from columnar cache instead of ROOT files (set before adding files; cache not owned)
+	void setCache(G4EventCache* C) { smassert(!nFiles); cache = C; }
+	/// add file (located in cache, if set)
+	virtual int addFile(const std::string& filename);
+	/// jump scanner to specified event
+	virtual void gotoEvent(unsigned int e);
+	/// load identified "speed scan" point
+	virtual void speedload(unsigned int e);
 			
 protected:
 	/// set read points for input tree
 	virtual void setReadpoints();
+	/// new unfilled instance of same type, for makeCursor
+	virtual G4toPMT* newSame() const { return new G4toPMT(extended); }
 	
 	bool extended;			///< whether to read in additional variables
 	double eDepSD[N_SD];	///< energy deposition array
@@ -24,6 +37,14 @@ protected:
 	double thetaOutSD[N_SD];///< exit angle array
 	double keInSD[N_SD];	///< entrance energy array
 	double keOutSD[N_SD];	///< exit energy array
+	
+	/// fetch cache column, checking it is present
+	const float* cacheColumn(G4CacheColumn c);
+	
+	G4EventCache* cache;				///< columnar input cache (NULL to read ROOT files)
+	std::vector<unsigned int> cacheStart;	///< first cache row for each added file
+	unsigned int cacheRow0;				///< first cache row of currently loaded file
+	const float* ccol[G4C_NCOLUMNS];	///< cache column data pointers, fetched on first use
 };
 
 /// For consistency checks, swaps E/W sides on Geant4 sim data
@@ -33,6 +54,9 @@ public:
 	G4toPMT_SideSwap(): G4toPMT() { }
 	/// unit conversions
 	virtual void doUnits();
+protected:
+	/// new unfilled instance of same type, for makeCursor
+	virtual G4toPMT* newSame() const { return new G4toPMT_SideSwap(); }
 };
 
 /// multiply Geant4 data to fill all segments of SectionCutter
@@ -50,6 +74,8 @@ public:
 	virtual void calcReweight();
 	/// apply rotational offset
 	virtual void applyOffset(Sim2PMT& S);
+	/// select random stream for current event, distinct for each rotated copy
+	virtual void selectRNGStream();
 protected:
 	/// rotate a point
 	void rotpt(double& x0, double& y0);
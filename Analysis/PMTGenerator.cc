@@ -26,6 +26,45 @@ double TriggerProbMLP::unfold(double x) {
 	return atan(tan((x-0.5)*M_PI)/5.);
 }
 
+double TriggerProbMLP::fold(double u) {
+	return 0.5 + atan(5.*tan(u))/M_PI;
+}
+
+double TriggerProbMLP::unfoldFast(double x) {
+	static const unsigned int nTbl = 4096;
+	static const std::vector<double> tbl = [] {
+		std::vector<double> v(nTbl+1);
+		for(unsigned int i=0; i<=nTbl; i++) v[i] = unfold(double(i)/nTbl);
+		return v;
+	}();
+	double u = x*nTbl;
+	if(!(u > 0)) return tbl[0];
+	if(u >= nTbl) return tbl[nTbl];
+	unsigned int i = (unsigned int)u;
+	u -= i;
+	return tbl[i] + u*(tbl[i+1]-tbl[i]);
+}
+
+TriggerProbMLP::TriggerProbMLP(TMultiLayerPerceptron* M, unsigned int n): TriggerProb(), TMLP(M), nGrid(n) {
+	smassert(TMLP);
+	u0 = unfold(0);
+	du = nGrid > 1 ? (unfold(1)-u0)/(nGrid-1) : 0;
+	if(nGrid < 2) return;
+	unsigned int nPts = 1;
+	for(unsigned int t=0; t<nBetaTubes; t++) nPts *= nGrid;
+	lattice.resize(nPts);
+	Double_t aIn[(nBetaTubes*(nBetaTubes+1))/2];
+	for(unsigned int i=0; i<nPts; i++) {
+		unsigned int k = i;
+		for(unsigned int t=0; t<nBetaTubes; t++) {
+			aIn[t] = fold(u0+(k%nGrid)*du);
+			k /= nGrid;
+		}
+		condition(aIn);
+		lattice[i] = TMLP->Evaluate(0,aIn)+0.5;
+	}
+}
+
 void TriggerProbMLP::condition(Double_t* aIn) {
 	unsigned int nn=nBetaTubes;
 	for(unsigned int t1=1; t1<nBetaTubes; t1++)
@@ -34,12 +73,43 @@ void TriggerProbMLP::condition(Double_t* aIn) {
 	for(unsigned int t=4; t<nBetaTubes; t++) aIn[t] = unfold(aIn[t]);
 }
 
-double TriggerProbMLP::calcProb() {
+double TriggerProbMLP::calcProbExact() {
 	double p0 = TriggerProb::calcProb();
 	if(p0<0.005 || p0 > 0.99) return  p0;
 	condition(tubeProbs);
 	return TMLP->Evaluate(0,tubeProbs)+0.5;
 }
+
+double TriggerProbMLP::calcProb() {
+	if(lattice.empty()) return calcProbExact();
+	double p0 = TriggerProb::calcProb();
+	if(p0<0.005 || p0 > 0.99) return  p0;
+	// lattice cell and fractional position for each tube
+	unsigned int i0 = 0;
+	unsigned int stride[nBetaTubes];
+	double f[nBetaTubes];
+	for(unsigned int t=0, st=1; t<nBetaTubes; t++, st *= nGrid) {
+		double u = (unfoldFast(tubeProbs[t])-u0)/du;
+		if(!(u > 0)) u = 0;
+		unsigned int i = (unsigned int)u;
+		if(i > nGrid-2) i = nGrid-2;
+		f[t] = u-i;
+		i0 += i*st;
+		stride[t] = st;
+	}
+	// multilinear interpolation over cell corners
+	double p = 0;
+	for(unsigned int c=0; c < (1u<<nBetaTubes); c++) {
+		double w = 1;
+		unsigned int i = i0;
+		for(unsigned int t=0; t<nBetaTubes; t++) {
+			if(c & (1u<<t)) { w *= f[t]; i += stride[t]; }
+			else w *= 1-f[t];
+		}
+		p += w*lattice[i];
+	}
+	return p;
+}
 	
 	
 	
@@ -47,7 +117,7 @@ double TriggerProbMLP::calcProb() {
 
 PMTGenerator::PMTGenerator(Side s, float xx, float yy):
 x(xx), y(yy), xw(xx), yw(yy), evtm(0), presmear(0), dgain(10.0), pedcorr(0.1), crosstalk(0.010), xscatter(0.), trigThreshScale(1.0),
-currentCal(NULL), TProb(new TriggerProb()), mySide(s) {
+fastTrig(false), validateTrig(false), maxTrigDev(0), nTrigValidated(0), currentCal(NULL), TProb(new TriggerProb()), rnd(&sim_rnd_source), mySide(s) {
 	for(Side s = EAST; s <= WEST; ++s)
 		for(unsigned int t=0; t<nBetaTubes; t++)
 			lightBal[s][t] = 1.;
@@ -59,6 +129,11 @@ void PMTGenerator::setCalibrator(PMTCalibrator* P) {
 	setPosition(x,y,xw-x,yw-y);
 }
 
+void PMTGenerator::setRNG(TRandom* R) {
+	smassert(R);
+	rnd = R;
+}
+
 void PMTGenerator::setTriggerProb(TriggerProb* TP) {
 	smassert(TP);
 	TProb = TP;
@@ -123,10 +198,10 @@ void makeCorrelated(float* v, unsigned int n, float c, float* sigma = NULL) {
 }
 
 // makes correlation "waves" where some events are 4-way correlated, others uncorrelated
-void makeCorrelated4(float* v, unsigned int n, float c, float* sigma = NULL) {
+void makeCorrelated4(TRandom& rnd, float* v, unsigned int n, float c, float* sigma = NULL) {
 	std::vector<float> v2(n);
-	if(PMTGenerator::sim_rnd_source.Uniform(0,1)<c) {
-		float r = PMTGenerator::sim_rnd_source.Gaus(0.,1.);
+	if(rnd.Uniform(0,1)<c) {
+		float r = rnd.Gaus(0.,1.);
 		for(unsigned int i=0; i<n; i++) v2[i] = r;
 	} else {
 		for(unsigned int i=0; i<n; i++) v2[i] = v[i];
@@ -162,8 +237,8 @@ ScintEvent PMTGenerator::generate(float en) {
 	}
 	preuncorrelate(nPE, crosstalk);
 	for(unsigned int t=0; t<nBetaTubes; t++) {
-		nPE[t] = sim_rnd_source.PoissonD(nPE[t]>0?nPE[t]:0);				///< primary photoelectrons
-		nPE[t] = sim_rnd_source.PoissonD(dgain*(nPE[t]>0?nPE[t]:0))/dgain;	///< first gain stage electron multiplication
+		nPE[t] = rnd->PoissonD(nPE[t]>0?nPE[t]:0);				///< primary photoelectrons
+		nPE[t] = rnd->PoissonD(dgain*(nPE[t]>0?nPE[t]:0))/dgain;	///< first gain stage electron multiplication
 	}
 	recorrelate(nPE, crosstalk);
 	for(unsigned int t=0; t<nBetaTubes; t++)
@@ -174,21 +249,24 @@ ScintEvent PMTGenerator::generate(float en) {
 	float pedw[nBetaTubes]; // pedestal widths
 	float dped[nBetaTubes]; // noise term on each pedestal
 	for(unsigned int t=0; t<nBetaTubes; t++) {
-		pedw[t] = currentCal->getPedwidth(currentCal->sensorNames[mySide][t], evtm);
-		dped[t] = sim_rnd_source.Gaus(0.,1.);
+		pedw[t] = currentCal->pmtPedwidth(mySide, t, evtm);
+		dped[t] = rnd->Gaus(0.,1.);
 	}
 	makeCorrelated(dped,nBetaTubes,pedcorr,pedw);
 	
+	// adc values
+	float tubeE[nBetaTubes];
+	for(unsigned int t=0; t<nBetaTubes; t++)
+		tubeE[t] = sevt.tuben[t].x;
+	currentCal->invertCorrections(mySide, tubeE, x, y, evtm, sevt.adc);
 	for(unsigned int t=0; t<nBetaTubes; t++) {
-		// adc value
-		sevt.adc[t] = currentCal->invertCorrections(mySide, t, sevt.tuben[t].x, x, y, evtm);
 		// correlated pedestal noise
 		sevt.adc[t] += dped[t];
 		// quantization noise
-		float pedx = currentCal->getPedestal(currentCal->sensorNames[mySide][t], evtm);
+		float pedx = currentCal->pmtPedestal(mySide, t, evtm);
 		sevt.adc[t] = int(sevt.adc[t]+pedx+0.5)-pedx;
 	}
-	currentCal->calibrateEnergy(mySide, xw, yw, sevt, evtm, xscatter);
+	currentCal->calibrateEnergy(mySide, xw, yw, sevt, evtm, xscatter, rnd);
 	return sevt;
 }
 
@@ -196,8 +274,9 @@ unsigned int PMTGenerator::triggers() {
 	nTrigs = 0;
 	unsigned int nZero = 0;
 	for(unsigned int t=0; t<nBetaTubes; t++) {
-		TProb->tubeProbs[t] = currentCal->trigEff(mySide,t,sevt.adc[t]*trigThreshScale);
-		pmtTriggered[t] = sim_rnd_source.Uniform(0.0,1.0) < TProb->tubeProbs[t];
+		float adc = sevt.adc[t]*trigThreshScale;
+		TProb->tubeProbs[t] = fastTrig ? currentCal->trigEffFast(mySide,t,adc) : currentCal->trigEff(mySide,t,adc);
+		pmtTriggered[t] = rnd->Uniform(0.0,1.0) < TProb->tubeProbs[t];
 		if(sevt.adc[t] == 0) nZero++;
 		if(pmtTriggered[t]) nTrigs++;
 	}
@@ -212,7 +291,30 @@ unsigned int PMTGenerator::triggers() {
 
 bool PMTGenerator::triggered() {
 	triggers();
-	return sim_rnd_source.Uniform(0.0,1.0) < TProb->calcProb();
+	double p = TProb->calcProb();
+	if(validateTrig) {
+		// compare against exact calculation, leaving trigger model inputs as used
+		const unsigned int nIn = sizeof(TProb->tubeProbs)/sizeof(TProb->tubeProbs[0]);
+		Double_t tp0[nIn];
+		std::copy(TProb->tubeProbs, TProb->tubeProbs+nIn, tp0);
+		for(unsigned int t=0; t<nBetaTubes; t++)
+			TProb->tubeProbs[t] = currentCal->trigEff(mySide,t,sevt.adc[t]*trigThreshScale);
+		double dp = fabs(TProb->calcProbExact()-p);
+		std::copy(tp0, tp0+nIn, TProb->tubeProbs);
+		if(!(dp <= maxTrigDev)) maxTrigDev = dp;
+		nTrigValidated++;
+	}
+	return rnd->Uniform(0.0,1.0) < p;
+}
+
+void PMTGenerator::reportTrigValidation() const {
+	printf("%s trigger model (%s efficiencies): max deviation from exact %.3g over %u events\n",
+		   sideWords(mySide), fastTrig?"tabulated":"exact", maxTrigDev, nTrigValidated);
+}
+
+void PMTGenerator::addTrigValidation(const PMTGenerator& G) {
+	if(G.maxTrigDev > maxTrigDev) maxTrigDev = G.maxTrigDev;
+	nTrigValidated += G.nTrigValidated;
 }
 
 //-------------------------------------------------------------
@@ -228,7 +330,7 @@ void PMTGenerator::calcCathodeSignals(Side s, AxisDirection d, const float* cath
 		double w1 = 1.0;
 		double n2 = 16;
 		double w2 = 0.3;
-		double pedw = currentCal->cathPedW0[s][d][c] * (w1*sim_rnd_source.PoissonD(n1)/n1 + w2*sim_rnd_source.PoissonD(n2)/n2-w1-w2)/sqrt(w1*w1+w2*w2);
+		double pedw = currentCal->cathPedW0[s][d][c] * (w1*rnd->PoissonD(n1)/n1 + w2*rnd->PoissonD(n2)/n2-w1-w2)/sqrt(w1*w1+w2*w2);
 		cath_adc[c] += ped + pedw;
 		// clamp to ADC range and quantize
 		cath_adc[c] = int(cath_adc[c]<0 ? 0 : (cath_adc[c]>4095 ? 4095:cath_adc[c]));
@@ -239,7 +341,7 @@ void PMTGenerator::calcCathodeSignals(Side s, AxisDirection d, const float* cath
 	// calculate wireplane info from simulated cathodes, but keep original center location
 	double old_center = w.center;
 	double old_rawcenter = w.rawCenter;
-	w = currentCal->calcHitPos(s,d,cath_adc,&currentCal->cathPeds0[s][d][0]);
+	w = currentCal->calcHitPos(s,d,cath_adc,&currentCal->cathPeds0[s][d][0],rnd);
 	w.center = old_center;
 	w.rawCenter = old_rawcenter;
 }
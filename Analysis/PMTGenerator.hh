@@ -19,18 +19,23 @@ public:
 	virtual ~TriggerProb() {};
 	/// calculate 2-fold trigger probability
 	virtual double calcProb();
+	/// calculate 2-fold trigger probability by exact (un-tabulated) method
+	virtual double calcProbExact() { return TriggerProb::calcProb(); }
 	
 	Double_t tubeProbs[(nBetaTubes*(nBetaTubes+1))/2];	///< input location for individual PMT probabilities
 	ScintEvent sevt;									///< scintillator event to calculate trigger probability from
 };
 
-/// Trigger probability using TMultiLayerPerceptron
+/// Trigger probability using TMultiLayerPerceptron, optionally tabulated on a lattice of tube probabilities
+/// (uniform in unfold(p) for each tube) for multilinear interpolation in place of per-event network evaluation
 class TriggerProbMLP: public TriggerProb {
 public:
-	/// constructor
-	TriggerProbMLP(TMultiLayerPerceptron* M): TriggerProb(), TMLP(M) { smassert(TMLP); }
+	/// constructor; tabulates network on nGrid^4 lattice (0 to always evaluate network directly)
+	TriggerProbMLP(TMultiLayerPerceptron* M, unsigned int nGrid = 0);
 	/// calculate 2-fold trigger probability
 	virtual double calcProb();
+	/// calculate 2-fold trigger probability by direct network evaluation
+	virtual double calcProbExact();
 	
 	/// pre-modify input array
 	static void condition(Double_t* aIn);
@@ -38,6 +43,15 @@ public:
 protected:
 	TMultiLayerPerceptron* TMLP;
 	static double unfold(double x);
+	/// inverse of unfold
+	static double fold(double u);
+	/// unfold by table lookup
+	static double unfoldFast(double x);
+	
+	unsigned int nGrid;			///< lattice points per tube
+	double u0;					///< lattice lower edge, in unfolded coordinates
+	double du;					///< lattice spacing, in unfolded coordinates
+	std::vector<double> lattice;///< tabulated network output [p3][p2][p1][p0]
 };
 
 /// Class for simulating detector response
@@ -52,6 +66,12 @@ public:
 	void setCalibrator(PMTCalibrator* P);
 	/// set trigger probability estimator
 	void setTriggerProb(TriggerProb* TP);
+	/// get trigger probability estimator
+	TriggerProb* getTriggerProb() const { return TProb; }
+	/// set random number source (default: shared sim_rnd_source)
+	void setRNG(TRandom* R);
+	/// get random number source
+	TRandom* getRNG() const { return rnd; }
 	
 	/// generate a scintillator event for a given quenched energy
 	ScintEvent generate(float en);
@@ -60,6 +80,12 @@ public:
 	unsigned int triggers();
 	/// whether the 2-of-4 trigger fired
 	bool triggered();
+	/// print trigger model validation summary
+	void reportTrigValidation() const;
+	/// add trigger model validation results from another generator (e.g. a worker thread copy)
+	void addTrigValidation(const PMTGenerator& G);
+	/// clear trigger model validation results
+	void resetTrigValidation() { maxTrigDev = 0; nTrigValidated = 0; }
 	
 	/// set generator position (sets scint and wirechamber position)
 	void setPosition(float xx, float yy, float dxw=0, float dyw=0);
@@ -80,11 +106,15 @@ public:
 	float crosstalk;				///< inter-channel noise crosstalk
 	float xscatter;					///< "extra" proportional random scatter
 	float trigThreshScale;			///< ADC scaling factor for trigger efficiency (to test efficiency changes)
+	bool fastTrig;					///< whether to use tabulated tube efficiencies for trigger probability (default exact)
+	bool validateTrig;				///< whether to compare fast trigger model against exact calculation for each event
+	double maxTrigDev;				///< maximum trigger probability deviation of fast model from exact, in validation mode
+	unsigned int nTrigValidated;	///< number of events compared in validation mode
 	
 	unsigned int nTrigs;			///< number of individual PMTs triggered
 	bool pmtTriggered[nBetaTubes];	///< whether each PMT triggered above threshold
 	
-	static TRandom3 sim_rnd_source;	///< PMTGenerator random number generator
+	static TRandom3 sim_rnd_source;	///< default shared PMTGenerator random number generator
 	
 	
 	/// convert simulated cathode charge distribution to ADC, updating wireHit results
@@ -94,6 +124,7 @@ protected:
 
 	PMTCalibrator* currentCal;			///< current PMT Calibrator in use
 	TriggerProb* TProb;
+	TRandom* rnd;						///< random number source
 	Side mySide;						///< side to simulate
 	float pmtRes[BOTH][nBetaTubes];		///< individual PMT nPE per keV
 	float lightBal[BOTH][nBetaTubes];	///< custom light balancing factor between PMTs for LED events
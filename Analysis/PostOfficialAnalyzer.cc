@@ -11,43 +11,50 @@ std::string PostOfficialAnalyzer::locateRun(RunNum r) {
 	return "";
 }
 
+ProcessedDataScanner* PostOfficialAnalyzer::makeScanner() const {
+	PostOfficialAnalyzer* P = new PostOfficialAnalyzer(withCals);
+	P->anChoice = anChoice;
+	P->fiducialRadius = fiducialRadius;
+	return P;
+}
+
 void PostOfficialAnalyzer::setReadpoints() {
 	
 	// reconstructed energy
-	SetBranchAddress("Erecon",&Erecon);
+	SetCachedBranch("Erecon",&Erecon,sizeof(Erecon));
 	// event ID
-	SetBranchAddress("PID",&fPID);
-	SetBranchAddress("Side",&fSide);
-	SetBranchAddress("Type",&fType);
+	SetCachedBranch("PID",&fPID,sizeof(fPID));
+	SetCachedBranch("Side",&fSide,sizeof(fSide));
+	SetCachedBranch("Type",&fType,sizeof(fType));
 	if(Tch->GetBranch("ProbIII"))
-		SetBranchAddress("ProbIII",&fProbIII);
+		SetCachedBranch("ProbIII",&fProbIII,sizeof(fProbIII));
 	else
 		fProbIII = 0;
 	// clock
-	SetBranchAddress("TimeE",&runClock[EAST]);
-	SetBranchAddress("TimeW",&runClock[WEST]);
+	SetCachedBranch("TimeE",&runClock[EAST],sizeof(runClock[EAST]));
+	SetCachedBranch("TimeW",&runClock[WEST],sizeof(runClock[WEST]));
 	runClock[BOTH]=runClock[NOSIDE]=0.0;
 	
-	SetBranchAddress("EvnbGood",&fEvnbGood);
-	SetBranchAddress("BkhfGood",&fBkhfGood);
+	SetCachedBranch("EvnbGood",&fEvnbGood,sizeof(fEvnbGood));
+	SetCachedBranch("BkhfGood",&fBkhfGood,sizeof(fBkhfGood));
 
 	for(Side s=EAST; s<=WEST; ++s) {
 		
 		// wirechamber planes
 		for(int p=X_DIRECTION; p<=Y_DIRECTION; p++) {
-			SetBranchAddress(((p==X_DIRECTION?"x":"y")+sideSubst("%cmpm",s)).c_str(),&wires[s][p]);
-			SetBranchAddress((sideSubst("Cathodes_%c",s)+(p==X_DIRECTION?"x":"y")).c_str(),cathodes[s][p]);
+			SetCachedBranch(((p==X_DIRECTION?"x":"y")+sideSubst("%cmpm",s)).c_str(),&wires[s][p],sizeof(wires[s][p]));
+			SetCachedBranch((sideSubst("Cathodes_%c",s)+(p==X_DIRECTION?"x":"y")).c_str(),cathodes[s][p],sizeof(cathodes[s][p]));
 		}
 		
 		// beta scintillators
-		SetBranchAddress(sideSubst("Scint%c",s).c_str(),&scints[s]);
+		SetCachedBranch(sideSubst("Scint%c",s).c_str(),&scints[s],sizeof(scints[s]));
 		
 		// MWPC totals
-		SetBranchAddress(sideSubst("Anode%c",s).c_str(),&mwpcs[s].anode);
-		SetBranchAddress(sideSubst("CathSum%c",s).c_str(),&mwpcs[s].cathodeSum);
-		SetBranchAddress(sideSubst("EMWPC_%c",s).c_str(),&mwpcEnergy[s]);
+		SetCachedBranch(sideSubst("Anode%c",s).c_str(),&mwpcs[s].anode,sizeof(mwpcs[s].anode));
+		SetCachedBranch(sideSubst("CathSum%c",s).c_str(),&mwpcs[s].cathodeSum,sizeof(mwpcs[s].cathodeSum));
+		SetCachedBranch(sideSubst("EMWPC_%c",s).c_str(),&mwpcEnergy[s],sizeof(mwpcEnergy[s]));
 		
 		/// muon tags
-		SetBranchAddress(sideSubst("TaggedBack%c",s).c_str(),&fTaggedBack[s]);
+		SetCachedBranch(sideSubst("TaggedBack%c",s).c_str(),&fTaggedBack[s],sizeof(fTaggedBack[s]));
 	}
 }
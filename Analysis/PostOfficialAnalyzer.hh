@@ -11,6 +11,8 @@ public:
 	
 	/// find path to processed run .root file
 	virtual std::string locateRun(RunNum r);	
+	/// new (empty) scanner with same settings
+	virtual ProcessedDataScanner* makeScanner() const;
 	
 	float Erecon;	///< reconstructed "true" energy
 	
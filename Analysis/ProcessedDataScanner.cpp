@@ -6,14 +6,90 @@
 #include <stdlib.h>
 
 bool ProcessedDataScanner::redoPositions = false;
+std::string ProcessedDataScanner::physCacheDir = "";
 
 ProcessedDataScanner::ProcessedDataScanner(const std::string& treeName, bool withCalibrators):
-RunSetScanner(treeName,withCalibrators), runClock(0), physicsWeight(1.0), anChoice(ANCHOICE_A), fiducialRadius(45.0) {
+RunSetScanner(treeName,withCalibrators), runClock(0), physicsWeight(1.0), anChoice(ANCHOICE_A), fiducialRadius(45.0), activeCache(NULL) {
 	for(Side s = EAST; s<=WEST; ++s)
 		for(AxisDirection d = X_DIRECTION; d <= Y_DIRECTION; ++d)
 				wires[s][d].center = 0;
 }
 
+ProcessedDataScanner::~ProcessedDataScanner() {
+	for(std::vector<BranchCache*>::iterator it = runCaches.begin(); it != runCaches.end(); it++)
+		delete *it;
+}
+
+void ProcessedDataScanner::SetCachedBranch(const std::string& bname, void* bdata, unsigned int size) {
+	SetBranchAddress(bname,bdata);
+	BranchCache::column c;
+	c.name = bname;
+	c.dest = bdata;
+	c.width = size;
+	cacheCols.push_back(c);
+}
+
+bool ProcessedDataScanner::addRun(RunNum rn) {
+	unsigned int n0 = getnFiles();
+	if(!RunSetScanner::addRun(rn)) return false;
+	if(getnFiles() == n0) return true;
+	runCaches.resize(getnFiles()-1,NULL);
+	BranchCache* BC = NULL;
+	if(physCacheDir.size() && cacheCols.size()) {
+		std::string cname = physCacheDir+"/"+Tch->GetName()+"_"+itos(rn)+".colcache";
+		double cAge = fileAge(cname);
+		if(cAge >= 0 && cAge <= fileAge(fileNames.back())) {
+			BC = new BranchCache(cname,cacheCols);
+			if(!BC->isValid() || BC->nEvents() != nnEvents.back()) { delete BC; BC = NULL; }
+		}
+		if(!BC) {
+			makePath(cname,true);
+			BranchCache::build(fileNames.back(),Tch->GetName(),cacheCols,cname);
+			BC = new BranchCache(cname,cacheCols);
+			if(!BC->isValid() || BC->nEvents() != nnEvents.back()) {
+				SMExcept e("badColumnCache");
+				e.insert("fileName",cname);
+				e.insert("nEvents",nnEvents.back());
+				delete BC;
+				throw(e);
+			}
+		}
+	}
+	runCaches.push_back(BC);
+	return true;
+}
+
+void ProcessedDataScanner::gotoEvent(unsigned int e) {
+	activeCache = NULL;
+	bool allCached = runCaches.size();
+	for(unsigned int i=0; i<runCaches.size(); i++) allCached &= (runCaches[i] != NULL);
+	if(!allCached) {
+		RunSetScanner::gotoEvent(e);
+		return;
+	}
+	// no need to touch TChain; next speedload fills read points from cache
+	currentEvent = e;
+	nLocalEvents = noffset = 0;
+}
+
+void ProcessedDataScanner::speedload(unsigned int e) {
+	if(e < noffset || e-noffset >= nLocalEvents) {
+		unsigned int n = 0;
+		unsigned int e0 = 0;
+		while(n+1 < nnEvents.size() && e >= e0+nnEvents[n]) e0 += nnEvents[n++];
+		activeCache = n < runCaches.size() ? runCaches[n] : NULL;
+		if(activeCache) {
+			noffset = e0;
+			nLocalEvents = nnEvents[n];
+			enterRun(n);
+		} else {
+			nLocalEvents = noffset = 0;
+		}
+	}
+	if(activeCache) activeCache->load(e-noffset);
+	else RunSetScanner::speedload(e);
+}
+
 Stringmap ProcessedDataScanner::evtInfo() {
 	Stringmap m;
 	m.insert("EvtN",currentEvent);
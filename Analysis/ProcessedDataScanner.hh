@@ -12,6 +12,7 @@
 //#include "PMTGenerator.hh"
 #include "CalDBSQL.hh"
 #include "TagCounter.hh"
+#include "BranchCache.hh"
 
 #include <map>
 #include "SMExcept.hh"
@@ -21,6 +22,15 @@ class ProcessedDataScanner: public RunSetScanner, public EventClassifier {
 public:
 	/// constructor
 	ProcessedDataScanner(const std::string& treeName, bool withCalibrators = false);
+	/// destructor
+	virtual ~ProcessedDataScanner();
+	
+	/// add run to data, opening (or building) its column cache if enabled
+	virtual bool addRun(RunNum rn);
+	/// jump scanner to specified event
+	virtual void gotoEvent(unsigned int e);
+	/// load identified "speed scan" point, from column cache where available
+	virtual void speedload(unsigned int e);
 	
 	/// radius squared of event
 	virtual float radius2(Side s) const;
@@ -44,6 +54,8 @@ public:
 	virtual float probTrig(Side s, unsigned int t);
 	/// get info about current event
 	virtual Stringmap evtInfo();
+	/// new (empty) scanner of same type and settings, e.g. for scanning on another thread; NULL if unsupported
+	virtual ProcessedDataScanner* makeScanner() const { return NULL; }
 	
 	/// Type I initial hit side determination --- not available here
 	virtual Side getFirstScint() const { smassert(false); return BOTH; }
@@ -51,6 +63,7 @@ public:
 	virtual float getProbIII() const { return WirechamberCalibrator::sep23Prob(fSide,getEnergy(),mwpcEnergy[fSide]); }
 	
 	static bool redoPositions;		///< whether to re-calibrate positions
+	static std::string physCacheDir;	///< directory for per-run column caches of read points ("" to disable)
 
 	ScintEvent scints[BOTH];	///< readout point for scintillator data
 	Float_t led_pd[BOTH];		///< readout point for reference photodiode
@@ -64,6 +77,14 @@ public:
 	
 	AnalysisChoice anChoice;	///< which analysis choice to use in identifying event types
 	float fiducialRadius;		///< radius for position cut
+	
+protected:
+	/// SetBranchAddress for fixed-size read point, also registering it for the column cache
+	void SetCachedBranch(const std::string& bname, void* bdata, unsigned int size);
+	
+	std::vector<BranchCache::column> cacheCols;	///< read points registered for column cache
+	std::vector<BranchCache*> runCaches;		///< column cache for each loaded file (NULL if uncached)
+	BranchCache* activeCache;					///< column cache for currently loaded file
 };
 
 #endif
@@ -75,6 +75,11 @@ nBins(300), eMin(-100), eMax(2000), pkMin(0.0), pkMax(FLT_MAX), nSigma(2.0)  {
 	
 }
 
+std::string SourceHitsPlugin::getConfig() const {
+	// source selection region and side
+	return "source="+mySource.name()+","+itos(mySource.mySide)+","+dtos(mySource.x)+","+dtos(mySource.y)+","+dtos(mySource.wx)+","+dtos(mySource.wy);
+}
+
 void SourceHitsPlugin::fillCoreHists(ProcessedDataScanner& PDS, double weight) {
 	EventType tp = PDS.fType;
 	Side s = PDS.fSide;
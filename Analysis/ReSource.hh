@@ -36,6 +36,8 @@ public:
 	virtual void makePlots();
 	/// MC/data comparison
 	virtual void compareMCtoData(AnalyzerPlugin* AP);
+	/// settings affecting filled histograms
+	virtual std::string getConfig() const;
 	
 	// raw event counts histograms
 	fgbgPair* hTubes[nBetaTubes+1][TYPE_III_EVENT+1];	///< calibrated PMT energy spectra by event type
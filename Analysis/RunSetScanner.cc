@@ -4,6 +4,7 @@
 #include "SMExcept.hh"
 #include <stdio.h>
 #include <stdlib.h>
+#include <algorithm>
 
 RunSetScanner::RunSetScanner(const std::string& treeName, bool withCalibrators):
 TChainScanner(treeName), ActiveCal(NULL), totalTime(0), withCals(withCalibrators) {
@@ -16,6 +17,8 @@ RunSetScanner::~RunSetScanner() {
 }
 
 unsigned int RunSetScanner::addRuns(const std::vector<RunNum>& rns) {
+	if(withCals && rns.size() > 1)
+		CalDBSQL::getCDB()->prefetchRuns(*std::min_element(rns.begin(),rns.end()),*std::max_element(rns.begin(),rns.end()));
 	printf("\n------------------- Assembling %i runs into TChain... ",(int)rns.size()); fflush(stdout);
 	unsigned int n = 0;
 	for(std::vector<RunNum>::const_iterator it = rns.begin(); it != rns.end(); it++) {
@@ -23,6 +26,8 @@ unsigned int RunSetScanner::addRuns(const std::vector<RunNum>& rns) {
 		printf("*"); fflush(stdout);
 	}
 	printf("------------------- %i Runs, %i events found, %.2fh running.\n",getnFiles(),nEvents,totalTime[BOTH]/3600.0);
+	if(withCals)
+		printf("Calibrations DB cache: %i hits, %i misses.\n",CalDBSQL::getCDB()->cacheHits,CalDBSQL::getCDB()->cacheMisses);
 	return n;
 }
 
@@ -48,24 +53,28 @@ void RunSetScanner::speedload(unsigned int e) {
 		Tch->GetTree()->LoadBaskets();
 		nLocalEvents = Tch->GetTree()->GetEntries();
 		noffset = Tch->GetChainOffset();
-		if((int)runlist.size()>Tch->GetTreeNumber())
-			evtRun = runlist[Tch->GetTreeNumber()];
-		else
-			evtRun = Tch->GetTreeNumber();
-		if(withCals) {
-			std::map<RunNum,PMTCalibrator*>::iterator it = PCals.find(evtRun);
-			if(it == PCals.end()) {
-				SMExcept e("missingCalibration");
-				e.insert("runNum",evtRun);
-				throw(e);
-			}			
-			ActiveCal = it->second;
-		}
-		loadNewRun(evtRun);
+		enterRun(Tch->GetTreeNumber());
 	}
 	Tch->GetTree()->GetEvent(e-noffset);
 }
 
+void RunSetScanner::enterRun(unsigned int n) {
+	if(runlist.size()>n)
+		evtRun = runlist[n];
+	else
+		evtRun = n;
+	if(withCals) {
+		std::map<RunNum,PMTCalibrator*>::iterator it = PCals.find(evtRun);
+		if(it == PCals.end()) {
+			SMExcept e("missingCalibration");
+			e.insert("runNum",evtRun);
+			throw(e);
+		}			
+		ActiveCal = it->second;
+	}
+	loadNewRun(evtRun);
+}
+
 bool RunSetScanner::addRun(RunNum r) {
 	std::string f = locateRun(r);
 	if(f.size() && addFile(f)) {
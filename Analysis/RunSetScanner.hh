@@ -34,6 +34,8 @@ public:
 	virtual void loadNewRun(RunNum) {}
 	/// get run number of current event
 	virtual RunNum getRun() const { return evtRun; }
+	/// get list of loaded runs, in file order
+	const std::vector<RunNum>& getRunList() const { return runlist; }
 	/// check whether this is simulated data
 	virtual bool isSimulated() const { return false; }
 	
@@ -51,6 +53,8 @@ public:
 	bool withCals;					///< whether to use energy recalibrators
 	
 protected:
+	/// set current run info and calibrator for n^th loaded file
+	void enterRun(unsigned int n);
 	
 	std::vector<RunNum> runlist;			///< list of loaded runs
 	std::map<RunNum,PMTCalibrator*> PCals;	///< calibrators for each run
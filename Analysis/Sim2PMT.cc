@@ -5,13 +5,11 @@
 #include <cmath>
 #include <climits>
 
-TRandom3 mc_rnd_source;	
-
 
 //--------------------------------------------------------------
 
 void SimPositioner::applyOffset(Sim2PMT& S) {
-	calcOffset(S);
+	calcOffset(S,S.simRNG);
 	for(AxisDirection d = X_DIRECTION; d <= Y_DIRECTION; ++d) {
 		for(Side s = EAST; s <= WEST; ++s) {
 			S.scintPos[s][d] += offPos[d];
@@ -21,10 +19,10 @@ void SimPositioner::applyOffset(Sim2PMT& S) {
 	}
 }
 
-void SourcedropPositioner::calcOffset(const Sim2PMT& S) {
+void SourcedropPositioner::calcOffset(const Sim2PMT& S, TRandom& rnd) {
 	while(true) {
-		offPos[X_DIRECTION] = mc_rnd_source.Uniform(-1.,1.);
-		offPos[Y_DIRECTION] = mc_rnd_source.Uniform(-1.,1.);
+		offPos[X_DIRECTION] = rnd.Uniform(-1.,1.);
+		offPos[Y_DIRECTION] = rnd.Uniform(-1.,1.);
 		if(offPos[X_DIRECTION]*offPos[X_DIRECTION]+offPos[Y_DIRECTION]*offPos[Y_DIRECTION]<=1.) break;
 	}
 	offPos[X_DIRECTION] *= r0;
@@ -37,10 +35,11 @@ void SourcedropPositioner::calcOffset(const Sim2PMT& S) {
 
 
 Sim2PMT::Sim2PMT(const std::string& treeName): ProcessedDataScanner(treeName,false),
-SP(NULL), reSimulate(true), fakeClip(false), weightAsym(true), basePhysWeight(1.0), simSide(BOTH),
+SP(NULL), rngRun(0), rngSubstream(0), nScanPasses(0), reSimulate(true), fakeClip(false), weightAsym(true), basePhysWeight(1.0), simSide(BOTH),
 nSimmed(0), nToSim(INT_MAX), nCounted(0), afp(AFP_OTHER), simCathodes(false) {
 	for(Side s = EAST; s <= WEST; ++s) {
 		PGen[s].setSide(s);
+		PGen[s].setRNG(&simRNG);
 		for(AxisDirection d = X_DIRECTION; d <= Y_DIRECTION; ++d)
 			for(unsigned int c = 0; c < kMaxCathodes; c++)
 				cath_chg[s][d][c] = cathodes[s][d][c] = 0;
@@ -62,7 +61,7 @@ void Sim2PMT::calcReweight() {
 	if(fType==TYPE_NONEVENT) { physicsWeight = 0; return; }
 	physicsWeight = basePhysWeight;
 	if(weightAsym && (afp==AFP_ON || afp==AFP_OFF))
-		physicsWeight *= (1.0+correctedAsymmetry(ePrim,costheta*(afp==AFP_ON?1:-1)))*neutronSpectrumCorrectionFactor(ePrim);
+		physicsWeight *= (1.0+correctedAsymmetryTab(ePrim,costheta*(afp==AFP_ON?1:-1)))*neutronSpectrumCorrectionFactorTab(ePrim);
 	if(fakeClip) {
 		const double R = 70.*sqrt(0.6); // wirechamber entrance window radius, projected back to decay trap
 		// event origin distance from edge
@@ -91,6 +90,7 @@ void Sim2PMT::startScan(bool startRandom) {
 
 bool Sim2PMT::nextPoint() {
 	bool np = ProcessedDataScanner::nextPoint();
+	if(!np) nScanPasses++;
 	reverseCalibrate();
 	calcReweight();
 	nSimmed++;
@@ -98,12 +98,60 @@ bool Sim2PMT::nextPoint() {
 	return np && currentEvent < nToSim;
 }
 
-void Sim2PMT::updateClock() { runClock = mc_rnd_source.Uniform(0.,ActiveCal->totalTime); }
+void Sim2PMT::copySimSettings(const Sim2PMT& S) {
+	for(Side s = EAST; s <= WEST; ++s) {
+		// keep own trigger model (holds per-event state) and random source
+		TriggerProb* TP = PGen[s].getTriggerProb();
+		PGen[s] = S.PGen[s];
+		PGen[s].setTriggerProb(TP);
+		PGen[s].setRNG(&simRNG);
+		PGen[s].resetTrigValidation();
+	}
+	reSimulate = S.reSimulate;
+	fakeClip = S.fakeClip;
+	weightAsym = S.weightAsym;
+	basePhysWeight = S.basePhysWeight;
+	simSide = S.simSide;
+	anChoice = S.anChoice;
+	fiducialRadius = S.fiducialRadius;
+	afp = S.afp;
+	simCathodes = S.simCathodes;
+	simRNG.setBaseSeed(S.simRNG.getBaseSeed());
+	rngRun = S.rngRun;
+	rngSubstream = S.rngSubstream;
+}
+
+void Sim2PMT::seekStream(ULong64_t a) {
+	smassert(nEvents);
+	nScanPasses = a/nEvents;
+	unsigned int e = a%nEvents;
+	gotoEvent(e);
+	currentEvent = e-1;
+}
+
+void Sim2PMT::loadStreamEvent(ULong64_t a, unsigned int sub) {
+	smassert(nEvents);
+	nScanPasses = a/nEvents;
+	rngSubstream = sub;
+	currentEvent = a%nEvents;
+	speedload(currentEvent);
+	reverseCalibrate();
+	calcReweight();
+	nSimmed++;
+	nCounted+=simEvtCounts();
+}
+
+void Sim2PMT::updateClock() { runClock = simRNG.Uniform(0.,ActiveCal->totalTime); }
+
+void Sim2PMT::selectRNGStream() {
+	simRNG.setStream(rngRun?rngRun:evtRun, rngEventIndex(), rngSubstream);
+}
 
 void Sim2PMT::reverseCalibrate() {
 	
 	smassert(ActiveCal);
 	evtRun = ActiveCal->rn;
+	selectRNGStream();
 	updateClock();
 	doUnits();
 	
@@ -169,9 +217,15 @@ void MixSim::startScan(bool startRandom) {
 }
 
 bool MixSim::nextPoint() {
-	smassert(cumStrength.size());
-	std::vector<double>::iterator sline = std::lower_bound(cumStrength.begin(),cumStrength.end(),mc_rnd_source.Uniform(0,cumStrength.back()));
-	unsigned int i = sline-cumStrength.begin();
+	smassert(subSims.size());
+	// select sub-simulation from this event's own stream (sub-stream 0; sub-simulations use 1, 2, ...),
+	// keyed by rngRun or else the calibration run shared with the sub-simulations
+	smassert(rngRun || ActiveCal);
+	if(ActiveCal) evtRun = ActiveCal->rn;
+	selectRNGStream();
+	nSimmed++;
+	double u = simRNG.Uniform(0,1);
+	unsigned int i = simSelector.select(&u);
 	smassert(i<subSims.size());
 	currentSim = subSims[i];
 	currentSim->nextPoint();
@@ -203,6 +257,7 @@ bool MixSim::nextPoint() {
 			wires[s][d] = currentSim->wires[s][d];
 	}
 	runClock = currentSim->runClock;
+	evtRun = currentSim->evtRun;
 	fPID = currentSim->fPID;
 	fType = currentSim->fType;
 	fSide = currentSim->fSide;
@@ -211,16 +266,20 @@ bool MixSim::nextPoint() {
 }
 
 void MixSim::addSim(Sim2PMT* S, double r0, double thalf) {
+	S->simRNG.setBaseSeed(simRNG.getBaseSeed());
+	S->rngSubstream = subSims.size()+1;
 	subSims.push_back(S);
 	initStrength.push_back(r0);
 	halflife.push_back(thalf);
-	cumStrength.push_back((cumStrength.size()?cumStrength.back():0)+exp((t0-t1)*log(2)/thalf)*r0);
+	simSelector.addProb(exp((t0-t1)*log(2)/thalf)*r0);
 }
 
 void MixSim::setTime(double t) {
+	if(t == t1) return;
 	t1 = t;
+	simSelector = PSelector();
 	for(unsigned int i=0; i<halflife.size(); i++)
-		cumStrength[i] = (i?cumStrength[i-1]:0)+exp((t0-t1)*log(2)/halflife[i])*initStrength[i];
+		simSelector.addProb(exp((t0-t1)*log(2)/halflife[i])*initStrength[i]);
 }
 
 void MixSim::setAFP(AFPState a) {
@@ -229,6 +288,12 @@ void MixSim::setAFP(AFPState a) {
 	Sim2PMT::setAFP(a);
 }
 
+void MixSim::setRNGSeed(ULong64_t s, RunNum r) {
+	for(std::vector<Sim2PMT*>::iterator it = subSims.begin(); it != subSims.end(); it++)
+		(*it)->setRNGSeed(s,r);
+	Sim2PMT::setRNGSeed(s,r);
+}
+
 void MixSim::setCalibrator(PMTCalibrator& PCal) {
 	for(std::vector<Sim2PMT*>::iterator it = subSims.begin(); it != subSims.end(); it++)
 		(*it)->setCalibrator(PCal);
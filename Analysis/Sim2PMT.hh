@@ -3,11 +3,19 @@
 
 #include "PMTGenerator.hh"
 #include "ProcessedDataScanner.hh"
+#include "CounterRNG.hh"
+#include "PSelector.hh"
 #include <string>
-#include <TRandom3.h>
 
 class Sim2PMT;
 
+/// range of simulation input events, by stream index (scan pass * nEvents + event number)
+struct SimSpan {
+	ULong64_t first;	///< stream index of first event
+	ULong64_t n;		///< number of events (0 for open-ended)
+	unsigned int sub;	///< random sub-stream for events in range
+};
+
 /// base class for setting simulated data position
 class SimPositioner {
 public:
@@ -19,8 +27,8 @@ public:
 	virtual void applyOffset(Sim2PMT& S);
 	
 protected:	
-	/// calculate offset based on primary position
-	virtual void calcOffset(const Sim2PMT&) {}
+	/// calculate offset based on primary position, drawing from simulation's random stream
+	virtual void calcOffset(const Sim2PMT&, TRandom&) {}
 	
 	double offPos[2];		///< position offset to apply
 };
@@ -31,7 +39,7 @@ public:
 	/// constructor
 	SourcedropPositioner(double x, double y, double r): SimPositioner(), x0(x), y0(y), r0(r) {}
 	/// calculate offset based on primary position
-	virtual void calcOffset(const Sim2PMT& S);
+	virtual void calcOffset(const Sim2PMT& S, TRandom& rnd);
 	
 	double x0;	///< x position center
 	double y0;	///< y position center
@@ -60,6 +68,21 @@ public:
 	virtual double simEvtCounts() const { return fPID==PID_BETA && fType==TYPE_0_EVENT?physicsWeight:0; }
 	/// reset simulation counters
 	virtual void resetSimCounters() { nSimmed = nCounted = 0; }
+	/// select random stream for current event (called at start of reverseCalibrate)
+	virtual void selectRNGStream();
+	/// set random number base seed, and (if nonzero) fixed run number keying random streams
+	virtual void setRNGSeed(ULong64_t s, RunNum r = 0) { simRNG.setBaseSeed(s); rngRun = r; }
+	
+	/// create independent reader on same input data, with same settings, for parallel simulation (NULL if unsupported)
+	virtual Sim2PMT* makeCursor() const { return NULL; }
+	/// copy simulation settings from another Sim2PMT
+	void copySimSettings(const Sim2PMT& S);
+	/// stream index of event the next nextPoint() call will load
+	ULong64_t nextStreamIndex() const { return (ULong64_t)nScanPasses*nEvents+(unsigned int)(currentEvent+1); }
+	/// position scan so next nextPoint() call loads given stream index
+	void seekStream(ULong64_t a);
+	/// load and simulate event by stream index on given random sub-stream (random-access nextPoint, for cursors)
+	void loadStreamEvent(ULong64_t a, unsigned int sub);
 	/// get event info
 	virtual Stringmap evtInfo();
 	
@@ -86,6 +109,10 @@ public:
 	
 	PMTGenerator PGen[BOTH];		///< PMT simulator for each side
 	SimPositioner* SP;				///< optional postion modifier
+	CounterRNG simRNG;				///< random number context, re-keyed by (run, event) for each simulated event
+	RunNum rngRun;					///< run number keying random streams (0 to use calibration run)
+	unsigned int rngSubstream;		///< sub-stream number distinguishing simulations sharing input events
+	unsigned int nScanPasses;		///< number of times input data has wrapped around (distinguishes re-used events)
 	bool reSimulate;				///< whether to re-simulate energy or use "raw" values
 	bool fakeClip;					///< whether to fake clipping on wirechamber entrance edge
 	bool weightAsym;				///< whether to weight simulated events by beta asymmetry
@@ -133,6 +160,8 @@ protected:
 	virtual void updateClock();
 	/// "reverse calibration" from simulated data
 	virtual void reverseCalibrate();
+	/// input event index keying random stream (generated event count for synthesized data without input)
+	ULong64_t rngEventIndex() const { return nEvents ? (ULong64_t)nScanPasses*nEvents+currentEvent : nSimmed; }
 	
 	AFPState afp;				///< AFP state for data
 	bool simCathodes;			///< whether to simulate cathode response
@@ -156,6 +185,8 @@ public:
 	
 	/// set desired AFP state for simulation data
 	virtual void setAFP(AFPState a);
+	/// set random number seed for this and all sub-simulations
+	virtual void setRNGSeed(ULong64_t s, RunNum r = 0);
 	/// set calibrator to use for simulations
 	virtual void setCalibrator(PMTCalibrator& PCal);
 	/// get number of files loaded by sub simulations
@@ -168,7 +199,7 @@ protected:
 	std::vector<Sim2PMT*> subSims;
 	std::vector<double> initStrength;
 	std::vector<double> halflife;
-	std::vector<double> cumStrength;
+	PSelector simSelector;	///< sub-simulation selector by current strengths
 	Sim2PMT* currentSim;
 	double t0;	///< initial time
 	double t1;	///< current time
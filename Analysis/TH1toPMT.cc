@@ -26,7 +26,6 @@ void TH1toPMT::doUnits() {
 	eW[genside] = 1.0;
 	eW[offside] = eDep[offside] = eQ[offside] = 0;
 	ePrim = eDep[genside];
-	static TRandom3 unifrandsource;
-	costheta = unifrandsource.Uniform(2.0)-1.0;
+	costheta = simRNG.Uniform(2.0)-1.0;
 }
 
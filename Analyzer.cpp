@@ -18,6 +18,7 @@
 #include "AsymmetryCorrections.hh"
 #include "OctetSimuCloneManager.hh"
 #include "KurieStudy.hh"
+#include "CalDBSnapshot.hh"
 
 std::vector<RunNum> selectRuns(RunNum r0, RunNum r1, std::string typeSelect) {
 	if(typeSelect=="ref") {
@@ -117,6 +118,14 @@ void mi_DumpCalInfo(StreamInteractor* S) {
 	dumpCalInfo(selectRuns(r0,r1,typeSelect),QOut);
 }
 
+void mi_exportCalSnapshot(StreamInteractor* S) {
+	std::string typeSelect = S->popString();
+	RunNum r1 = S->popInt();
+	RunNum r0 = S->popInt();
+	std::string fname = getEnvSafe("UCNA_CALDB_SNAPSHOT",getEnvSafe("UCNA_ANA_PLOTS")+"/CalDBSnapshot.dat");
+	CalDBSnapshot::exportRuns(*CalDBSQL::getCDB(),selectRuns(r0,r1,typeSelect),fname,CalDBSQL::getCDB()->getSensorNames());
+}
+
 void mi_dumpPosmap(StreamInteractor* S) {
 	int pnum = S->popInt();
 	dumpPosmap(getEnvSafe("UCNA_ANA_PLOTS")+"/PosmapDump/",pnum);
@@ -150,6 +159,22 @@ void mi_processOctet(StreamInteractor* S) {
 	//OSCM.simFile= getEnvSafe("G4OUTDIR")+"/endcap_180_150_neutronBetaUnpol/analyzed_";
 	OSCM.simFactor = 1.0;
 	OSCM.doPlots = true;
+	// optional parallel simulation cloning
+	RunAccumulator::simThreads = atoi(getEnvSafe("UCNA_SIM_THREADS","0").c_str());
+	RunAccumulator::simThreadsCheck = atoi(getEnvSafe("UCNA_SIM_THREADS_CHECK","0").c_str());
+	// optional parallel processed data scanning
+	RunAccumulator::dataThreads = atoi(getEnvSafe("UCNA_DATA_THREADS","0").c_str());
+	// optionally ignore manifests and output age, re-scanning everything
+	RunAccumulator::forceRescan = atoi(getEnvSafe("UCNA_FORCE_RESCAN","0").c_str());
+	// optionally re-scan missing or changed octets before combining
+	OSCM.rescanStale = atoi(getEnvSafe("UCNA_COMBINE_RESCAN","0").c_str());
+	// optional columnar cache of simulation inputs
+	OSCM.simCache = getEnvSafe("UCNA_SIM_CACHE","");
+	// optional tabulated trigger efficiencies, and validation against exact trigger model
+	OSCM.fastTrig = atoi(getEnvSafe("UCNA_FAST_TRIG","0").c_str());
+	OSCM.validateTrig = atoi(getEnvSafe("UCNA_TRIG_VALIDATE","0").c_str());
+	// optional per-run columnar cache of processed data
+	ProcessedDataScanner::physCacheDir = getEnvSafe("UCNA_PHYS_CACHE","");
 	
 	/////////// Geant4 MagF
 	OSCM.nTot = 104;
@@ -313,6 +338,11 @@ void Analyzer(std::deque<std::string> args=std::deque<std::string>()) {
 	dumpCalInfo.addArg("End Run");
 	dumpCalInfo.addArg(&selectRuntype);
 	
+	InputRequester exportCalSnapshot("Export calibrations snapshot file",&mi_exportCalSnapshot);
+	exportCalSnapshot.addArg("Start Run");
+	exportCalSnapshot.addArg("End Run");
+	exportCalSnapshot.addArg(&selectRuntype);
+	
 	InputRequester showCal("Show run calibration",&mi_showCal);
 	showCal.addArg("Run");
 	
@@ -332,6 +362,7 @@ void Analyzer(std::deque<std::string> args=std::deque<std::string>()) {
 	OptionsMenu PostRoutines("Postprocessing Routines");
 	PostRoutines.addChoice(&showCal,"cal");
 	PostRoutines.addChoice(&dumpCalInfo,"dcl");
+	PostRoutines.addChoice(&exportCalSnapshot,"snap");
 	PostRoutines.addChoice(&showOcts,"sho");
 	PostRoutines.addChoice(&octetProcessor,"oct");
 	PostRoutines.addChoice(&showGenerator,"evg");
@@ -0,0 +1,68 @@
+#ifndef CALDBLOCKED_HH
+#define CALDBLOCKED_HH
+
+#include "CalDB.hh"
+#include <mutex>
+
+/// thread-safe wrapper serializing access to a shared (read-only) CalDB
+class CalDBLocked: public CalDB, private NoCopy {
+public:
+	/// constructor, wrapping underlying CalDB
+	CalDBLocked(CalDB* cdb): CDB(cdb) { smassert(CDB); }
+
+	/// check if valid data available for run
+	virtual bool isValid(RunNum rn) { std::lock_guard<std::mutex> l(dbLock); return CDB->isValid(rn); }
+	/// get linearity correction data
+	virtual TGraph* getLinearity(RunNum rn, Side s, unsigned int t) { std::lock_guard<std::mutex> l(dbLock); return CDB->getLinearity(rn,s,t); }
+	/// get noise estimate calibration point ADC width
+	virtual float getNoiseWidth(RunNum rn, Side s, unsigned int t) { std::lock_guard<std::mutex> l(dbLock); return CDB->getNoiseWidth(rn,s,t); }
+	/// get noise estimate calibration point raw ADC value
+	virtual float getNoiseADC(RunNum rn, Side s, unsigned int t) { std::lock_guard<std::mutex> l(dbLock); return CDB->getNoiseADC(rn,s,t); }
+	/// get a run monitor graph
+	virtual TGraphErrors* getRunMonitor(RunNum rn, const std::string& sensorName, const std::string& monType, bool centers = true) {
+		std::lock_guard<std::mutex> l(dbLock); return CDB->getRunMonitor(rn,sensorName,monType,centers); }
+	/// get initial value for run monitor graph
+	virtual float getRunMonitorStart(RunNum rn, const std::string& sensorName, const std::string& monType) {
+		std::lock_guard<std::mutex> l(dbLock); return CDB->getRunMonitorStart(rn,sensorName,monType); }
+	/// get pedestals for named sensor
+	virtual TGraph* getPedestals(RunNum rn, const std::string& sensorName) { std::lock_guard<std::mutex> l(dbLock); return CDB->getPedestals(rn,sensorName); }
+	/// get pedestal widths for named sensor
+	virtual TGraph* getPedwidths(RunNum rn, const std::string& sensorName) { std::lock_guard<std::mutex> l(dbLock); return CDB->getPedwidths(rn,sensorName); }
+	/// get Calibrations DB name
+	virtual std::string getName() const { std::lock_guard<std::mutex> l(dbLock); return CDB->getName(); }
+	/// get GMS Cal run number
+	virtual RunNum getGMSRun(RunNum rn) { std::lock_guard<std::mutex> l(dbLock); return CDB->getGMSRun(rn); }
+	/// get GMS gain tweaking factors
+	virtual void getGainTweak(RunNum rn, Side s, unsigned int t, float& orig, float& final) {
+		std::lock_guard<std::mutex> l(dbLock); CDB->getGainTweak(rn,s,t,orig,final); }
+	/// get positioning corrector for given run (shared between users; treat as read-only)
+	virtual PositioningCorrector* getPositioningCorrector(RunNum rn) { std::lock_guard<std::mutex> l(dbLock); return CDB->getPositioningCorrector(rn); }
+	/// get wirechamber calibration methods (sorted by application priority)
+	virtual std::vector<MWPC_Ecal_Spec> get_MWPC_Ecals(RunNum rn, Side s) { std::lock_guard<std::mutex> l(dbLock); return CDB->get_MWPC_Ecals(rn,s); }
+	/// get trigger efficiency function
+	virtual EfficCurve* getTrigeff(RunNum rn, Side s, unsigned int t) { std::lock_guard<std::mutex> l(dbLock); return CDB->getTrigeff(rn,s,t); }
+	/// get E_vis -> E_true parametrization
+	virtual TGraph* getEvisConversion(RunNum rn, Side s, EventType tp) { std::lock_guard<std::mutex> l(dbLock); return CDB->getEvisConversion(rn,s,tp); }
+	/// get list of cathode segment calibrators (caller is responsible for deletion)
+	virtual std::vector<CathSegCalibrator*> getCathSegCalibrators(RunNum rn, Side s, AxisDirection d) {
+		std::lock_guard<std::mutex> l(dbLock); return CDB->getCathSegCalibrators(rn,s,d); }
+	/// get cathode to charge cloud gain factors
+	virtual std::vector<double> getCathCCloudGains(RunNum rn, Side s, AxisDirection d) {
+		std::lock_guard<std::mutex> l(dbLock); return CDB->getCathCCloudGains(rn,s,d); }
+	/// run start time
+	virtual int startTime(RunNum rn, int t0 = 0) { std::lock_guard<std::mutex> l(dbLock); return CDB->startTime(rn,t0); }
+	/// run end time
+	virtual int endTime(RunNum rn, int t0 = 0) { std::lock_guard<std::mutex> l(dbLock); return CDB->endTime(rn,t0); }
+	/// run time after cuts, blinded
+	virtual BlindTime fiducialTime(RunNum rn) { std::lock_guard<std::mutex> l(dbLock); return CDB->fiducialTime(rn); }
+	/// total run time
+	virtual float totalTime(RunNum rn) { std::lock_guard<std::mutex> l(dbLock); return CDB->totalTime(rn); }
+	/// get RunInfo for given run
+	virtual RunInfo getRunInfo(RunNum r) { std::lock_guard<std::mutex> l(dbLock); return CDB->getRunInfo(r); }
+
+protected:
+	CalDB* CDB;					///< underlying CalDB
+	mutable std::mutex dbLock;	///< lock serializing CalDB access
+};
+
+#endif
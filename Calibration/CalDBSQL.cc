@@ -28,7 +28,189 @@ CalDBSQL::~CalDBSQL() {
 		delete pcors[i];
 }
 
+void CalDBSQL::clearPrefetch() {
+	pfR0 = 1;
+	pfR1 = 0;
+	pfCalSets.clear();
+	pfTubes.clear();
+	pfMonitors.clear();
+	pfContinuous.clear();
+	pfRunTimes.clear();
+	pfGraphs.clear();
+}
+
+/// comma-separated list of IDs
+static std::string idList(const std::vector<unsigned int>& ids, unsigned int i0, unsigned int i1) {
+	std::string l;
+	for(unsigned int i=i0; i<i1 && i<ids.size(); i++)
+		l += (i==i0?"":",")+itos(ids[i]);
+	return l;
+}
+
+void CalDBSQL::prefetchGraphs(const std::vector<unsigned int>& gids, bool windowed, double xlo, double xhi) {
+	for(std::vector<unsigned int>::const_iterator it = gids.begin(); it != gids.end(); it++) {
+		pfGraph& g = pfGraphs[*it];
+		for(unsigned int i=0; i<4; i++) g.d[i].clear();
+		g.complete = !windowed;
+		g.xlo = xlo;
+		g.xhi = xhi;
+	}
+	const unsigned int nChunk = 500;
+	for(unsigned int i0 = 0; i0 < gids.size(); i0 += nChunk) {
+		std::string q = "SELECT graph_id,x_value,x_error,y_value,y_error FROM graph_points WHERE graph_id IN ("+idList(gids,i0,i0+nChunk)+")";
+		if(windowed) {
+			sprintf(query," AND x_value >= %f AND x_value <= %f",xlo,xhi);
+			q += query;
+		}
+		q += " ORDER BY graph_id ASC, x_value ASC";
+		Query(q.c_str());
+		if(!res) {
+			SMExcept e("missingGraph");
+			e.insert("graph_ids",idList(gids,i0,i0+nChunk));
+			throw(e);
+		}
+		TSQLRow* r;
+		while((r = res->Next())) {
+			pfGraph& g = pfGraphs[fieldAsInt(r,0)];
+			for(unsigned int i=0; i<4; i++)
+				g.d[i].push_back(atof(fieldAsString(r,i+1,"0").c_str()));
+			delete(r);
+		}
+	}
+}
+
+void CalDBSQL::prefetchRuns(RunNum r0, RunNum r1) {
+	clearPrefetch();
+	printf("Prefetching calibrations for runs %i-%i...",r0,r1); fflush(stdout);
+	const std::string overlap = "start_run <= "+itos(r1)+" AND end_run >= "+itos(r0);
+	const std::string inRange = "run_number >= "+itos(r0)+" AND run_number <= "+itos(r1);
+	std::vector<unsigned int> gids;
+	TSQLRow* r;
+	
+	// energy calibration sets and their tube calibrations
+	Query(("SELECT ecal_id,gms_run,posmap_set_id,start_run,end_run FROM energy_calibration WHERE "+overlap+" ORDER BY ecal_id").c_str());
+	while(res && (r = res->Next())) {
+		pfCalSet c;
+		c.ecal_id = fieldAsInt(r,0);
+		c.gms_run = fieldAsInt(r,1);
+		c.posmap_set_id = fieldAsInt(r,2);
+		c.start_run = fieldAsInt(r,3);
+		c.end_run = fieldAsInt(r,4);
+		pfCalSets.push_back(c);
+		delete(r);
+	}
+	std::vector<unsigned int> ecids;
+	for(std::vector<pfCalSet>::const_iterator it = pfCalSets.begin(); it != pfCalSets.end(); it++)
+		ecids.push_back(it->ecal_id);
+	if(ecids.size()) {
+		Query(("SELECT tubecal_id,ecal_id,side,quadrant,linearity_graph,noisecal_width,noisecal_adc FROM tube_calibration WHERE ecal_id IN ("
+			   +idList(ecids,0,ecids.size())+")").c_str());
+		while(res && (r = res->Next())) {
+			pfTubeCal tc;
+			tc.tubecal_id = fieldAsInt(r,0);
+			tc.linearity_graph = fieldAsInt(r,4);
+			tc.noisecal_width = fieldAsFloat(r,5);
+			tc.noisecal_adc = fieldAsFloat(r,6);
+			std::string k = itos(fieldAsInt(r,1))+"/"+itos(strToSide(fieldAsString(r,2)))+"/"+itos(fieldAsInt(r,3));
+			pfTubes.insert(std::make_pair(k,tc));
+			if(tc.linearity_graph) gids.push_back(tc.linearity_graph);
+			delete(r);
+		}
+	}
+	
+	// run monitors (pedestals, GMS peaks, ...)
+	Query(("SELECT run_number,sensor_name,monitor_type,center_graph_id,width_graph_id FROM run_monitors,sensors WHERE sensors_sensor_id = sensor_id AND "+inRange).c_str());
+	while(res && (r = res->Next())) {
+		std::pair<int,int> g(fieldAsInt(r,3),fieldAsInt(r,4));
+		pfMonitors.insert(std::make_pair(fieldAsString(r,0)+"/"+fieldAsString(r,1)+"/"+fieldAsString(r,2),g));
+		gids.push_back(g.first);
+		gids.push_back(g.second);
+		delete(r);
+	}
+	
+	// run times
+	Query(("SELECT run_number,UNIX_TIMESTAMP(start_time),UNIX_TIMESTAMP(end_time) FROM run WHERE "+inRange).c_str());
+	int tmin = 0;
+	int tmax = 0;
+	while(res && (r = res->Next())) {
+		pfRunTime t;
+		for(unsigned int i=0; i<2; i++) {
+			t.t[i] = fieldAsInt(r,i+1);
+			t.known[i] = !isNullResult;
+		}
+		if(t.known[0] && (!tmin || t.t[0] < tmin)) tmin = t.t[0];
+		if(t.known[1] && (!tmax || t.t[1] > tmax)) tmax = t.t[1];
+		pfRunTimes.insert(std::make_pair((RunNum)fieldAsInt(r,0),t));
+		delete(r);
+	}
+	
+	// range-based graphs: E_vis conversion, cathode calibrations
+	Query(("SELECT conversion_curve_id FROM evis_conversion WHERE "+overlap).c_str());
+	while(res && (r = res->Next())) { gids.push_back(fieldAsInt(r,0)); delete(r); }
+	Query(("SELECT gain_graph_id FROM cath_ccloud_scale WHERE "+overlap).c_str());
+	while(res && (r = res->Next())) { gids.push_back(fieldAsInt(r,0)); delete(r); }
+	Query(("SELECT graph_id FROM cathshape_graphs,cathseg_cal,cathcal_set WHERE cathshape_graphs.cathseg_id = cathseg_cal.cathseg_id \
+		   AND cathseg_cal.cathcal_set_id = cathcal_set.cathcal_set_id AND "+overlap).c_str());
+	while(res && (r = res->Next())) { gids.push_back(fieldAsInt(r,0)); delete(r); }
+	
+	std::sort(gids.begin(),gids.end());
+	gids.erase(std::unique(gids.begin(),gids.end()),gids.end());
+	prefetchGraphs(gids);
+	
+	// continuous monitors, loaded for run range time span with a day's margin
+	std::vector<unsigned int> cgids;
+	Query("SELECT sensor_name,monitor_type,center_graph_id,width_graph_id FROM continuous_monitors,sensors WHERE sensors_sensor_id = sensor_id");
+	while(res && (r = res->Next())) {
+		std::pair<int,int> g(fieldAsInt(r,2),fieldAsInt(r,3));
+		pfContinuous.insert(std::make_pair(fieldAsString(r,0)+"/"+fieldAsString(r,1),g));
+		cgids.push_back(g.first);
+		cgids.push_back(g.second);
+		delete(r);
+	}
+	if(tmin && tmax) {
+		std::sort(cgids.begin(),cgids.end());
+		cgids.erase(std::unique(cgids.begin(),cgids.end()),cgids.end());
+		prefetchGraphs(cgids,true,tmin-86400.,tmax+86400.);
+	}
+	
+	pfR0 = r0;
+	pfR1 = r1;
+	printf(" %i calibration sets, %i monitors, %i graphs.\n",(int)pfCalSets.size(),(int)pfMonitors.size(),(int)pfGraphs.size());
+}
+
+const CalDBSQL::pfCalSet* CalDBSQL::prefetchedCalSet(RunNum rn) const {
+	// smallest inclusive run range, as in runRangeSelect
+	const pfCalSet* c = NULL;
+	for(std::vector<pfCalSet>::const_iterator it = pfCalSets.begin(); it != pfCalSets.end(); it++)
+		if(it->start_run <= rn && rn <= it->end_run && (!c || it->end_run-it->start_run < c->end_run-c->start_run))
+			c = &*it;
+	return c;
+}
+
+const CalDBSQL::pfTubeCal* CalDBSQL::prefetchedTube(RunNum rn, Side s, unsigned int t) {
+	cacheHits++;
+	const pfCalSet* c = prefetchedCalSet(rn);
+	if(!c) return NULL;
+	std::map<std::string,pfTubeCal>::const_iterator it = pfTubes.find(itos(c->ecal_id)+"/"+itos(s)+"/"+itos(t));
+	return it == pfTubes.end() ? NULL : &it->second;
+}
+
 TGraphErrors* CalDBSQL::getRunMonitor(RunNum rn, const std::string& sensorName, const std::string& monType, bool centers) {
+	if(isPrefetched(rn)) {
+		cacheHits++;
+		std::map<std::string,std::pair<int,int> >::const_iterator it = pfMonitors.find(itos(rn)+"/"+sensorName+"/"+monType);
+		if(it == pfMonitors.end()) {
+			printf("Failed to locate requested monitor: %i %s %s\n",rn,sensorName.c_str(),monType.c_str());
+			return NULL;
+		}
+		try {
+			return getGraph(centers?it->second.first:it->second.second);
+		} catch(SMExcept& e) {
+			e.insert("sensorName",sensorName);
+			e.insert("monType",monType);
+			throw(e);
+		}
+	}
 	if(centers)
 		sprintf(query,"SELECT center_graph_id FROM run_monitors,sensors WHERE run_number = %i \
 				AND sensors_sensor_id = sensor_id AND sensor_name = '%s' AND monitor_type = '%s'",rn,sensorName.c_str(),monType.c_str());
@@ -52,6 +234,18 @@ TGraphErrors* CalDBSQL::getRunMonitor(RunNum rn, const std::string& sensorName,
 }
 
 float CalDBSQL::getRunMonitorStart(RunNum rn, const std::string& sensorName, const std::string& monType) {
+	if(isPrefetched(rn)) {
+		std::map<std::string,std::pair<int,int> >::const_iterator it = pfMonitors.find(itos(rn)+"/"+sensorName+"/"+monType);
+		std::map<unsigned int,pfGraph>::const_iterator git = it==pfMonitors.end()? pfGraphs.end() : pfGraphs.find(it->second.first);
+		if(it == pfMonitors.end() || (git != pfGraphs.end() && git->second.complete)) {
+			cacheHits++;
+			if(it == pfMonitors.end() || !git->second.d[2].size()) {
+				printf("Failed to locate requested monitor start: %i %s %s\n",rn,sensorName.c_str(),monType.c_str());
+				return 0;
+			}
+			return git->second.d[2][0];
+		}
+	}
 	sprintf(query,"SELECT center_graph_id FROM run_monitors,sensors WHERE run_number = %i \
 			AND sensors_sensor_id = sensor_id AND sensor_name = '%s' AND monitor_type = '%s'",rn,sensorName.c_str(),monType.c_str());
 	TSQLRow* r = getFirst();
@@ -73,6 +267,21 @@ float CalDBSQL::getRunMonitorStart(RunNum rn, const std::string& sensorName, con
 
 
 TGraphErrors* CalDBSQL::getContinuousMonitor(const std::string& sensorName, const std::string& monType, RunNum rn, bool centers) {
+	if(isPrefetched(rn)) {
+		cacheHits++;
+		std::map<std::string,std::pair<int,int> >::const_iterator it = pfContinuous.find(sensorName+"/"+monType);
+		if(it == pfContinuous.end()) {
+			printf("Failed to locate requested monitor: %s %s\n",sensorName.c_str(),monType.c_str());
+			return NULL;
+		}
+		try {
+			return getGraph(centers?it->second.first:it->second.second,rn);
+		} catch (SMExcept& e) {
+			e.insert("sensorName",sensorName);
+			e.insert("monType",monType);
+			throw(e);
+		}
+	}
 	sprintf(query,"SELECT center_graph_id,width_graph_id FROM continuous_monitors,sensors \
 			WHERE sensors_sensor_id = sensor_id AND sensor_name = '%s' AND monitor_type = '%s'",sensorName.c_str(),monType.c_str());
 	TSQLRow* r = getFirst();
@@ -209,6 +418,8 @@ PositioningCorrector* CalDBSQL::getPositioningCorrectorByID(unsigned int psid) {
 	
 	PositioningCorrector* PC = new PositioningCorrector();
 	PC->loadData(pinf);
+	if(PositioningCorrector::defaultBakeSpacing > 0)
+		PC->bake();
 	pcors.insert(std::make_pair(psid,PC));
 	printf(" Done.\n");
 	return getPositioningCorrectorByID(psid);
@@ -220,6 +431,17 @@ void CalDBSQL::forgetPositioningCorrector(RunNum rn) {
 }
 
 unsigned int CalDBSQL::getCalSetInfo(RunNum R, const char* field) {
+	const std::string f = field;
+	if(isPrefetched(R) && (f=="ecal_id" || f=="gms_run" || f=="posmap_set_id")) {
+		cacheHits++;
+		const pfCalSet* c = prefetchedCalSet(R);
+		if(!c)
+			return 0;
+		if(c->start_run == 1)
+			printf("**** WARNING: Catchall Calibration selected for Run %i\n",R);
+		return f=="ecal_id" ? c->ecal_id : f=="gms_run" ? c->gms_run : c->posmap_set_id;
+	}
+	if(pfR0 <= pfR1) cacheMisses++;
 	sprintf(query,"SELECT %s,start_run FROM energy_calibration WHERE %s",field,runRangeSelect(R).c_str());
 	TSQLRow* r = getFirst();
 	if(!r)
@@ -232,6 +454,14 @@ unsigned int CalDBSQL::getCalSetInfo(RunNum R, const char* field) {
 }
 
 unsigned int CalDBSQL::getTubecalID(RunNum R, Side s, unsigned int t) {
+	if(isPrefetched(R)) {
+		const pfTubeCal* tc = prefetchedTube(R,s,t);
+		if(!tc) {
+			printf("Failed to locate Tube Data: %i %s %i\n;",R,sideWords(s),t);
+			return 0;
+		}
+		return tc->tubecal_id;
+	}
 	unsigned int csid = getCalSetInfo(R,"ecal_id");
 	sprintf(query,"SELECT tubecal_id FROM tube_calibration WHERE ecal_id = %i AND side = %s AND quadrant = %i",csid,dbSideName(s),t);
 	TSQLRow* r = getFirst();
@@ -245,6 +475,14 @@ unsigned int CalDBSQL::getTubecalID(RunNum R, Side s, unsigned int t) {
 }
 
 float CalDBSQL::getTubecalData(RunNum rn, Side s, unsigned int t, const char* field) {
+	const std::string f = field;
+	if(isPrefetched(rn) && (f=="noisecal_width" || f=="noisecal_adc")) {
+		const pfTubeCal* tc = prefetchedTube(rn,s,t);
+		smassert(tc || IGNORE_DEAD_DB);
+		if(!tc)
+			return 0;
+		return f=="noisecal_width" ? tc->noisecal_width : tc->noisecal_adc;
+	}
 	unsigned int tsid = getTubecalID(rn, s, t);
 	smassert(tsid || IGNORE_DEAD_DB);
 	sprintf(query,"SELECT %s FROM tube_calibration WHERE tubecal_id = %i",field,tsid);
@@ -257,6 +495,13 @@ float CalDBSQL::getTubecalData(RunNum rn, Side s, unsigned int t, const char* fi
 }
 
 int CalDBSQL::getTubecalInt(RunNum rn, Side s, unsigned int t, const char* field) {
+	if(isPrefetched(rn) && std::string(field)=="linearity_graph") {
+		const pfTubeCal* tc = prefetchedTube(rn,s,t);
+		smassert(tc || IGNORE_DEAD_DB);
+		if(!tc)
+			return 0;
+		return tc->linearity_graph;
+	}
 	unsigned int tsid = getTubecalID(rn, s, t);
 	smassert(tsid || IGNORE_DEAD_DB);
 	sprintf(query,"SELECT %s FROM tube_calibration WHERE tubecal_id = %i",field,tsid);
@@ -269,6 +514,13 @@ int CalDBSQL::getTubecalInt(RunNum rn, Side s, unsigned int t, const char* field
 }
 
 int CalDBSQL::startTime(RunNum rn, int t0) {
+	if(isPrefetched(rn)) {
+		cacheHits++;
+		std::map<RunNum,pfRunTime>::const_iterator it = pfRunTimes.find(rn);
+		if(it == pfRunTimes.end() || !it->second.known[0])
+			return -t0;
+		return it->second.t[0]-t0;
+	}
 	sprintf(query,"SELECT UNIX_TIMESTAMP(start_time)-%i FROM run WHERE run_number = %u",t0,rn);
 	TSQLRow* row = getFirst();
 	if(!row)
@@ -279,6 +531,13 @@ int CalDBSQL::startTime(RunNum rn, int t0) {
 }
 
 int CalDBSQL::endTime(RunNum rn, int t0) {
+	if(isPrefetched(rn)) {
+		cacheHits++;
+		std::map<RunNum,pfRunTime>::const_iterator it = pfRunTimes.find(rn);
+		if(it == pfRunTimes.end() || !it->second.known[1])
+			return -t0;
+		return it->second.t[1]-t0;
+	}
 	sprintf(query,"SELECT UNIX_TIMESTAMP(end_time)-%i FROM run WHERE run_number = %u",t0,rn);
 	TSQLRow* row = getFirst();
 	if(!row)
@@ -407,6 +666,19 @@ std::vector<RunNum> CalDBSQL::findRuns(const std::string& whereConditions, RunNu
 	return v;
 }
 
+std::vector<std::string> CalDBSQL::getSensorNames() {
+	Query("SELECT sensor_name FROM sensors ORDER BY sensor_id ASC");
+	std::vector<std::string> v;
+	if(!res)
+		return v;
+	TSQLRow* row;
+	while((row = res->Next())) {
+		v.push_back(fieldAsString(row,0));
+		delete(row);
+	}
+	return v;
+}
+
 EfficCurve* CalDBSQL::getTrigeff(RunNum rn, Side s, unsigned int t) {
 	sprintf(query,"SELECT params_graph FROM mpm_trigeff WHERE run_number = %i AND side = %s AND quadrant = %i",rn,dbSideName(s),t);
 	Query();
@@ -501,34 +773,20 @@ std::vector<double> CalDBSQL::getCathCCloudGains(RunNum rn, Side s, AxisDirectio
 	return v;
 }
 
-TGraphErrors* CalDBSQL::getGraph(unsigned int gid) {
-	std::vector<float> gdata[4];
-	sprintf(query,"SELECT x_value,x_error,y_value,y_error FROM graph_points WHERE graph_id = %i ORDER BY x_value ASC",gid);
-	Query();
-	if(!res) {
-		SMExcept e("missingGraph");
-		e.insert("graph_id",itos(gid));
-		throw(e);
-	}
-	TSQLRow* r;
-	while((r = res->Next())) {
-		for(unsigned int i=0; i<4; i++)
-			gdata[i].push_back(fieldAsFloat(r,i));
-		delete(r);
-	}
+TGraphErrors* CalDBSQL::makeGraph(std::vector<float> gdata[4], const std::string& gname) const {
 	unsigned int npts = gdata[0].size();
 	if(!npts) {
 		SMExcept e("missingGraphData");
-		e.insert("graph_id",itos(gid));
+		e.insert("graph_id",gname);
 		throw(e);
 	}
 	if(npts == 1) {
-		printf("Notice: only 1 graph point found for <%i>; extending to 2.\n",gid);
+		printf("Notice: only 1 graph point found for <%s>; extending to 2.\n",gname.c_str());
 		for(unsigned int i=0; i<4; i++)
 			gdata[i].push_back(gdata[i].back());
 		gdata[0].back() += 10.0;
 		npts++;
-	}		
+	}
 	TGraphErrors* tg = new TGraphErrors(npts);
 	for(unsigned int i=0; i<npts; i++) {
 		tg->SetPoint(i,gdata[0][i],gdata[2][i]);
@@ -537,8 +795,68 @@ TGraphErrors* CalDBSQL::getGraph(unsigned int gid) {
 	return tg;
 }
 
+TGraphErrors* CalDBSQL::getGraph(unsigned int gid) {
+	std::vector<float> gdata[4];
+	std::map<unsigned int,pfGraph>::const_iterator it = pfGraphs.find(gid);
+	if(it != pfGraphs.end() && it->second.complete) {
+		cacheHits++;
+		for(unsigned int i=0; i<4; i++)
+			gdata[i].assign(it->second.d[i].begin(),it->second.d[i].end());
+		return makeGraph(gdata,itos(gid));
+	}
+	if(pfR0 <= pfR1) cacheMisses++;
+	sprintf(query,"SELECT x_value,x_error,y_value,y_error FROM graph_points WHERE graph_id = %i ORDER BY x_value ASC",gid);
+	Query();
+	if(!res) {
+		SMExcept e("missingGraph");
+		e.insert("graph_id",itos(gid));
+		throw(e);
+	}
+	TSQLRow* r;
+	while((r = res->Next())) {
+		for(unsigned int i=0; i<4; i++)
+			gdata[i].push_back(fieldAsFloat(r,i));
+		delete(r);
+	}
+	return makeGraph(gdata,itos(gid));
+}
+
 TGraphErrors* CalDBSQL::getGraph(unsigned int gid, RunNum rn) {
 	
+	std::map<unsigned int,pfGraph>::const_iterator it = pfGraphs.find(gid);
+	if(it != pfGraphs.end()) {
+		// same selection as queries below, if loaded points cover it
+		const pfGraph& g = it->second;
+		const std::vector<double>& x = g.d[0];
+		const int t0 = startTime(rn);
+		const int t1 = endTime(rn);
+		int i0 = -1;
+		int i1 = -1;
+		for(unsigned int i=0; i<x.size(); i++) {
+			if(x[i] < t0) i0 = i;
+			if(x[i] > t1 && i1 < 0) i1 = i;
+		}
+		bool ok = x.size() && (g.complete || (i0 >= 0 && i1 >= 0));
+		if(ok) {
+			float tstart = x[i0>=0 ? i0 : 0];
+			float tend = x[i1>=0 ? i1 : x.size()-1];
+			const double xmin = tstart-10;
+			const double xmax = tend+10;
+			if(g.complete || (g.xlo <= xmin && xmax <= g.xhi)) {
+				cacheHits++;
+				std::vector<float> gdata[4];
+				for(unsigned int i=0; i<x.size(); i++) {
+					if(x[i] < xmin || x[i] > xmax) continue;
+					gdata[0].push_back(x[i]-t0);
+					for(unsigned int j=1; j<4; j++)
+						gdata[j].push_back(g.d[j][i]);
+				}
+				return makeGraph(gdata,itos(gid)+";"+itos(rn));
+			}
+		}
+	}
+	if(pfR0 <= pfR1) cacheMisses++;
+	
 	// determine start time
 	sprintf(query,"SELECT x_value FROM graph_points WHERE graph_id = %i \
 			AND x_value < %i ORDER BY %i-x_value ASC LIMIT 1",gid,startTime(rn),startTime(rn));
@@ -591,26 +909,7 @@ TGraphErrors* CalDBSQL::getGraph(unsigned int gid, RunNum rn) {
 		delete(r);
 	}
 	
-	// compile graph
-	unsigned int npts = gdata[0].size();
-	if(!npts) {
-		SMExcept e("missingGraphData");
-		e.insert("graph_id",itos(gid));
-		throw(e);
-	}
-	if(npts == 1) {
-		printf("Notice: only 1 graph point found for <%i;%i>; extending to 2.\n",gid,rn);
-		for(unsigned int i=0; i<4; i++)
-			gdata[i].push_back(gdata[i].back());
-		gdata[0].back() += 10.0;
-		npts++;
-	}
-	TGraphErrors* tg = new TGraphErrors(npts);
-	for(unsigned int i=0; i<npts; i++) {
-		tg->SetPoint(i,gdata[0][i],gdata[2][i]);
-		tg->SetPointError(i,gdata[1][i],gdata[3][i]);
-	}
-	return tg;
+	return makeGraph(gdata,itos(gid)+";"+itos(rn));
 }
 
 
@@ -622,6 +921,7 @@ unsigned int CalDBSQL::newGraph(const std::string& description) {
 
 void CalDBSQL::deleteGraph(unsigned int gid) {
 	printf("Deleting graph %i...\n",gid);
+	pfGraphs.erase(gid);
 	sprintf(query,"DELETE FROM graph_points WHERE graph_id = %i",gid);
 	execute();
 	sprintf(query,"DELETE FROM graphs WHERE graph_id = %i",gid);
@@ -73,6 +73,8 @@ public:
 	RunInfo getRunInfo(RunNum r);
 	/// get a list of run numbers matching the given conditions
 	std::vector<RunNum> findRuns(const std::string& whereConditions, RunNum r0, RunNum r1);
+	/// get names of all sensors
+	std::vector<std::string> getSensorNames();
 	
 	/// get name
 	virtual std::string getName() const { return getDBName(); }
@@ -80,6 +82,16 @@ public:
 	/// globally available CalDB
 	static CalDBSQL* getCDB(bool readonly = true);
 	
+	/// bulk-load calibration rows, run monitors and graph points for run range in a few set-based queries,
+	/// so later per-run requests in range are served from memory (replaces any previous prefetch)
+	void prefetchRuns(RunNum r0, RunNum r1);
+	/// discard prefetched data
+	void clearPrefetch();
+	/// whether run is in prefetched range
+	bool isPrefetched(RunNum rn) const { return pfR0 <= rn && rn <= pfR1; }
+	unsigned int cacheHits;		///< number of requests served from prefetched data
+	unsigned int cacheMisses;	///< number of graph/calibration requests needing DB queries
+	
 	/// create an ID for a new graph
 	unsigned int newGraph(const std::string& description);
 	/// delete graph with given ID
@@ -111,7 +123,7 @@ protected:
 			 const std::string& dbUser =  getEnvSafe("UCNADBUSER_READONLY"),
 			 const std::string& dbPass = getEnvSafe("UCNADBPASS_READONLY"),
 			 unsigned int port = atoi(getEnvSafe("UCNADBPORT","3306").c_str())
-			 ): SQLHelper(mydbName,dbAddress,dbUser,dbPass,port) {}
+			 ): SQLHelper(mydbName,dbAddress,dbUser,dbPass,port), cacheHits(0), cacheMisses(0), pfR0(1), pfR1(0) {}
 	/// get sensor ID for given name
 	unsigned int getSensorID(const std::string& sname);
 	/// get calibration set table info for given run
@@ -128,8 +140,53 @@ protected:
 	TGraphErrors* getGraph(unsigned int gid, RunNum rn);
 	/// get run group name for run
 	std::string getGroupName(RunNum rn);
+	/// make graph from point data columns (x, dx, y, dy), extending single point to 2
+	TGraphErrors* makeGraph(std::vector<float> gdata[4], const std::string& gname) const;
+	/// load graph_points for graph IDs into prefetch cache; optionally, only points in [xlo,xhi]
+	void prefetchGraphs(const std::vector<unsigned int>& gids, bool windowed = false, double xlo = 0, double xhi = 0);
 	
 	std::map<unsigned int,PositioningCorrector*> pcors;	///< cached positioning correctors
+	
+	/// prefetched energy_calibration row
+	struct pfCalSet {
+		unsigned int ecal_id;		///< calibration set ID
+		unsigned int gms_run;		///< GMS reference run
+		unsigned int posmap_set_id;	///< position map ID
+		RunNum start_run;			///< start of valid range
+		RunNum end_run;				///< end of valid range
+	};
+	/// prefetched tube_calibration row
+	struct pfTubeCal {
+		unsigned int tubecal_id;	///< tube calibration ID
+		int linearity_graph;		///< linearity graph ID
+		float noisecal_width;		///< noise calibration width
+		float noisecal_adc;			///< noise calibration ADC
+	};
+	/// prefetched graph points
+	struct pfGraph {
+		std::vector<double> d[4];	///< x, dx, y, dy columns, sorted by x
+		bool complete;				///< whether all points are loaded (otherwise only those in [xlo,xhi])
+		double xlo;					///< lower limit of loaded points, if not complete
+		double xhi;					///< upper limit of loaded points, if not complete
+	};
+	/// prefetched run start/end times
+	struct pfRunTime {
+		int t[2];			///< start, end UNIX timestamps
+		bool known[2];		///< whether start, end are non-NULL
+	};
+	/// get prefetched calibration set for run (NULL if none)
+	const pfCalSet* prefetchedCalSet(RunNum rn) const;
+	/// get prefetched tube calibration for run (NULL if none)
+	const pfTubeCal* prefetchedTube(RunNum rn, Side s, unsigned int t);
+	
+	RunNum pfR0;											///< start of prefetched run range
+	RunNum pfR1;											///< end of prefetched run range
+	std::vector<pfCalSet> pfCalSets;						///< prefetched calibration sets overlapping range
+	std::map<std::string,pfTubeCal> pfTubes;				///< prefetched tube calibrations by ecal_id/side/tube
+	std::map<std::string,std::pair<int,int> > pfMonitors;	///< prefetched run monitor (center,width) graph IDs by run/sensor/type
+	std::map<std::string,std::pair<int,int> > pfContinuous;	///< prefetched continuous monitor (center,width) graph IDs by sensor/type
+	std::map<RunNum,pfRunTime> pfRunTimes;					///< prefetched run start/end times
+	std::map<unsigned int,pfGraph> pfGraphs;				///< prefetched graph points
 };
 
 #endif
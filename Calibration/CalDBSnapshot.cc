@@ -0,0 +1,650 @@
+#include "CalDBSnapshot.hh"
+#include "CalDBSQL.hh"
+#include "PMTCalibrator.hh"
+#include "PathUtils.hh"
+#include "SMExcept.hh"
+#include "strutils.hh"
+#include <set>
+#include <string.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+static const char snapMagic[8] = {'C','A','L','S','N','A','P','1'};
+static const uint32_t noObject = 0xFFFFFFFF;
+
+/// snapshot index entry (sorted by key)
+struct snapIndexEntry {
+	uint64_t keyOff;	///< key location in file
+	uint64_t dataOff;	///< record location in file
+	uint32_t keyLen;	///< key length
+	uint32_t dataLen;	///< record length
+};
+
+//-------------------------------------------
+// record keys
+
+static std::string snapKey(const char* tag, RunNum rn) { return std::string(tag)+"/"+itos(rn); }
+static std::string snapKey(const char* tag, RunNum rn, int a) { return snapKey(tag,rn)+"/"+itos(a); }
+static std::string snapKey(const char* tag, RunNum rn, int a, int b) { return snapKey(tag,rn,a)+"/"+itos(b); }
+static std::string snapKey(const char* tag, RunNum rn, const std::string& a) { return snapKey(tag,rn)+"/"+a; }
+static std::string snapKey(const char* tag, RunNum rn, const std::string& a, const std::string& b) { return snapKey(tag,rn,a)+"/"+b; }
+
+//-------------------------------------------
+// record encoding
+
+/// binary record writer
+class SnapWriter {
+public:
+	/// append plain value
+	template<typename T>
+	void put(const T& x) { d.append((const char*)&x,sizeof(T)); }
+	/// append string
+	void putStr(const std::string& s) { put<uint32_t>(s.size()); d.append(s); }
+	/// append graph (or NULL)
+	void putGraph(const TGraph* g) {
+		if(!g) { put<uint32_t>(noObject); return; }
+		put<uint32_t>(g->GetN());
+		for(int i=0; i<g->GetN(); i++) {
+			put<double>(g->GetX()[i]);
+			put<double>(g->GetEX()?g->GetEX()[i]:0);
+			put<double>(g->GetY()[i]);
+			put<double>(g->GetEY()?g->GetEY()[i]:0);
+		}
+	}
+	/// append RunInfo
+	void putRunInfo(const RunInfo& R) {
+		put<uint32_t>(R.runNum);
+		put<int32_t>(R.slowDaq);
+		putStr(R.groupName);
+		put<int32_t>(R.type);
+		put<int32_t>(R.octet);
+		put<int32_t>(R.gvState);
+		put<int32_t>(R.afpState);
+		put<int32_t>(R.runGeometry);
+		put<int32_t>(R.runQuality);
+		putStr(R.roleName);
+		put<float>(R.startTime);
+		put<BlindTime>(R.liveTime);
+		put<BlindTime>(R.wallTime);
+		put<float>(R.scsField);
+		putStr(R.comments);
+	}
+
+	std::string d;	///< record data
+};
+
+/// binary record reader
+class SnapReader {
+public:
+	/// constructor
+	SnapReader(const char* dat, uint32_t len, const std::string& k): p(dat), end(dat+len), key(k) {}
+	/// read plain value
+	template<typename T>
+	T get() { need(sizeof(T)); T x; memcpy(&x,p,sizeof(T)); p += sizeof(T); return x; }
+	/// read string
+	std::string getStr() { uint32_t n = get<uint32_t>(); need(n); std::string s(p,n); p += n; return s; }
+	/// read graph (or NULL)
+	TGraphErrors* getGraph() {
+		uint32_t n = get<uint32_t>();
+		if(n == noObject) return NULL;
+		need((size_t)n*4*sizeof(double));
+		TGraphErrors* g = new TGraphErrors(n);
+		for(uint32_t i=0; i<n; i++) {
+			double x = get<double>();
+			double dx = get<double>();
+			double y = get<double>();
+			double dy = get<double>();
+			g->SetPoint(i,x,y);
+			g->SetPointError(i,dx,dy);
+		}
+		return g;
+	}
+	/// read RunInfo
+	RunInfo getRunInfo() {
+		RunInfo R(get<uint32_t>());
+		R.slowDaq = get<int32_t>();
+		R.groupName = getStr();
+		R.type = RunType(get<int32_t>());
+		R.octet = OctetRole(get<int32_t>());
+		R.gvState = GVState(get<int32_t>());
+		R.afpState = AFPState(get<int32_t>());
+		R.runGeometry = RunGeometry(get<int32_t>());
+		R.runQuality = DataQuality(get<int32_t>());
+		R.roleName = getStr();
+		R.startTime = get<float>();
+		R.liveTime = get<BlindTime>();
+		R.wallTime = get<BlindTime>();
+		R.scsField = get<float>();
+		R.comments = getStr();
+		return R;
+	}
+
+protected:
+	/// check enough data remains
+	void need(size_t n) const {
+		if((size_t)(end-p) < n) {
+			SMExcept e("badSnapshotRecord");
+			e.insert("key",key);
+			throw(e);
+		}
+	}
+
+	const char* p;		///< current read position
+	const char* end;	///< end of record
+	std::string key;	///< record key, for error reporting
+};
+
+//-------------------------------------------
+// export
+
+/// CalDB pass-through recording results of all requests
+class CalDBRecorder: public CalDB {
+public:
+	/// constructor
+	CalDBRecorder(CalDB& s): src(s) {}
+
+	virtual bool isValid(RunNum rn) {
+		bool b = src.isValid(rn);
+		SnapWriter w; w.put<uint8_t>(b); save(snapKey("valid",rn),w);
+		return b;
+	}
+	virtual TGraph* getLinearity(RunNum rn, Side s, unsigned int t) {
+		TGraph* g = src.getLinearity(rn,s,t);
+		SnapWriter w; w.putGraph(g); save(snapKey("lin",rn,s,t),w);
+		return g;
+	}
+	virtual float getNoiseWidth(RunNum rn, Side s, unsigned int t) {
+		float x = src.getNoiseWidth(rn,s,t);
+		SnapWriter w; w.put<float>(x); save(snapKey("noisew",rn,s,t),w);
+		return x;
+	}
+	virtual float getNoiseADC(RunNum rn, Side s, unsigned int t) {
+		float x = src.getNoiseADC(rn,s,t);
+		SnapWriter w; w.put<float>(x); save(snapKey("noiseadc",rn,s,t),w);
+		return x;
+	}
+	virtual TGraphErrors* getRunMonitor(RunNum rn, const std::string& sensorName, const std::string& monType, bool centers = true) {
+		TGraphErrors* g = src.getRunMonitor(rn,sensorName,monType,centers);
+		SnapWriter w; w.putGraph(g); save(snapKey(centers?"monc":"monw",rn,sensorName,monType),w);
+		return g;
+	}
+	virtual float getRunMonitorStart(RunNum rn, const std::string& sensorName, const std::string& monType) {
+		float x = src.getRunMonitorStart(rn,sensorName,monType);
+		SnapWriter w; w.put<float>(x); save(snapKey("mon0",rn,sensorName,monType),w);
+		return x;
+	}
+	virtual TGraph* getPedestals(RunNum rn, const std::string& sensorName) {
+		TGraph* g = src.getPedestals(rn,sensorName);
+		SnapWriter w; w.putGraph(g); save(snapKey("ped",rn,sensorName),w);
+		return g;
+	}
+	virtual TGraph* getPedwidths(RunNum rn, const std::string& sensorName) {
+		TGraph* g = src.getPedwidths(rn,sensorName);
+		SnapWriter w; w.putGraph(g); save(snapKey("pedw",rn,sensorName),w);
+		return g;
+	}
+	virtual std::string getName() const { return src.getName(); }
+	virtual RunNum getGMSRun(RunNum rn) {
+		RunNum r = src.getGMSRun(rn);
+		SnapWriter w; w.put<uint32_t>(r); save(snapKey("gms",rn),w);
+		return r;
+	}
+	virtual void getGainTweak(RunNum rn, Side s, unsigned int t, float& orig, float& final) {
+		src.getGainTweak(rn,s,t,orig,final);
+		SnapWriter w; w.put<float>(orig); w.put<float>(final); save(snapKey("tweak",rn,s,t),w);
+	}
+	virtual PositioningCorrector* getPositioningCorrector(RunNum rn) {
+		PositioningCorrector* P = src.getPositioningCorrector(rn);
+		SnapWriter w; w.put<uint32_t>(posmapID(P)); save(snapKey("pcor",rn),w);
+		return P;
+	}
+	virtual std::vector<MWPC_Ecal_Spec> get_MWPC_Ecals(RunNum rn, Side s) {
+		std::vector<MWPC_Ecal_Spec> v = src.get_MWPC_Ecals(rn,s);
+		SnapWriter w;
+		w.put<uint32_t>(v.size());
+		for(std::vector<MWPC_Ecal_Spec>::const_iterator it = v.begin(); it != v.end(); it++) {
+			w.put<int32_t>(it->charge_meas);
+			w.put<double>(it->gain_factor);
+			w.put<uint32_t>(posmapID(it->pcorr));
+			w.put<int32_t>(it->priority);
+			w.put<uint32_t>(it->start_run);
+			w.put<uint32_t>(it->end_run);
+		}
+		save(snapKey("mwpcecal",rn,s),w);
+		return v;
+	}
+	virtual EfficCurve* getTrigeff(RunNum rn, Side s, unsigned int t) {
+		EfficCurve* C = src.getTrigeff(rn,s,t);
+		SnapWriter w;
+		w.put<uint8_t>(C != NULL);
+		if(C) for(unsigned int i=0; i<4; i++) w.put<double>(C->params[i]);
+		save(snapKey("trigeff",rn,s,t),w);
+		return C;
+	}
+	virtual TGraph* getEvisConversion(RunNum rn, Side s, EventType tp) {
+		TGraph* g = src.getEvisConversion(rn,s,tp);
+		SnapWriter w; w.putGraph(g); save(snapKey("evis",rn,s,tp),w);
+		return g;
+	}
+	virtual std::vector<CathSegCalibrator*> getCathSegCalibrators(RunNum rn, Side s, AxisDirection d) {
+		std::vector<CathSegCalibrator*> v = src.getCathSegCalibrators(rn,s,d);
+		SnapWriter w;
+		w.put<uint32_t>(v.size());
+		for(std::vector<CathSegCalibrator*>::const_iterator it = v.begin(); it != v.end(); it++) {
+			w.put<double>((*it)->pos);
+			w.putStr((*it)->channel);
+			w.put<double>((*it)->norm);
+			w.put<uint32_t>((*it)->pcoeffs.size());
+			for(std::vector<TGraph*>::const_iterator git = (*it)->pcoeffs.begin(); git != (*it)->pcoeffs.end(); git++)
+				w.putGraph(*git);
+		}
+		save(snapKey("cathseg",rn,s,d),w);
+		return v;
+	}
+	virtual std::vector<double> getCathCCloudGains(RunNum rn, Side s, AxisDirection d) {
+		std::vector<double> v = src.getCathCCloudGains(rn,s,d);
+		SnapWriter w;
+		w.put<uint32_t>(v.size());
+		for(std::vector<double>::const_iterator it = v.begin(); it != v.end(); it++) w.put<double>(*it);
+		save(snapKey("ccloud",rn,s,d),w);
+		return v;
+	}
+	virtual int startTime(RunNum rn, int t0 = 0) {
+		int t = src.startTime(rn,0);
+		SnapWriter w; w.put<int32_t>(t); save(snapKey("tstart",rn),w);
+		return t-t0;
+	}
+	virtual int endTime(RunNum rn, int t0 = 0) {
+		int t = src.endTime(rn,0);
+		SnapWriter w; w.put<int32_t>(t); save(snapKey("tend",rn),w);
+		return t-t0;
+	}
+	virtual BlindTime fiducialTime(RunNum rn) {
+		BlindTime b = src.fiducialTime(rn);
+		SnapWriter w; w.put<BlindTime>(b); save(snapKey("tfid",rn),w);
+		return b;
+	}
+	virtual float totalTime(RunNum rn) {
+		float t = src.totalTime(rn);
+		SnapWriter w; w.put<float>(t); save(snapKey("ttot",rn),w);
+		return t;
+	}
+	virtual RunInfo getRunInfo(RunNum r) {
+		RunInfo R = src.getRunInfo(r);
+		SnapWriter w; w.putRunInfo(R); save(snapKey("info",r),w);
+		return R;
+	}
+
+	/// write recorded data to file
+	void write(const std::string& fname) const;
+
+	std::map<std::string,std::string> recs;	///< recorded data by key
+
+protected:
+	/// store record
+	void save(const std::string& key, const SnapWriter& w) { recs[key] = w.d; }
+	/// snapshot index for positioning corrector, recording its data on first use
+	uint32_t posmapID(const PositioningCorrector* P) {
+		if(!P) return noObject;
+		std::map<const PositioningCorrector*,uint32_t>::const_iterator it = pcIDs.find(P);
+		if(it != pcIDs.end()) return it->second;
+		uint32_t pmid = pcIDs.size();
+		pcIDs.insert(std::make_pair(P,pmid));
+		const std::vector<PosmapInfo>& pinf = P->getData();
+		SnapWriter w;
+		w.put<uint32_t>(pinf.size());
+		for(std::vector<PosmapInfo>::const_iterator pit = pinf.begin(); pit != pinf.end(); pit++) {
+			w.put<uint32_t>(pit->nRings);
+			w.put<float>(pit->radius);
+			w.put<int32_t>(pit->s);
+			w.put<uint32_t>(pit->t);
+			w.put<uint32_t>(pit->signal.size());
+			for(unsigned int i=0; i<pit->signal.size(); i++) w.put<float>(pit->signal[i]);
+			w.put<uint32_t>(pit->norm.size());
+			for(unsigned int i=0; i<pit->norm.size(); i++) w.put<float>(pit->norm[i]);
+		}
+		save("posmap/"+itos(pmid),w);
+		return pmid;
+	}
+
+	CalDB& src;												///< underlying CalDB
+	std::map<const PositioningCorrector*,uint32_t> pcIDs;	///< snapshot indices for positioning correctors
+};
+
+void CalDBRecorder::write(const std::string& fname) const {
+	// layout: magic, number of records, sorted index, keys, records
+	const uint64_t n = recs.size();
+	uint64_t keyPos = sizeof(snapMagic)+sizeof(uint64_t)+n*sizeof(snapIndexEntry);
+	uint64_t dataPos = keyPos;
+	for(std::map<std::string,std::string>::const_iterator it = recs.begin(); it != recs.end(); it++)
+		dataPos += it->first.size();
+	std::vector<snapIndexEntry> idx;
+	for(std::map<std::string,std::string>::const_iterator it = recs.begin(); it != recs.end(); it++) {
+		snapIndexEntry e;
+		e.keyOff = keyPos;
+		e.keyLen = it->first.size();
+		e.dataOff = dataPos;
+		e.dataLen = it->second.size();
+		keyPos += e.keyLen;
+		dataPos += e.dataLen;
+		idx.push_back(e);
+	}
+
+	std::string tmpname = fname+".tmp";
+	FILE* f = fopen(tmpname.c_str(),"wb");
+	if(!f) {
+		SMExcept e("fileWriteError");
+		e.insert("fileName",tmpname);
+		throw(e);
+	}
+	fwrite(snapMagic,sizeof(snapMagic),1,f);
+	fwrite(&n,sizeof(uint64_t),1,f);
+	if(n) fwrite(&idx[0],sizeof(snapIndexEntry),n,f);
+	for(std::map<std::string,std::string>::const_iterator it = recs.begin(); it != recs.end(); it++)
+		fwrite(it->first.data(),1,it->first.size(),f);
+	for(std::map<std::string,std::string>::const_iterator it = recs.begin(); it != recs.end(); it++)
+		fwrite(it->second.data(),1,it->second.size(),f);
+	if(fclose(f) || rename(tmpname.c_str(),fname.c_str())) {
+		SMExcept e("fileWriteError");
+		e.insert("fileName",fname);
+		throw(e);
+	}
+}
+
+void CalDBSnapshot::exportRuns(CalDB& src, const std::vector<RunNum>& runs, const std::string& fname, const std::vector<std::string>& sensors) {
+	// recorder is kept: cached LinearityCorrectors for GMS runs retain a pointer to the CalDB that created them
+	CalDBRecorder* R = new CalDBRecorder(src);
+	SnapWriter w;
+	w.putStr(R->getName());
+	R->recs["name"] = w.d;
+
+	std::set<RunNum> todo(runs.begin(),runs.end());
+	std::set<RunNum> done;
+	while(todo.size()) {
+		RunNum rn = *todo.begin();
+		todo.erase(todo.begin());
+		if(!done.insert(rn).second) continue;
+		printf("Exporting calibrations for run %i...\n",rn);
+		try {
+			R->isValid(rn);
+			R->getRunInfo(rn);
+			R->startTime(rn);
+			R->endTime(rn);
+			R->fiducialTime(rn);
+			R->totalTime(rn);
+			RunNum rGMS = R->getGMSRun(rn);
+			if(rGMS && !done.count(rGMS)) todo.insert(rGMS);
+			for(std::vector<std::string>::const_iterator it = sensors.begin(); it != sensors.end(); it++) {
+				delete R->getPedestals(rn,*it);
+				delete R->getPedwidths(rn,*it);
+			}
+			// request everything used to calibrate the run
+			PMTCalibrator PCal(rn,R);
+		} catch(SMExcept& e) {
+			printf("**** Failed exporting calibrations for run %i! ****\n",rn);
+			e.display();
+		}
+	}
+
+	R->write(fname);
+	printf("Wrote %i calibration records for %i runs to '%s'.\n",(int)R->recs.size(),(int)done.size(),fname.c_str());
+	R->recs.clear();
+}
+
+unsigned long long CalDBSnapshot::runDigest(CalDB& src, RunNum rn) {
+	static std::map<RunNum,unsigned long long> digests;
+	static std::recursive_mutex digestLock;
+	std::lock_guard<std::recursive_mutex> lk(digestLock);
+	std::map<RunNum,unsigned long long>::const_iterator it = digests.find(rn);
+	if(it != digests.end()) return it->second;
+
+	// recorder is kept, as in exportRuns; posmap IDs restart from 0, so records are comparable between processes
+	CalDBRecorder* R = new CalDBRecorder(src);
+	RunNum rGMS = 0;
+	try {
+		R->isValid(rn);
+		R->getRunInfo(rn);
+		R->fiducialTime(rn);
+		R->totalTime(rn);
+		rGMS = R->getGMSRun(rn);
+		PMTCalibrator PCal(rn,R);
+	} catch(SMExcept& e) {
+		printf("**** Failed reading calibrations for run %i! ****\n",rn);
+		e.display();
+	}
+
+	// hash records for this run and positioning maps; GMS reference run records are hashed separately,
+	// since its (shared, cached) LinearityCorrector may have been created before this recorder
+	const std::string rtag = "/"+itos(rn);
+	unsigned long long h = hashString(itos(rn));
+	for(std::map<std::string,std::string>::const_iterator rit = R->recs.begin(); rit != R->recs.end(); rit++) {
+		size_t p = rit->first.find('/');
+		bool isRun = p != std::string::npos && !rit->first.compare(p,rtag.size(),rtag) &&
+			(rit->first.size() == p+rtag.size() || rit->first[p+rtag.size()] == '/');
+		if(!isRun && !startsWith(rit->first,"posmap/")) continue;
+		h = hashBytes(rit->first.c_str(),rit->first.size()+1,h);
+		h = hashString(rit->second,h);
+	}
+	R->recs.clear();
+	if(rGMS && rGMS != rn) {
+		unsigned long long hGMS = runDigest(src,rGMS);
+		h = hashBytes(&hGMS,sizeof(hGMS),h);
+	}
+	digests[rn] = h;
+	return h;
+}
+
+//-------------------------------------------
+// snapshot access
+
+CalDB* CalDBSnapshot::getCDB() {
+	static CalDB* CDB = NULL;
+	if(!CDB) {
+		std::string fname = getEnvSafe("UCNA_CALDB_SNAPSHOT","");
+		if(fname.size()) CDB = new CalDBSnapshot(fname);
+		else CDB = CalDBSQL::getCDB();
+	}
+	return CDB;
+}
+
+CalDBSnapshot::CalDBSnapshot(const std::string& fn): fname(fn), mapped(NULL), mapLen(0), nRecs(0) {
+	int fd = open(fname.c_str(),O_RDONLY);
+	if(fd < 0) {
+		SMExcept e("missingFiles");
+		e.insert("fileName",fname);
+		throw(e);
+	}
+	struct stat st;
+	if(!fstat(fd,&st) && st.st_size > 0) {
+		mapLen = st.st_size;
+		mapped = mmap(NULL,mapLen,PROT_READ,MAP_SHARED,fd,0);
+		if(mapped == MAP_FAILED) mapped = NULL;
+	}
+	close(fd);
+	const char* d = (const char*)mapped;
+	const uint64_t hsize = sizeof(snapMagic)+sizeof(uint64_t);
+	if(d && mapLen >= hsize && !memcmp(d,snapMagic,sizeof(snapMagic))) {
+		memcpy(&nRecs,d+sizeof(snapMagic),sizeof(uint64_t));
+		if(nRecs <= (mapLen-hsize)/sizeof(snapIndexEntry)) {
+			printf("Opened calibrations snapshot '%s' with %i records.\n",fname.c_str(),(int)nRecs);
+			return;
+		}
+	}
+	if(mapped) munmap(mapped,mapLen);
+	SMExcept e("badSnapshotFile");
+	e.insert("fileName",fname);
+	throw(e);
+}
+
+CalDBSnapshot::~CalDBSnapshot() {
+	for(std::map<uint32_t,PositioningCorrector*>::iterator it = pcors.begin(); it != pcors.end(); it++)
+		delete it->second;
+	if(mapped) munmap(mapped,mapLen);
+}
+
+const char* CalDBSnapshot::find(const std::string& key, uint32_t& len) const {
+	const char* d = (const char*)mapped;
+	const snapIndexEntry* idx = (const snapIndexEntry*)(d+sizeof(snapMagic)+sizeof(uint64_t));
+	uint64_t lo = 0;
+	uint64_t hi = nRecs;
+	while(lo < hi) {
+		const uint64_t mid = (lo+hi)/2;
+		const snapIndexEntry& e = idx[mid];
+		if(e.keyOff+e.keyLen > mapLen || e.dataOff+e.dataLen > mapLen) {
+			SMExcept x("badSnapshotFile");
+			x.insert("fileName",fname);
+			throw(x);
+		}
+		const size_t n = e.keyLen < key.size() ? e.keyLen : key.size();
+		int c = memcmp(d+e.keyOff,key.data(),n);
+		if(!c) c = (e.keyLen < key.size()) ? -1 : (e.keyLen > key.size() ? 1 : 0);
+		if(!c) {
+			len = e.dataLen;
+			return d+e.dataOff;
+		}
+		if(c < 0) lo = mid+1;
+		else hi = mid;
+	}
+	return NULL;
+}
+
+const char* CalDBSnapshot::require(const std::string& key, uint32_t& len) const {
+	const char* r = find(key,len);
+	if(!r) {
+		SMExcept e("missingSnapshotData");
+		e.insert("key",key);
+		e.insert("fileName",fname);
+		throw(e);
+	}
+	return r;
+}
+
+/// read required record
+#define SNAP_READ(R,key) uint32_t R##_len; const std::string R##_key = key; \
+	SnapReader R(require(R##_key,R##_len),R##_len,R##_key);
+
+PositioningCorrector* CalDBSnapshot::getPosmap(uint32_t pmid) {
+	if(pmid == noObject) return NULL;
+	std::lock_guard<std::mutex> l(pcorLock);
+	std::map<uint32_t,PositioningCorrector*>::iterator it = pcors.find(pmid);
+	if(it != pcors.end()) return it->second;
+
+	SNAP_READ(r,"posmap/"+itos(pmid));
+	std::vector<PosmapInfo> pinf(r.get<uint32_t>());
+	for(std::vector<PosmapInfo>::iterator pit = pinf.begin(); pit != pinf.end(); pit++) {
+		pit->nRings = r.get<uint32_t>();
+		pit->radius = r.get<float>();
+		pit->s = Side(r.get<int32_t>());
+		pit->t = r.get<uint32_t>();
+		pit->signal.resize(r.get<uint32_t>());
+		for(unsigned int i=0; i<pit->signal.size(); i++) pit->signal[i] = r.get<float>();
+		pit->norm.resize(r.get<uint32_t>());
+		for(unsigned int i=0; i<pit->norm.size(); i++) pit->norm[i] = r.get<float>();
+	}
+	PositioningCorrector* PC = new PositioningCorrector();
+	PC->loadData(pinf);
+	if(PositioningCorrector::defaultBakeSpacing > 0)
+		PC->bake();
+	pcors.insert(std::make_pair(pmid,PC));
+	return PC;
+}
+
+bool CalDBSnapshot::isValid(RunNum rn) {
+	uint32_t len;
+	const std::string key = snapKey("valid",rn);
+	const char* d = find(key,len);
+	if(!d) return false;
+	return SnapReader(d,len,key).get<uint8_t>();
+}
+
+TGraph* CalDBSnapshot::getLinearity(RunNum rn, Side s, unsigned int t) { SNAP_READ(r,snapKey("lin",rn,s,t)); return r.getGraph(); }
+
+float CalDBSnapshot::getNoiseWidth(RunNum rn, Side s, unsigned int t) { SNAP_READ(r,snapKey("noisew",rn,s,t)); return r.get<float>(); }
+
+float CalDBSnapshot::getNoiseADC(RunNum rn, Side s, unsigned int t) { SNAP_READ(r,snapKey("noiseadc",rn,s,t)); return r.get<float>(); }
+
+TGraphErrors* CalDBSnapshot::getRunMonitor(RunNum rn, const std::string& sensorName, const std::string& monType, bool centers) {
+	SNAP_READ(r,snapKey(centers?"monc":"monw",rn,sensorName,monType));
+	return r.getGraph();
+}
+
+float CalDBSnapshot::getRunMonitorStart(RunNum rn, const std::string& sensorName, const std::string& monType) {
+	SNAP_READ(r,snapKey("mon0",rn,sensorName,monType));
+	return r.get<float>();
+}
+
+TGraph* CalDBSnapshot::getPedestals(RunNum rn, const std::string& sensorName) { SNAP_READ(r,snapKey("ped",rn,sensorName)); return r.getGraph(); }
+
+TGraph* CalDBSnapshot::getPedwidths(RunNum rn, const std::string& sensorName) { SNAP_READ(r,snapKey("pedw",rn,sensorName)); return r.getGraph(); }
+
+std::string CalDBSnapshot::getName() const { SNAP_READ(r,"name"); return "snapshot of "+r.getStr(); }
+
+RunNum CalDBSnapshot::getGMSRun(RunNum rn) { SNAP_READ(r,snapKey("gms",rn)); return r.get<uint32_t>(); }
+
+void CalDBSnapshot::getGainTweak(RunNum rn, Side s, unsigned int t, float& orig, float& final) {
+	SNAP_READ(r,snapKey("tweak",rn,s,t));
+	orig = r.get<float>();
+	final = r.get<float>();
+}
+
+PositioningCorrector* CalDBSnapshot::getPositioningCorrector(RunNum rn) { SNAP_READ(r,snapKey("pcor",rn)); return getPosmap(r.get<uint32_t>()); }
+
+std::vector<MWPC_Ecal_Spec> CalDBSnapshot::get_MWPC_Ecals(RunNum rn, Side s) {
+	SNAP_READ(r,snapKey("mwpcecal",rn,s));
+	std::vector<MWPC_Ecal_Spec> v(r.get<uint32_t>());
+	for(std::vector<MWPC_Ecal_Spec>::iterator it = v.begin(); it != v.end(); it++) {
+		it->charge_meas = ChargeProxyType(r.get<int32_t>());
+		it->gain_factor = r.get<double>();
+		it->pcorr = getPosmap(r.get<uint32_t>());
+		it->priority = r.get<int32_t>();
+		it->start_run = r.get<uint32_t>();
+		it->end_run = r.get<uint32_t>();
+	}
+	return v;
+}
+
+EfficCurve* CalDBSnapshot::getTrigeff(RunNum rn, Side s, unsigned int t) {
+	SNAP_READ(r,snapKey("trigeff",rn,s,t));
+	if(!r.get<uint8_t>()) return NULL;
+	EfficCurve* C = new EfficCurve();
+	for(unsigned int i=0; i<4; i++)
+		C->params[i] = r.get<double>();
+	return C;
+}
+
+TGraph* CalDBSnapshot::getEvisConversion(RunNum rn, Side s, EventType tp) { SNAP_READ(r,snapKey("evis",rn,s,tp)); return r.getGraph(); }
+
+std::vector<CathSegCalibrator*> CalDBSnapshot::getCathSegCalibrators(RunNum rn, Side s, AxisDirection d) {
+	SNAP_READ(r,snapKey("cathseg",rn,s,d));
+	std::vector<CathSegCalibrator*> v;
+	const uint32_t n = r.get<uint32_t>();
+	for(uint32_t i=0; i<n; i++) {
+		v.push_back(new CathSegCalibrator());
+		v.back()->pos = r.get<double>();
+		v.back()->channel = r.getStr();
+		v.back()->norm = r.get<double>();
+		const uint32_t ng = r.get<uint32_t>();
+		for(uint32_t j=0; j<ng; j++)
+			v.back()->pcoeffs.push_back(r.getGraph());
+	}
+	return v;
+}
+
+std::vector<double> CalDBSnapshot::getCathCCloudGains(RunNum rn, Side s, AxisDirection d) {
+	SNAP_READ(r,snapKey("ccloud",rn,s,d));
+	std::vector<double> v(r.get<uint32_t>());
+	for(std::vector<double>::iterator it = v.begin(); it != v.end(); it++) *it = r.get<double>();
+	return v;
+}
+
+int CalDBSnapshot::startTime(RunNum rn, int t0) { SNAP_READ(r,snapKey("tstart",rn)); return r.get<int32_t>()-t0; }
+
+int CalDBSnapshot::endTime(RunNum rn, int t0) { SNAP_READ(r,snapKey("tend",rn)); return r.get<int32_t>()-t0; }
+
+BlindTime CalDBSnapshot::fiducialTime(RunNum rn) { SNAP_READ(r,snapKey("tfid",rn)); return r.get<BlindTime>(); }
+
+float CalDBSnapshot::totalTime(RunNum rn) { SNAP_READ(r,snapKey("ttot",rn)); return r.get<float>(); }
+
+RunInfo CalDBSnapshot::getRunInfo(RunNum rn) { SNAP_READ(r,snapKey("info",rn)); return r.getRunInfo(); }
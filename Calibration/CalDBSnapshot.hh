@@ -0,0 +1,96 @@
+#ifndef CALDBSNAPSHOT_HH
+#define CALDBSNAPSHOT_HH
+
+#include "CalDB.hh"
+#include <map>
+#include <mutex>
+#include <string>
+#include <vector>
+#include <stdint.h>
+
+/// Read-only CalDB served from a local binary snapshot file, exported in bulk from another CalDB
+/// (normally the SQL server) for a set of runs. The file is memory-mapped and records are located by
+/// binary search on a sorted key index, so opening costs no parsing and lookups need no DB round trips.
+/// Requests not covered by the exported runs throw "missingSnapshotData".
+class CalDBSnapshot: public CalDB, private NoCopy {
+public:
+	/// constructor, opening snapshot file
+	CalDBSnapshot(const std::string& fname);
+	/// destructor
+	virtual ~CalDBSnapshot();
+
+	/// export everything needed to calibrate listed runs (plus their GMS reference runs) from src;
+	/// optionally, include pedestals for additional sensors not used by PMTCalibrator
+	static void exportRuns(CalDB& src, const std::vector<RunNum>& runs, const std::string& fname,
+						   const std::vector<std::string>& sensors = std::vector<std::string>());
+	/// hash of all calibration records used for a run (including its GMS reference run), for dependency tracking
+	static unsigned long long runDigest(CalDB& src, RunNum rn);
+	/// CalDB for analysis: snapshot named by $UCNA_CALDB_SNAPSHOT if set, otherwise CalDBSQL::getCDB()
+	static CalDB* getCDB();
+
+	/// check if valid data available for run
+	virtual bool isValid(RunNum rn);
+	/// get linearity correction data
+	virtual TGraph* getLinearity(RunNum rn, Side s, unsigned int t);
+	/// get noise estimate calibration point ADC width
+	virtual float getNoiseWidth(RunNum rn, Side s, unsigned int t);
+	/// get noise estimate calibration point raw ADC value
+	virtual float getNoiseADC(RunNum rn, Side s, unsigned int t);
+	/// get a run monitor graph
+	virtual TGraphErrors* getRunMonitor(RunNum rn, const std::string& sensorName, const std::string& monType, bool centers = true);
+	/// get initial value for run monitor graph
+	virtual float getRunMonitorStart(RunNum rn, const std::string& sensorName, const std::string& monType);
+	/// get pedestals for named sensor
+	virtual TGraph* getPedestals(RunNum rn, const std::string& sensorName);
+	/// get pedestal widths for named sensor
+	virtual TGraph* getPedwidths(RunNum rn, const std::string& sensorName);
+	/// get Calibrations DB name
+	virtual std::string getName() const;
+	/// get GMS Cal run number
+	virtual RunNum getGMSRun(RunNum rn);
+	/// get GMS gain tweaking factors
+	virtual void getGainTweak(RunNum rn, Side s, unsigned int t, float& orig, float& final);
+	/// get positioning corrector for given run (shared between users; treat as read-only)
+	virtual PositioningCorrector* getPositioningCorrector(RunNum rn);
+	/// get wirechamber calibration methods (sorted by application priority)
+	virtual std::vector<MWPC_Ecal_Spec> get_MWPC_Ecals(RunNum rn, Side s);
+	/// get trigger efficiency function
+	virtual EfficCurve* getTrigeff(RunNum rn, Side s, unsigned int t);
+	/// get E_vis -> E_true parametrization
+	virtual TGraph* getEvisConversion(RunNum rn, Side s, EventType tp);
+	/// get list of cathode segment calibrators (caller is responsible for deletion)
+	virtual std::vector<CathSegCalibrator*> getCathSegCalibrators(RunNum rn, Side s, AxisDirection d);
+	/// get cathode to charge cloud gain factors
+	virtual std::vector<double> getCathCCloudGains(RunNum rn, Side s, AxisDirection d);
+	/// run start time
+	virtual int startTime(RunNum rn, int t0 = 0);
+	/// run end time
+	virtual int endTime(RunNum rn, int t0 = 0);
+	/// run time after cuts, blinded
+	virtual BlindTime fiducialTime(RunNum rn);
+	/// total run time
+	virtual float totalTime(RunNum rn);
+	/// get RunInfo for given run
+	virtual RunInfo getRunInfo(RunNum r);
+
+	/// number of records in snapshot
+	unsigned int getNRecords() const { return nRecs; }
+
+protected:
+	/// locate record for key, returning NULL if absent
+	const char* find(const std::string& key, uint32_t& len) const;
+	/// locate record for key, throwing "missingSnapshotData" if absent
+	const char* require(const std::string& key, uint32_t& len) const;
+	/// get (shared) positioning corrector by snapshot index
+	PositioningCorrector* getPosmap(uint32_t pmid);
+
+	std::string fname;		///< snapshot file name
+	void* mapped;			///< memory-mapped file
+	size_t mapLen;			///< length of mapped region
+	uint64_t nRecs;			///< number of records
+
+	std::map<uint32_t,PositioningCorrector*> pcors;	///< loaded positioning correctors
+	std::mutex pcorLock;							///< lock for loading positioning correctors
+};
+
+#endif
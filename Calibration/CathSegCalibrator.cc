@@ -1,4 +1,5 @@
 #include "CathSegCalibrator.hh"
+#include "SMExcept.hh"
 #include <cmath>
 
 double CathSegCalibrator::adjustPos(double x0, double E) const {
@@ -18,3 +19,65 @@ CathSegCalibrator::~CathSegCalibrator() {
 	for(unsigned int i=0; i<pcoeffs.size(); i++)
 		delete(pcoeffs[i]);
 }
+
+//-------------------------------------------
+
+CathSegCorrection::CathSegCorrection(const CathSegCalibrator& C, unsigned int n, double e1):
+nHarm((C.pcoeffs.size()+1)/2), nE(n), Emax(e1), dE(e1/(n-1)) {
+	smassert(nE >= 2 && Emax > 0 && nHarm <= kMaxCathHarmonics);
+	const unsigned int w = 2*nHarm+1;
+	tbl.resize(nE*w);
+	for(unsigned int j=0; j<nE; j++) {
+		double E = j*dE;
+		double* c = &tbl[j*w];
+		for(unsigned int i=0; i<C.pcoeffs.size(); i++) {
+			unsigned int h = 1+(i/2);
+			double a = C.pcoeffs[i]->Eval(E)/(2*M_PI*h);
+			if(i%2) c[2*h] = a;
+			else { c[2*h-1] = -a; c[0] -= a; }	// constant part of -a*(cos+1)
+		}
+	}
+}
+
+void CathSegCorrection::coeffsAt(double E, double* c) const {
+	const unsigned int w = 2*nHarm+1;
+	double u = (E>0?(E<Emax?E:Emax):0)/dE;
+	unsigned int j = (unsigned int)u;
+	if(j >= nE-1) j = nE-2;
+	u -= j;
+	const double* t0 = &tbl[j*w];
+	const double* t1 = t0+w;
+	for(unsigned int k=0; k<w; k++)
+		c[k] = t0[k] + u*(t1[k]-t0[k]);
+}
+
+double CathSegCorrection::series(const double* c, double x0) const {
+	if(!nHarm) return x0;
+	// one sin/cos pair (combined to sincos by the compiler where available); higher harmonics by recurrence
+	const double s1 = sin(2*M_PI*x0);
+	const double c1 = cos(2*M_PI*x0);
+	// Clenshaw recurrence b_k = a_k + 2cos(theta) b_{k+1} - b_{k+2}, for cosine and sine series together
+	const double tc = 2*c1;
+	double bc1 = 0, bc2 = 0, bs1 = 0, bs2 = 0;
+	for(unsigned int h = nHarm; h >= 1; h--) {
+		double bc = c[2*h-1] + tc*bc1 - bc2;
+		double bs = c[2*h] + tc*bs1 - bs2;
+		bc2 = bc1; bc1 = bc;
+		bs2 = bs1; bs1 = bs;
+	}
+	return x0 + c[0] + (bc1*c1 - bc2) + bs1*s1;
+}
+
+double CathSegCorrection::adjustPos(double x0, double E) const {
+	double c[2*kMaxCathHarmonics+1];
+	coeffsAt(E,c);
+	return series(c,x0);
+}
+
+void CathSegCorrection::adjustPos(unsigned int n, const float* x0, const float* E, float* x) const {
+	double c[2*kMaxCathHarmonics+1];
+	for(unsigned int i=0; i<n; i++) {
+		coeffsAt(E[i],c);
+		x[i] = series(c,x0[i]);
+	}
+}
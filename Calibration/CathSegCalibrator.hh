@@ -22,4 +22,33 @@ public:
 	std::vector<TGraph*> pcoeffs;	///< positioning correction coefficients
 };
 
+/// maximum number of harmonics in compiled cathode position corrections
+#define kMaxCathHarmonics 16
+
+/// Compiled CathSegCalibrator position correction: harmonic coefficients tabulated (pre-scaled) on a shared uniform
+/// energy grid in one contiguous array, with the harmonic series summed by Chebyshev recurrence from a single sin/cos.
+class CathSegCorrection {
+public:
+	/// constructor, tabulating coefficients from calibrator on nE points over [0,Emax]
+	CathSegCorrection(const CathSegCalibrator& C, unsigned int nE = 201, double Emax = 1000);
+	/// adjust position for event with given energy (same as CathSegCalibrator::adjustPos)
+	double adjustPos(double x0, double E) const;
+	/// adjust positions for a block of n events
+	void adjustPos(unsigned int n, const float* x0, const float* E, float* x) const;
+	/// number of harmonics
+	unsigned int getNHarmonics() const { return nHarm; }
+
+protected:
+	/// interpolated coefficients at energy into c[2*nHarm+1]
+	void coeffsAt(double E, double* c) const;
+	/// sum correction series for coefficients c at x0
+	double series(const double* c, double x0) const;
+
+	unsigned int nHarm;		///< number of harmonics n = 1...nHarm
+	unsigned int nE;		///< number of energy grid points
+	double Emax;			///< energy grid upper limit
+	double dE;				///< energy grid spacing
+	std::vector<double> tbl;///< [energy][offset, (cos, sin) for each harmonic], scaled by 1/(2 pi n)
+};
+
 #endif
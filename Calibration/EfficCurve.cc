@@ -1,5 +1,6 @@
 #include "EfficCurve.hh"
 #include "Types.hh"
+#include <cmath>
 
 Double_t poiscdf(const Double_t *x, const Double_t *par) {
 	float w0 = par[2]*par[2];
@@ -101,6 +102,26 @@ double EfficCurve::effic(double x) const {
 	return fancyfish(&x, params);
 }
 
+void EfficTable::tabulate(const EfficCurve* c, double nw, unsigned int npw) {
+	smassert(c);
+	C = c;
+	tbl.clear();
+	double w = C->getWidth();
+	if(!(w > 0) || !(nw > 0) || !npw) return;	// exact evaluation only
+	x0 = C->getThreshold()-nw*w;
+	idx = npw/w;
+	unsigned int n = (unsigned int)(2*nw*npw)+1;
+	for(unsigned int i=0; i<n; i++)
+		tbl.push_back(C->effic(x0+i/idx));
+	// check for flat tails out to a further grid width on each side
+	double x1 = x0+(n-1)/idx;
+	flatBelow = flatAbove = true;
+	for(unsigned int i=1; i<=10; i++) {
+		flatBelow &= fabs(C->effic(x0-i*0.2*nw*w)-tbl.front()) < 1e-7;
+		flatAbove &= fabs(C->effic(x1+i*0.2*nw*w)-tbl.back()) < 1e-7;
+	}
+}
+
 void EfficCurve::invertEffic(TH1F* hIn, float th) {
 	TH1F* hInC = NULL;
 	if(defaultCanvas)
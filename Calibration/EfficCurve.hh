@@ -4,6 +4,7 @@
 #include "OutputManager.hh"
 #include <TH1F.h>
 #include <TGraphAsymmErrors.h>
+#include <vector>
 
 class EfficCurve: public OutputManager {
 public:
@@ -17,11 +18,41 @@ public:
 	virtual void invertEffic(TH1F* hIn, float th=0.25);
 	/// get 50% trigger threshold
 	virtual float getThreshold() const { return params[0]; }
+	/// get width of efficiency transition
+	virtual float getWidth() const { return params[1]; }
 	
 	double params[4];			///< efficiency curve fit parameters
 	TGraphAsymmErrors* gEffic;	///< full curve as TGraph
 };
 
+/// Efficiency curve tabulated on a uniform grid around its threshold, evaluated by linear interpolation.
+/// Outside the grid, end values are used where the curve is flat, otherwise the curve is evaluated directly.
+class EfficTable {
+public:
+	/// constructor
+	EfficTable(): C(NULL), x0(0), idx(0), flatBelow(false), flatAbove(false) {}
+	/// tabulate curve over threshold +/- nw transition widths, with npw points per width
+	void tabulate(const EfficCurve* c, double nw = 40, unsigned int npw = 40);
+	/// efficiency at x
+	double effic(double x) const {
+		if(tbl.empty()) { smassert(C); return C->effic(x); }
+		double u = (x-x0)*idx;
+		if(u < 0) return flatBelow ? tbl.front() : C->effic(x);
+		unsigned int i = (unsigned int)u;
+		if(i+1 >= tbl.size()) return flatAbove ? tbl.back() : C->effic(x);
+		u -= i;
+		return tbl[i] + u*(tbl[i+1]-tbl[i]);
+	}
+
+protected:
+	const EfficCurve* C;		///< tabulated curve
+	double x0;					///< grid start
+	double idx;					///< inverse grid spacing
+	bool flatBelow;				///< whether curve is flat below grid
+	bool flatAbove;				///< whether curve is flat above grid
+	std::vector<double> tbl;	///< tabulated values
+};
+
 /// CDF for poisson function (for trigger efficiency fits)
 Double_t poiscdf(const Double_t *x, const Double_t *par);
 /// Fancier trigger efficiency model
@@ -5,6 +5,89 @@
 #include "SMExcept.hh"
 #include "ManualInfo.hh"
 #include <utility>
+#include <algorithm>
+
+/// time ordering for (time,value) pairs, preserving original order of simultaneous points
+bool earlierPoint(const std::pair<double,double>& a, const std::pair<double,double>& b) { return a.first < b.first; }
+
+void PedHistory::load(const TGraph* g) {
+	smassert(g && g->GetN() > 0);
+	std::vector< std::pair<double,double> > pts;
+	for(int i=0; i<g->GetN(); i++)
+		pts.push_back(std::make_pair(g->GetX()[i],g->GetY()[i]));
+	std::stable_sort(pts.begin(),pts.end(),&earlierPoint);
+	tm.clear();
+	val.clear();
+	for(std::vector< std::pair<double,double> >::const_iterator it = pts.begin(); it != pts.end(); it++) {
+		tm.push_back(it->first);
+		val.push_back(it->second);
+	}
+	cursor = 0;
+}
+
+float PedHistory::eval(double x) {
+	const unsigned int n = tm.size();
+	smassert(n);
+	if(n == 1) return val[0];
+	// re-locate interval only when time leaves the current one (end intervals extend to infinity)
+	if((x < tm[cursor] && cursor) || (x >= tm[cursor+1] && cursor+2 < n)) {
+		if(x >= tm[cursor+1] && (cursor+3 >= n || x < tm[cursor+2])) {
+			cursor++;
+		} else {
+			cursor = std::upper_bound(tm.begin(),tm.end(),x)-tm.begin();
+			cursor = cursor ? cursor-1 : 0;
+			if(cursor > n-2) cursor = n-2;
+		}
+	}
+	const double x0 = tm[cursor];
+	const double x1 = tm[cursor+1];
+	if(x0 == x1) return val[cursor];
+	return val[cursor] + (x-x0)*(val[cursor+1]-val[cursor])/(x1-x0);
+}
+
+//--------------------------------------------------------------------------------------
+
+void PiecewiseLinear::load(const TGraph* g, unsigned int nbins) {
+	smassert(g && g->GetN() > 0 && nbins > 0);
+	std::vector< std::pair<double,double> > pts;
+	for(int i=0; i<g->GetN(); i++)
+		pts.push_back(std::make_pair(g->GetX()[i],g->GetY()[i]));
+	std::stable_sort(pts.begin(),pts.end(),&earlierPoint);
+	
+	knots.clear();
+	y0.clear();
+	slope.clear();
+	binSeg.clear();
+	// segments between successive points; first and last extend to infinity
+	for(unsigned int i=0; i+1<pts.size() || !i; i++) {
+		knots.push_back(pts[i].first);
+		y0.push_back(pts[i].second);
+		if(i+1 >= pts.size() || pts[i+1].first == pts[i].first) slope.push_back(0);
+		else slope.push_back((pts[i+1].second-pts[i].second)/(pts[i+1].first-pts[i].first));
+	}
+	
+	x0 = pts[0].first;
+	double dx = (pts.back().first-x0)/nbins;
+	invdx = dx>0 ? 1./dx : 0;
+	unsigned int i = 0;
+	for(unsigned int b=0; b<nbins; b++) {
+		while(i+1 < knots.size() && x0+b*dx >= knots[i+1]) i++;
+		binSeg.push_back(i);
+	}
+}
+
+double PiecewiseLinear::eval(double x, double* deriv) const {
+	smassert(knots.size());
+	const unsigned int nseg = knots.size();
+	double b = (x-x0)*invdx;
+	unsigned int i = binSeg[b > 0 ? (b < binSeg.size() ? (unsigned int)b : binSeg.size()-1) : 0];
+	while(i+1 < nseg && x >= knots[i+1]) i++;
+	while(i && x < knots[i]) i--;
+	if(deriv) *deriv = slope[i];
+	return y0[i] + slope[i]*(x-knots[i]);
+}
+
+//--------------------------------------------------------------------------------------
 
 PedestalCorrector::~PedestalCorrector() {
 	for(std::map<std::string,TGraph*>::iterator it = pedestals.begin(); it != pedestals.end(); it++)
@@ -54,6 +137,43 @@ void PedestalCorrector::insertPedestal(const std::string& sensorName, TGraph* g)
 		throw(SMExcept("tooFewPoints"));
 	pedestals.erase(sensorName);
 	pedestals.insert(std::make_pair(sensorName,g));
+	std::map<std::string,unsigned int>::const_iterator it = sensorIDs.find(sensorName);
+	if(it != sensorIDs.end())
+		pedTables[it->second].load(g);
+}
+unsigned int PedestalCorrector::getSensorID(const std::string& sensorName) {
+	std::map<std::string,unsigned int>::const_iterator it = sensorIDs.find(sensorName);
+	if(it != sensorIDs.end())
+		return it->second;
+	getPedestal(sensorName,0); // loads pedestal graph or throws
+	unsigned int sid = pedTables.size();
+	pedTables.push_back(PedHistory());
+	pedTables.back().load(pedestals.find(sensorName)->second);
+	pedwTables.push_back(PedHistory());
+	std::map<std::string,TGraph*>::const_iterator itw = pedwidths.find(sensorName);
+	if(itw == pedwidths.end()) {
+		TGraph* tgw = pCDB->getPedwidths(myRun,sensorName);
+		if(tgw) itw = pedwidths.insert(std::make_pair(sensorName,tgw)).first;
+	}
+	if(itw != pedwidths.end())
+		pedwTables.back().load(itw->second);
+	sensorIDs.insert(std::make_pair(sensorName,sid));
+	return sid;
+}
+float PedestalCorrector::getPedwidth(unsigned int sid, float time) {
+	smassert(sid<pedwTables.size());
+	if(!pedwTables[sid].isLoaded()) {
+		SMExcept e("missingPed");
+		e.insert("sensorID",sid);
+		throw(e);
+	}
+	return pedwTables[sid].eval(time);
+}
+void PedestalCorrector::getPedestals(const unsigned int* sids, unsigned int n, float time, float* peds) {
+	for(unsigned int i=0; i<n; i++) {
+		smassert(sids[i]<pedTables.size());
+		peds[i] = pedTables[sids[i]].eval(time);
+	}
 }
 Stringmap PedestalCorrector::getPedSummary(const std::string& sensorName, const std::string& baseKey) const {
 	Stringmap m;
@@ -77,7 +197,7 @@ Stringmap PedestalCorrector::getPedSummary(const std::string& sensorName, const
 
 
 LinearityCorrector::LinearityCorrector(RunNum myRun, CalDB* cdb):
-scaleNoiseWithL(true), P(cdb->getPositioningCorrector(myRun)), GS(NULL), rn(myRun), LCRef(NULL), CDB(cdb) {
+scaleNoiseWithL(true), P(cdb->getPositioningCorrector(myRun)), GS(NULL), rn(myRun), LCRef(NULL), CDB(cdb), gmsTable0(0), gmsTableGS(NULL) {
 	
 	for(Side s = EAST; s <= WEST; ++s)
 		for(unsigned int t=0; t<nBetaTubes; t++)
@@ -102,6 +222,10 @@ scaleNoiseWithL(true), P(cdb->getPositioningCorrector(myRun)), GS(NULL), rn(myRu
 		for(unsigned int t=0; t<nBetaTubes; t++) {
 			linearityFunctions[s][t] = CDB->getLinearity(myRun,s,t);
 			linearityInverses[s][t] = invertGraph(linearityFunctions[s][t]);
+			if(linearityFunctions[s][t]->GetN()) {
+				linKernel[s][t].load(linearityFunctions[s][t]);
+				invKernel[s][t].load(linearityInverses[s][t]);
+			}
 		}
 		
 		if(isRefRun()) {
@@ -135,8 +259,8 @@ LinearityCorrector::~LinearityCorrector() {
 float LinearityCorrector::linearityCorrector(Side s, unsigned int t, float adc, float time) const {
 	smassert(t<=nBetaTubes);
 	if(t<nBetaTubes) {
-		if(linearityFunctions[s][t]->GetN())
-			return linearityFunctions[s][t]->Eval(adc*gmsFactor(s,t,time));
+		if(linKernel[s][t].isLoaded())
+			return linKernel[s][t].eval(adc*gmsFactor(s,t,time));
 		else {
 			smassert(IGNORE_DEAD_DB);
 			return 0;
@@ -145,30 +269,112 @@ float LinearityCorrector::linearityCorrector(Side s, unsigned int t, float adc,
 	return 0; ///< TODO ref linearity PMT?
 }
 float LinearityCorrector::invertLinearityStabilized(Side s, unsigned int t, float l) const {
-	smassert(s<=WEST && t<nBetaTubes && linearityInverses[s][t]);
-	return linearityInverses[s][t]->Eval(l);
+	smassert(s<=WEST && t<nBetaTubes && invKernel[s][t].isLoaded());
+	return invKernel[s][t].eval(l);
 }
 float LinearityCorrector::invertLinearity(Side s, unsigned int t, float l, float time) const {
 	return invertLinearityStabilized(s,t,l)/gmsFactor(s,t,time);
 }
 float LinearityCorrector::dLinearity(Side s, unsigned int t, float adc, float time) const {
-	const float h = 0.1;
-	return (linearityCorrector(s,t,adc+h,time)-linearityCorrector(s,t,adc-h,time))/(2.0*h);
+	if(t>=nBetaTubes || !linKernel[s][t].isLoaded())
+		return 0;
+	const float gms = gmsFactor(s,t,time);
+	double d;
+	linKernel[s][t].eval(adc*gms,&d);
+	return d*gms;
 }
 float LinearityCorrector::dInverse(Side s, unsigned int t, float l, float time) const {
-	const float h = 0.1;
-	return (invertLinearity(s, t, l+h, time)-invertLinearity(s, t, l-h, time))/(2.0*h);
+	smassert(s<=WEST && t<nBetaTubes && invKernel[s][t].isLoaded());
+	double d;
+	invKernel[s][t].eval(l,&d);
+	return d/gmsFactor(s,t,time);
 }
 float_err LinearityCorrector::invertLinearity(Side s, unsigned int t, float_err l, float time) const {
 	return float_err(invertLinearity(s,t,l.x,time),l.err*dInverse(s, t, l.x,time));
 }
 
+/// per-thread GMS factors for the most recently used corrector and time bucket
+/// (correctors from getCachedRun are shared between replay threads)
+struct GMSBucketCache {
+	const LinearityCorrector* LC;		///< corrector for cached values
+	const GainStabilizer* GS;			///< gain stabilizer for cached values
+	RunNum rn;							///< run for cached values
+	int bucket;							///< time bucket for cached values
+	float gms[2][nBetaTubes];			///< cached GMS factors
+};
+static thread_local GMSBucketCache gmsBucketCache = { NULL, NULL, 0, 0, {{0}} };
+
 float LinearityCorrector::gmsFactor(Side s, unsigned int t, float time) const {
-	if(GS)
+	if(!GS)
+		return 1.0;
+	if(!(gmsTimeBucket > 0))
 		return GS->gmsFactor(s,t,time);
-	return 1.0;
+	const int b = (int)floor(time/gmsTimeBucket);
+	// tabulated values are read-only; outside the table, evaluate without touching the cache
+	if(GS == gmsTableGS) {
+		const int i = b-gmsTable0;
+		if(i >= 0 && (unsigned int)i < gmsTable.size()/(2*nBetaTubes))
+			return gmsTable[(i*2+s)*nBetaTubes+t];
+		return GS->gmsFactor(s,t,(b+0.5)*gmsTimeBucket);
+	}
+	// refill this thread's cache for all tubes on entering a new time bucket
+	GMSBucketCache& C = gmsBucketCache;
+	if(C.LC != this || C.GS != GS || C.rn != rn || C.bucket != b) {
+		for(Side s1 = EAST; s1 <= WEST; ++s1)
+			for(unsigned int t1=0; t1<nBetaTubes; t1++)
+				C.gms[s1][t1] = GS->gmsFactor(s1,t1,(b+0.5)*gmsTimeBucket);
+		C.LC = this;
+		C.GS = GS;
+		C.rn = rn;
+		C.bucket = b;
+	}
+	return C.gms[s][t];
+}
+void LinearityCorrector::tabulateGMS(float t0, float t1) {
+	gmsTable.clear();
+	gmsTableGS = NULL;
+	if(!GS || !(gmsTimeBucket > 0) || !(t1 >= t0))
+		return;
+	gmsTable0 = (int)floor(t0/gmsTimeBucket);
+	const int nb = (int)floor(t1/gmsTimeBucket)-gmsTable0+1;
+	for(int b=gmsTable0; b<gmsTable0+nb; b++)
+		for(Side s = EAST; s <= WEST; ++s)
+			for(unsigned int t=0; t<nBetaTubes; t++)
+				gmsTable.push_back(GS->gmsFactor(s,t,(b+0.5)*gmsTimeBucket));
+	gmsTableGS = GS;
+}
+void LinearityCorrector::gmsFactors(Side s, float time, float* gms) const {
+	smassert(s<=WEST);
+	for(unsigned int t=0; t<nBetaTubes; t++)
+		gms[t] = gmsFactor(s,t,time);
+}
+void LinearityCorrector::linearizeSide(Side s, const float* adc, float time, float* l, float* dl) const {
+	float gms[nBetaTubes];
+	gmsFactors(s,time,gms);
+	for(unsigned int t=0; t<nBetaTubes; t++) {
+		if(!linKernel[s][t].isLoaded()) {
+			smassert(IGNORE_DEAD_DB);
+			l[t] = 0;
+			if(dl) dl[t] = 0;
+			continue;
+		}
+		double d;
+		l[t] = linKernel[s][t].eval(adc[t]*gms[t],&d);
+		if(dl) dl[t] = d*gms[t];
+	}
+}
+void LinearityCorrector::invertSide(Side s, const float* l, float time, float* adc, float* dadc) const {
+	float gms[nBetaTubes];
+	gmsFactors(s,time,gms);
+	for(unsigned int t=0; t<nBetaTubes; t++) {
+		smassert(invKernel[s][t].isLoaded());
+		double d;
+		adc[t] = invKernel[s][t].eval(l[t],&d)/gms[t];
+		if(dadc) dadc[t] = d/gms[t];
+	}
 }
 LinearityCorrector* LinearityCorrector::getCachedRun(RunNum r,CalDB* cdb) {
+	std::lock_guard<std::recursive_mutex> lock(cacheLock);
 	std::map<RunNum,LinearityCorrector*>::iterator it = cachedRuns.find(r);
 	if(it!=cachedRuns.end())
 		return it->second;
@@ -178,6 +384,8 @@ LinearityCorrector* LinearityCorrector::getCachedRun(RunNum r,CalDB* cdb) {
 }
 
 std::map<RunNum,LinearityCorrector*> LinearityCorrector::cachedRuns = std::map<RunNum,LinearityCorrector*>();
+std::recursive_mutex LinearityCorrector::cacheLock;
+float LinearityCorrector::gmsTimeBucket = 0;
 
 
 
@@ -318,7 +526,7 @@ void PMTCalibrator::pedSubtract(Side s, float* adc, float time) {
 	for(unsigned int t=0; t<nBetaTubes; t++)
 		adc[t] -= getPedestal(sensorNames[s][t],time);
 }
-void PMTCalibrator::calibrateEnergy(Side s, float x, float y, ScintEvent& evt, float time, float poserr) const {
+void PMTCalibrator::calibrateEnergy(Side s, float x, float y, ScintEvent& evt, float time, float poserr, TRandom* rnd) const {
 	evt.energy.x = evt.energy.err = 0;
 	float weight[nBetaTubes];
 	// count clipped PMTs
@@ -329,7 +537,7 @@ void PMTCalibrator::calibrateEnergy(Side s, float x, float y, ScintEvent& evt, f
 	for(unsigned int t=0; t<nBetaTubes; t++) {
 		
 		float eta0 = eta(s,t,x,y);
-		if(poserr) eta0 *= pcal_random_src.Gaus(1.,poserr);
+		if(poserr) eta0 *= (rnd?rnd:&pcal_random_src)->Gaus(1.,poserr);
 		float l0 = linearityCorrector(s,t,evt.adc[t],time); // tube observed light
 		if(l0 != l0)
 			l0 = 0;
@@ -11,6 +11,44 @@
 #include <map>
 #include <string>
 #include <vector>
+#include <mutex>
+
+/// flattened, time-sorted monitor history for fast sequential evaluation
+class PedHistory {
+public:
+	/// constructor
+	PedHistory(): cursor(0) {}
+	/// load from graph
+	void load(const TGraph* g);
+	/// linear interpolation (or end-point extrapolation) at time x, as TGraph::Eval
+	float eval(double x);
+	/// whether history has been loaded
+	bool isLoaded() const { return tm.size(); }
+	
+	std::vector<double> tm;	///< sample times
+	std::vector<double> val;	///< value at each sample time
+	unsigned int cursor;	///< last-used interval, tm[cursor] <= x < tm[cursor+1]
+};
+
+/// flattened piecewise-linear function (as TGraph::Eval), with uniform-grid segment index for constant-time lookup
+class PiecewiseLinear {
+public:
+	/// constructor
+	PiecewiseLinear(): x0(0), invdx(0) {}
+	/// load from graph, indexing segments on nbins uniform bins
+	void load(const TGraph* g, unsigned int nbins = 1024);
+	/// evaluate at x, optionally returning analytic derivative
+	double eval(double x, double* deriv = NULL) const;
+	/// whether function has been loaded
+	bool isLoaded() const { return knots.size(); }
+	
+	std::vector<double> knots;			///< segment start positions
+	std::vector<double> y0;				///< value at each segment start
+	std::vector<double> slope;			///< slope of each segment
+	std::vector<unsigned int> binSeg;	///< segment containing start of each uniform bin
+	double x0;							///< uniform bins start
+	double invdx;						///< inverse of uniform bin width
+};
 
 /// pedestal subtraction class
 class PedestalCorrector {
@@ -28,6 +66,15 @@ public:
 	/// get pedestal values summary
 	Stringmap getPedSummary(const std::string& sensorName, const std::string& baseKey) const;
 	
+	/// resolve sensor name to integer handle for fast pedestal lookup
+	unsigned int getSensorID(const std::string& sensorName);
+	/// get sensor pedestal at given time by handle
+	float getPedestal(unsigned int sid, float time) { smassert(sid<pedTables.size()); return pedTables[sid].eval(time); }
+	/// get sensor pedestal width at given time by handle
+	float getPedwidth(unsigned int sid, float time);
+	/// get pedestals for n sensor handles at given time
+	void getPedestals(const unsigned int* sids, unsigned int n, float time, float* peds);
+	
 	RunNum myRun;			///< run number for this run
 	float totalTime;		///< run time for this run
 	
@@ -37,6 +84,9 @@ public:
 private:
 	std::map<std::string,TGraph*> pedestals;	///< pedestals history for each sensor
 	std::map<std::string,TGraph*> pedwidths;	///< pedestal width history for each sensor
+	std::map<std::string,unsigned int> sensorIDs;	///< integer handles for sensor names
+	std::vector<PedHistory> pedTables;			///< flattened pedestal history by handle
+	std::vector<PedHistory> pedwTables;			///< flattened pedestal width history by handle
 	CalDB* pCDB;								///< pedestal-containing DB
 };
 
@@ -68,9 +118,19 @@ public:
 	float_err invertLinearity(Side s, unsigned int t, float_err l, float time) const;
 	/// linearity corrector derivative at given adc value
 	float dLinearity(Side s, unsigned int t, float adc, float time) const;	
+	/// linearize all tubes on side, optionally with derivatives dl[t] = dL/dADC
+	void linearizeSide(Side s, const float* adc, float time, float* l, float* dl = NULL) const;
+	/// invert linearity for all tubes on side, optionally with derivatives dadc[t] = dADC/dL
+	void invertSide(Side s, const float* l, float time, float* adc, float* dadc = NULL) const;
+	/// GMS correction factors for all tubes on side
+	void gmsFactors(Side s, float time, float* gms) const;
+	/// tabulate GMS factors for all time buckets in [t0,t1], for lock-free lookup from multiple threads
+	void tabulateGMS(float t0, float t1);
 	
 	/// whether this is a reference run
 	bool isRefRun() const { return rGMS == rn || !rGMS; }
+	
+	static float gmsTimeBucket;		///< optional time bucket width [s] for caching GMS factors (default 0, exact evaluation at every call)
 		
 	bool scaleNoiseWithL;	///< whether to scale noise with sqrt(Light) or sqrt(ADC)
 	
@@ -90,9 +150,16 @@ protected:
 	
 	TGraph* linearityFunctions[2][nBetaTubes];	///< linearity correction for each side, tube (including ref. pmt)
 	TGraph* linearityInverses[2][nBetaTubes];	///< inverse linearity correction for each side, tube
+	PiecewiseLinear linKernel[2][nBetaTubes];	///< flattened linearity correction for each side, tube
+	PiecewiseLinear invKernel[2][nBetaTubes];	///< flattened inverse linearity correction for each side, tube
+	
+	std::vector<float> gmsTable;				///< tabulated GMS factors [bucket][side][tube], from tabulateGMS
+	int gmsTable0;								///< first time bucket in gmsTable
+	const GainStabilizer* gmsTableGS;			///< gain stabilizer used for gmsTable
 	
 	static std::map<RunNum,LinearityCorrector*> cachedRuns;			///< cache of run correctors for faster access
-	static LinearityCorrector* getCachedRun(RunNum r,CalDB* cdb);	///< retrieve a cached corrector, creating if necessary
+	static std::recursive_mutex cacheLock;							///< lock on cachedRuns for multithreaded use
+	static LinearityCorrector* getCachedRun(RunNum r,CalDB* cdb);	///< retrieve a cached corrector, creating if necessary (thread-safe)
 };
 
 /*
@@ -131,8 +198,8 @@ public:
 	float_err invertCorrections(Side s, unsigned int t, float_err e0, float x, float y, float time) const;
 	/// subtract pedestals from 4-tube ADC array (do this before energy calibrations!)
 	void pedSubtract(Side s, float* adc, float time);
-	/// convert all 4 tubes ped-subtracted ADC to energy estimates
-	void calibrateEnergy(Side s, float x, float y, ScintEvent& evt, float time, float poserr = 0) const;	
+	/// convert all 4 tubes ped-subtracted ADC to energy estimates; position response smeared by poserr, drawn from rnd (or shared source if NULL)
+	void calibrateEnergy(Side s, float x, float y, ScintEvent& evt, float time, float poserr = 0, TRandom* rnd = NULL) const;	
 	/// convert all 4 tubes ped-subtracted ADC to energy estimates and return QADC-sum averaged energy (ignores individual tube resolutions)
 	void summedEnergy(Side s, float x, float y, ScintEvent& evt, float time) const;		
 	/// print summary of energy calibrations
@@ -15,6 +15,8 @@ PedestalCorrector(rn,cdb), EvisConverter(rn,cdb), WirechamberCalibrator(rn,cdb)
 		for(unsigned int t=0; t<nBetaTubes; t++) {
 			disablePMT[s][t] = false;
 			pmtEffic[s][t] = CDB->getTrigeff(myRun,s,t);
+			if(pmtEffic[s][t])
+				pmtEfficTbl[s][t].tabulate(pmtEffic[s][t]);
 			clipThreshold[s][t] = 4000;
 			if(checkPedestals(sensorNames[s][t]))
 				clipThreshold[s][t] -= 1.1*getPedestal(sensorNames[s][t],0);
@@ -130,22 +132,49 @@ float PMTCalibrator::trigEff(Side s, unsigned int t, float adc) const {
 }
 
 void PMTCalibrator::pedSubtract(Side s, float* adc, float time) {
+	const unsigned int* sids = pmtPedIDs(s);
 	for(unsigned int t=0; t<nBetaTubes; t++)
-		adc[t] -= getPedestal(sensorNames[s][t],time);
+		adc[t] -= getPedestal(sids[t],time);
+}
+const unsigned int* PMTCalibrator::pmtPedIDs(Side s) {
+	smassert(s<=WEST);
+	if(pmtPedID[s].empty())
+		for(unsigned int t=0; t<nBetaTubes; t++)
+			pmtPedID[s].push_back(getSensorID(sensorNames[s][t]));
+	return &pmtPedID[s][0];
+}
+float PMTCalibrator::anodePedestal(Side s, float time) {
+	smassert(s<=WEST);
+	if(anodePedID[s].empty())
+		anodePedID[s].push_back(getSensorID(sideSubst("MWPC%cAnode",s)));
+	return getPedestal(anodePedID[s][0],time);
 }
-void PMTCalibrator::calibrateEnergy(Side s, float x, float y, ScintEvent& evt, float time, float poserr) const {
+void PMTCalibrator::cathodePedestals(Side s, AxisDirection d, float time, float* peds) {
+	smassert(s<=WEST && d<=Y_DIRECTION);
+	if(cathPedID[s][d].size() != cathNames[s][d].size()) {
+		cathPedID[s][d].clear();
+		for(std::vector<std::string>::const_iterator it = cathNames[s][d].begin(); it != cathNames[s][d].end(); it++)
+			cathPedID[s][d].push_back(getSensorID(*it));
+	}
+	if(cathPedID[s][d].size())
+		getPedestals(&cathPedID[s][d][0],cathPedID[s][d].size(),time,peds);
+}
+void PMTCalibrator::calibrateEnergy(Side s, float x, float y, ScintEvent& evt, float time, float poserr, TRandom* rnd) const {
 	evt.energy.x = evt.energy.err = 0;
 	float weight[nBetaTubes];
 	// count clipped PMTs
 	unsigned int nclipped = 0;
 	for(unsigned int t=0; t<nBetaTubes; t++)
 		nclipped += evt.adc[t]>clipThreshold[s][t]-300;
+	// tube observed light
+	float lights[nBetaTubes];
+	linearizeSide(s,evt.adc,time,lights);
 	
 	for(unsigned int t=0; t<nBetaTubes; t++) {
 		
 		float eta0 = eta(s,t,x,y);
-		if(poserr) eta0 *= pcal_random_src.Gaus(1.,poserr);
-		float l0 = linearityCorrector(s,t,evt.adc[t],time); // tube observed light
+		if(poserr) eta0 *= (rnd?rnd:&pcal_random_src)->Gaus(1.,poserr);
+		float l0 = lights[t];
 		if(l0 != l0)
 			l0 = 0;
 		float E0 = l0/eta0; // tube observed energy keV
@@ -203,6 +232,12 @@ void PMTCalibrator::summedEnergy(Side s, float x, float y, ScintEvent& evt, floa
 float PMTCalibrator::invertCorrections(Side s, unsigned int t, float e0, float x, float y, float time) const {
 	return invertLinearity(s,t,e0*eta(s,t,x,y),time);
 }
+void PMTCalibrator::invertCorrections(Side s, const float* e0, float x, float y, float time, float* adc) const {
+	float l[nBetaTubes];
+	for(unsigned int t=0; t<nBetaTubes; t++)
+		l[t] = e0[t]*eta(s,t,x,y);
+	invertSide(s,l,time,adc);
+}
 float_err PMTCalibrator::invertCorrections(Side s, unsigned int t, float_err e0, float x, float y, float time) const {
 	float_err adc;
 	adc.x = invertCorrections(s,t,e0.x,x,y,time);
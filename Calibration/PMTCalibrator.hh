@@ -31,16 +31,28 @@ public:
 	virtual float eta(Side s, unsigned int t, float x, float y) const { return (t<nBetaTubes)?LinearityCorrector::eta(s,t,x,y):combEta(s,x,y); }
 	/// trigger efficiency at given ADC value for side tube
 	float trigEff(Side s, unsigned int t, float adc) const;
+	/// trigger efficiency from tabulated curve (fast approximation to trigEff)
+	float trigEffFast(Side s, unsigned int t, float adc) const { return pmtEfficTbl[s][t].effic(adc); }
 	/// convert a single PMT ADC readout to an energy with an error estimate
 	float_err calibratedEnergy(Side s, unsigned int t, float x, float y, float adc, float time = 0) const;	
 	/// invert corrections to find raw ADC channel corresponding to specified energy
 	float invertCorrections(Side s, unsigned int t, float e0, float x, float y, float time) const;
 	/// invert corrections with error
 	float_err invertCorrections(Side s, unsigned int t, float_err e0, float x, float y, float time) const;
+	/// invert corrections for all tubes on side, energies e0[t] -> raw ADC adc[t]
+	void invertCorrections(Side s, const float* e0, float x, float y, float time, float* adc) const;
 	/// subtract pedestals from 4-tube ADC array (do this before energy calibrations!)
 	void pedSubtract(Side s, float* adc, float time);
-	/// convert all 4 tubes ped-subtracted ADC to energy estimates
-	void calibrateEnergy(Side s, float x, float y, ScintEvent& evt, float time, float poserr = 0) const;	
+	/// PMT pedestal at given time
+	float pmtPedestal(Side s, unsigned int t, float time) { return getPedestal(pmtPedIDs(s)[t],time); }
+	/// PMT pedestal width at given time
+	float pmtPedwidth(Side s, unsigned int t, float time) { return getPedwidth(pmtPedIDs(s)[t],time); }
+	/// anode pedestal at given time
+	float anodePedestal(Side s, float time);
+	/// fill array with pedestals for all cathodes on side/plane at given time
+	void cathodePedestals(Side s, AxisDirection d, float time, float* peds);
+	/// convert all 4 tubes ped-subtracted ADC to energy estimates; position response smeared by poserr, drawn from rnd (or shared source if NULL)
+	void calibrateEnergy(Side s, float x, float y, ScintEvent& evt, float time, float poserr = 0, TRandom* rnd = NULL) const;	
 	/// convert all 4 tubes ped-subtracted ADC to energy estimates and return QADC-sum averaged energy (ignores individual tube resolutions)
 	void summedEnergy(Side s, float x, float y, ScintEvent& evt, float time) const;		
 	/// print summary of energy calibrations
@@ -51,9 +63,16 @@ public:
 	float getClipThreshold(Side s, unsigned int t) { smassert(s<=WEST && t<nBetaTubes); return clipThreshold[s][t]; }
 	
 protected:
+	/// PMT pedestal handles for side, resolved on first use
+	const unsigned int* pmtPedIDs(Side s);
+	
+	std::vector<unsigned int> pmtPedID[2];		///< PMT pedestal sensor handles [side][tube]
+	std::vector<unsigned int> anodePedID[2];	///< anode pedestal sensor handle [side]
+	std::vector<unsigned int> cathPedID[2][2];	///< cathode pedestal sensor handles [side][plane][wire]
 	
 	float clipThreshold[2][nBetaTubes];		///< threshold to de-weight ADC in tube combination due to "clipping"
 	EfficCurve* pmtEffic[2][nBetaTubes];	///< efficiency curves for each PMT
+	EfficTable pmtEfficTbl[2][nBetaTubes];	///< tabulated efficiency curves for each PMT
 	bool disablePMT[2][nBetaTubes];			///< flags to disable summing PMT into combined result
 };
 
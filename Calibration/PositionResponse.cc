@@ -1,5 +1,6 @@
 #include "PositionResponse.hh"
 #include <stdlib.h>
+#include <math.h>
 
 Stringmap SCtoSM(const SectorCutter& SC) {
 	Stringmap m;
@@ -12,7 +13,8 @@ Stringmap SCtoSM(const SectorCutter& SC) {
 PositioningInterpolator::PositioningInterpolator(const PosmapInfo& PMI,
 	Interpolator* (*phiInterp)(DataSequence*, double, double),
 	Interpolator* (*rInterp)(DataSequence*, double, double)):
-S(PMI.nRings,PMI.radius), sRadial(BC_DERIVCLAMP_ZERO), L((*rInterp)(&sRadial, PMI.radius*(1.0+1.0/(2*PMI.nRings-1.0)), 0)) {
+S(PMI.nRings,PMI.radius), sRadial(BC_DERIVCLAMP_ZERO), L((*rInterp)(&sRadial, PMI.radius*(1.0+1.0/(2*PMI.nRings-1.0)), 0)),
+cubicNest(NULL), linNest(NULL) {
 	
 	smassert(PMI.signal.size() == S.nSectors());
 	smassert(PMI.norm.size() == S.nSectors());
@@ -28,6 +30,24 @@ S(PMI.nRings,PMI.radius), sRadial(BC_DERIVCLAMP_ZERO), L((*rInterp)(&sRadial, PM
 	for(unsigned int i=0; i<S.nSectors(); i++)
 		phiSeqs[S.getRing(i)]->addPoint(PMI.signal[i]/PMI.norm[i]);
 	
+	// equivalent non-virtual interpolators for standard interpolator types
+	const double rScale = PMI.radius*(1.0+1.0/(2*PMI.nRings-1.0));
+	if(phiInterp == &CubiTerpolator::newCubiTerpolator && rInterp == &CubiTerpolator::newCubiTerpolator) {
+		cubicNest = new NestedTerpolator<BC_DERIVCLAMP_ZERO,CubicKernel,BC_CYCLIC,CubicKernel>(rScale, 0);
+		fillNest(*cubicNest, PMI);
+	} else if(phiInterp == &LinTerpolator::newLinTerpolator && rInterp == &LinTerpolator::newLinTerpolator) {
+		linNest = new NestedTerpolator<BC_DERIVCLAMP_ZERO,LinearKernel,BC_CYCLIC,LinearKernel>(rScale, 0);
+		fillNest(*linNest, PMI);
+	}
+}
+
+template<typename NT>
+void PositioningInterpolator::fillNest(NT& N, const PosmapInfo& PMI) const {
+	for(unsigned int n=0; n<PMI.nRings; n++) {
+		N.addRow(2.0*M_PI,M_PI/float(S.getNDivs(n)));
+		for(unsigned int i=S.cumdivs[n]; i<S.cumdivs[n+1]; i++)
+			N.addPoint(PMI.signal[i]/PMI.norm[i]);
+	}
 }
 
 PositioningInterpolator::~PositioningInterpolator() {
@@ -36,21 +56,60 @@ PositioningInterpolator::~PositioningInterpolator() {
 	for(unsigned int i=0; i<phiInterps.size(); i++)
 		delete(phiInterps[i]);
 	delete L;
+	delete cubicNest;
+	delete linNest;
 }
 
 double PositioningInterpolator::eval(double x, double y) {
 	double xp[2] = {sqrt(x*x+y*y),atan2(y,x)};
+	if(cubicNest) return cubicNest->eval(xp[0],xp[1]);
+	if(linNest) return linNest->eval(xp[0],xp[1]);
 	return L->eval(xp);
 }
 
 
+//--------------------------------------------------------------------------------------
+
+bool BakedPosmap::eval(unsigned int t, double x, double y, double& v) const {
+	const double fx = (x-x0)/dx;
+	const double fy = (y-x0)/dx;
+	// keep one point of padding on each side for bicubic neighbors (also rejects NaN)
+	if(!(fx >= 1 && fy >= 1 && fx < n-2 && fy < n-2))
+		return false;
+	const int ix = (int)fx;
+	const int iy = (int)fy;
+	const double u = fx-ix;
+	const double w = fy-iy;
+	const float* p = &z[(t*n+iy)*n+ix];
+	
+	if(!bicubic) {
+		v = (1-w)*((1-u)*p[0]+u*p[1]) + w*((1-u)*p[n]+u*p[n+1]);
+		return true;
+	}
+	
+	// cubic convolution weights, same kernel as CubiTerpolator with A = -0.5
+	const double A = -0.5;
+	const double wx[4] = { A*(1-u)*(1-u)*u, (1-u)*(1-u*((2+A)*u-1)), -u*(A*(1-u)*(1-u)+u*(2*u-3)), A*(1-u)*u*u };
+	const double wy[4] = { A*(1-w)*(1-w)*w, (1-w)*(1-w*((2+A)*w-1)), -w*(A*(1-w)*(1-w)+w*(2*w-3)), A*(1-w)*w*w };
+	p -= n+1;
+	v = 0;
+	for(unsigned int j=0; j<4; j++) {
+		v += wy[j]*(wx[0]*p[0]+wx[1]*p[1]+wx[2]*p[2]+wx[3]*p[3]);
+		p += n;
+	}
+	return true;
+}
+
 //--------------------------------------------------------------------------------------
 
 Interpolator* (*PositioningCorrector::defaultInterpType)(DataSequence*, double, double) = CubiTerpolator::newCubiTerpolator;
+double PositioningCorrector::defaultBakeSpacing = 0;
+double PositioningCorrector::bakeTolerance = 1e-3;
 
 void PositioningCorrector::loadData(const std::vector<PosmapInfo>& indat) {
 	// clear old data
 	deleteInterpolators();
+	unbake();
 	myData = indat;
 	
 	// build interpolators
@@ -65,6 +124,7 @@ void PositioningCorrector::loadData(const std::vector<PosmapInfo>& indat) {
 }
 
 void PositioningCorrector::setNormCenter(double c) {
+	avgNormC = 0;
 	for(Side s = EAST; s <= WEST; ++s) {
 		neta[s].clear();
 		for(unsigned int t=0; t<tubes[s].size(); t++)
@@ -73,6 +133,7 @@ void PositioningCorrector::setNormCenter(double c) {
 }
 
 void PositioningCorrector::setNormAvg(double c) {
+	if(c && c == avgNormC) return;
 	for(Side s = EAST; s <= WEST; ++s) {
 		neta[s].clear();
 		for(unsigned int t=0; t<tubes[s].size(); t++) {
@@ -87,6 +148,7 @@ void PositioningCorrector::setNormAvg(double c) {
 			neta[s].push_back(avg/c);
 		}
 	}
+	avgNormC = c;
 }
 
 void PositioningCorrector::loadData(const QFile& qin) {
@@ -143,7 +205,74 @@ PositioningCorrector::~PositioningCorrector() {
 double PositioningCorrector::eval(Side s, unsigned int t, double x, double y, bool normalize) const {
 	if(s>WEST || t>=tubes[s].size() || !tubes[s][t])
 		return 0;
+	double v;
+	if(!baked[s].n || !baked[s].eval(t,x,y,v))
+		v = evalExact(s,t,x,y);
 	if(normalize)
-		return tubes[s][t]->eval(x,y)/neta[s][t];
-	return tubes[s][t]->eval(x,y);
+		return v/neta[s][t];
+	return v;
+}
+
+double PositioningCorrector::bake(double dx, bool bicubic, double tolerance) {
+	smassert(dx > 0);
+	unbake();
+	for(Side s = EAST; s <= WEST; ++s) {
+		if(!tubes[s].size()) continue;
+		
+		// grid covering largest map radius on this side, plus padding for bicubic neighbors
+		double r = 0;
+		for(unsigned int t=0; t<tubes[s].size(); t++)
+			if(tubes[s][t] && tubes[s][t]->S.r > r) r = tubes[s][t]->S.r;
+		BakedPosmap& B = baked[s];
+		B.dx = dx;
+		B.x0 = -(r+2*dx);
+		B.n = (unsigned int)ceil(-2*B.x0/dx)+1;
+		B.bicubic = bicubic;
+		B.z.resize(tubes[s].size()*B.n*B.n);
+		
+		for(unsigned int t=0; t<tubes[s].size(); t++) {
+			float* p = &B.z[t*B.n*B.n];
+			for(unsigned int iy=0; iy<B.n; iy++)
+				for(unsigned int ix=0; ix<B.n; ix++)
+					*(p++) = tubes[s][t] ? evalExact(s,t,B.x0+ix*dx,B.x0+iy*dx) : 0;
+		}
+	}
+	
+	double maxdev = checkBaked();
+	printf("Baked position maps on %g mm grid (%s): max relative deviation %g\n",dx,bicubic?"bicubic":"bilinear",maxdev);
+	if(maxdev > tolerance) {
+		printf("Warning: baked position map deviation exceeds tolerance %g; using exact interpolators.\n",tolerance);
+		unbake();
+	}
+	return maxdev;
+}
+
+void PositioningCorrector::unbake() {
+	for(Side s = EAST; s <= WEST; ++s)
+		baked[s] = BakedPosmap();
+}
+
+double PositioningCorrector::checkBaked() const {
+	double maxdev = 0;
+	for(Side s = EAST; s <= WEST; ++s) {
+		const BakedPosmap& B = baked[s];
+		if(!B.n) continue;
+		for(unsigned int t=0; t<tubes[s].size(); t++) {
+			if(!tubes[s][t]) continue;
+			const double r = tubes[s][t]->S.r;
+			// cell centers are furthest from grid sample points
+			for(unsigned int iy=0; iy+1<B.n; iy++) {
+				const double y = B.x0+(iy+0.5)*B.dx;
+				for(unsigned int ix=0; ix+1<B.n; ix++) {
+					const double x = B.x0+(ix+0.5)*B.dx;
+					double vb;
+					if(x*x+y*y > r*r || !B.eval(t,x,y,vb)) continue;
+					const double ve = evalExact(s,t,x,y);
+					const double dev = fabs(vb-ve)/(fabs(ve) > 1e-6 ? fabs(ve) : 1e-6);
+					if(dev > maxdev) maxdev = dev;
+				}
+			}
+		}
+	}
+	return maxdev;
 }
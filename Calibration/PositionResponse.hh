@@ -43,18 +43,42 @@ public:
 	SectorCutter S;
 	
 protected:	
+	/// fill non-virtual interpolator with input data
+	template<typename NT>
+	void fillNest(NT& N, const PosmapInfo& PMI) const;
+	
 	InterpoSequence sRadial;
 	Interpolator* L;
 	std::vector<DoubleSequence*> phiSeqs;
 	std::vector<Interpolator*> phiInterps;
 	//std::vector<Interpolator*> phiInterps;
+	
+	/// non-virtual equivalent of cubic radial/cubic phi interpolators (NULL for other interpolator types)
+	NestedTerpolator<BC_DERIVCLAMP_ZERO,CubicKernel,BC_CYCLIC,CubicKernel>* cubicNest;
+	/// non-virtual equivalent of linear radial/linear phi interpolators (NULL for other interpolator types)
+	NestedTerpolator<BC_DERIVCLAMP_ZERO,LinearKernel,BC_CYCLIC,LinearKernel>* linNest;
+};
+
+/// position maps for all tubes on one side, pre-sampled onto a Cartesian grid for fast lookup
+class BakedPosmap {
+public:
+	/// constructor
+	BakedPosmap(): n(0), dx(0), x0(0), bicubic(true) {}
+	/// evaluate for tube t at (x,y); return false if outside grid
+	bool eval(unsigned int t, double x, double y, double& v) const;
+	
+	unsigned int n;			///< number of grid points along each axis
+	double dx;				///< grid spacing
+	double x0;				///< grid lower corner position (on both axes)
+	bool bicubic;			///< whether to use bicubic (vs. bilinear) lookup
+	std::vector<float> z;	///< contiguous grid values, indexed [tube][y][x]
 };
 
 /// positioning interpolators for each tube
 class PositioningCorrector: private NoCopy {
 public:
 	/// constructor
-	PositioningCorrector(): interpType(PositioningCorrector::defaultInterpType) { }
+	PositioningCorrector(): interpType(PositioningCorrector::defaultInterpType), avgNormC(0) { }
 	/// destructor
 	~PositioningCorrector();
 	
@@ -71,23 +95,41 @@ public:
 	double eval(Side s, unsigned int t, double x, double y, bool normalize = false) const;
 	/// set normalization to c at center
 	void setNormCenter(double c = 1.0);
-	/// set normalization to average of c
+	/// set normalization to average of c (no-op if already so normalized, so shared correctors are not modified)
 	void setNormAvg(double c = 1.0);
 	
 	/// get number of maps available on side
 	unsigned int getNMaps(Side s) const { smassert(s==EAST||s==WEST); return tubes[s].size(); }
 	
+	/// sample maps onto Cartesian grid with spacing dx for fast evaluation; returns max relative deviation from exact interpolator
+	double bake(double dx = defaultBakeSpacing, bool bicubic = true, double tolerance = bakeTolerance);
+	/// discard baked grids, returning to exact interpolator evaluation
+	void unbake();
+	/// whether baked grid lookup is in use
+	bool isBaked() const { return baked[EAST].n || baked[WEST].n; }
+	/// compare baked grid against exact interpolator at grid cell centers, returning max relative deviation
+	double checkBaked() const;
+	
 	/// interpolation type
 	Interpolator* (*interpType)(DataSequence*, double, double);
 	/// default interpolation type
 	static Interpolator* (*defaultInterpType)(DataSequence*, double, double);
+	/// default baked grid spacing [mm] for correctors loaded from DB (0 to use exact interpolators)
+	static double defaultBakeSpacing;
+	/// maximum relative deviation of baked grid from exact interpolator before falling back to exact evaluation
+	static double bakeTolerance;
 	
 private:
+	/// evaluate exact (un-baked) interpolator
+	double evalExact(Side s, unsigned int t, double x, double y) const { return tubes[s][t]->eval(x,y); }
+
 	/// delete existing interpolators
 	void deleteInterpolators();
 	std::vector<PosmapInfo> myData;					///< position map building data
 	std::vector<PositioningInterpolator*> tubes[2];	///< interpolated position response maps for each tube
 	std::vector<float> neta[2];						///< position map center normalization
+	BakedPosmap baked[2];							///< baked Cartesian grid lookup tables for each side
+	double avgNormC;								///< c for current setNormAvg normalization, 0 otherwise
 };
 
 #endif
@@ -43,7 +43,7 @@ WirechamberCalibrator::WirechamberCalibrator(RunNum rn, CalDB* cdb): sigma(5.90)
 			cath_ccloud_gains[s][d] = cdb->getCathCCloudGains(rn,s,d);
 			cathsegs[s][d] = cdb->getCathSegCalibrators(rn,s,d);
 			nCaths[s][d] = (unsigned int)cathsegs[s][d].size();
-			if(nCaths[s][d] <= 1 || cath_ccloud_gains[s][d].size() < nCaths[s][d]) {
+			if(nCaths[s][d] <= 1 || nCaths[s][d] > kMaxCathodes || cath_ccloud_gains[s][d].size() < nCaths[s][d]) {
 				SMExcept e("missingCathodeCalibrators");
 				e.insert("run",rn);
 				e.insert("side",sideWords(s));
@@ -60,7 +60,10 @@ WirechamberCalibrator::WirechamberCalibrator(RunNum rn, CalDB* cdb): sigma(5.90)
 					cathsegs[s][d][i]->norm = 1.0;
 					cathsegs[s][d][i]->pcoeffs.clear();
 				}
+				cathcorrs[s][d].push_back(CathSegCorrection(*cathsegs[s][d][i]));
 				wirePos[s][d].push_back(cathsegs[s][d][i]->pos);
+				cathNorms[s][d][i] = cathsegs[s][d][i]->norm;
+				cathPos[s][d][i] = cathsegs[s][d][i]->pos;
 				if(i)
 					domains[s][d].push_back(0.5*(wirePos[s][d][i]+wirePos[s][d][i-1]));
 			}
@@ -107,7 +110,7 @@ void WirechamberCalibrator::tweakPosition(Side s, AxisDirection d, wireHit& h, d
 	unsigned int n;
 	float c;
 	toLocal(s,d,h.rawCenter,n,c);
-	h.center = fromLocal(s,d,n,cathsegs[s][d][n]->adjustPos(c,E));
+	h.center = fromLocal(s,d,n,cathcorrs[s][d][n].adjustPos(c,E));
 }
 
 std::vector<std::string> WirechamberCalibrator::getCathChans(Side s, AxisDirection d) const {
@@ -220,14 +223,18 @@ void WirechamberCalibrator::calcDoubletHitPos(wireHit& h, float x0, float x1, fl
 			h.height = exp( pow(log(y1/y0)*sigma0,2)/2 + log(y0*y1)/2 + 1/(8*sigma0*sigma0) );
 }
 
-wireHit WirechamberCalibrator::calcHitPos(Side s, AxisDirection d, const float* cathADC, const float* cathPed) const {
+wireHit WirechamberCalibrator::calcHitPos(Side s, AxisDirection d, const float* cathADC, const float* cathPed, TRandom* rnd) const {
 	
 	smassert(s<=WEST && d<=Y_DIRECTION);
 	const unsigned int nWires = nCaths[s][d];
+	const double* norms = cathNorms[s][d];
+	const float* cpos = cathPos[s][d];
 	float x1,x2,x3,y1,y2,y3;
 	
-	std::vector<float> xs;
-	std::vector<float> ys;
+	// usable (unclipped) wire positions and values
+	float xs[kMaxCathodes];
+	float ys[kMaxCathodes];
+	unsigned int nxs = 0;
 	int maxn = -1;
 	
 	// initialize values in h
@@ -243,32 +250,47 @@ wireHit WirechamberCalibrator::calcHitPos(Side s, AxisDirection d, const float*
 	h.center = h.rawCenter = kUndefinedPosition;
 	
 	float wireValues[kMaxCathodes];
+	int isClipped[kMaxCathodes];
 	
-	for(unsigned int c=0; c<nWires; c++) {
-		// values above 3950 count as "clipped"
-		bool isClipped = (cathADC[c] + (cathPed?cathPed[c]:0)) > 3950;
-		// normalized wire value
-		wireValues[c] = cathADC[c] * cathsegs[s][d][c]->norm;
-		
-		if(isClipped) {
-			h.nClipped++;
-		} else {
-			// record in usable wires
-			xs.push_back(wirePos[s][d][c]);
-			ys.push_back(wireValues[c]);
+	// normalized wire values and clipping flags; values above 3950 count as "clipped"
+	if(cathPed) {
+		for(unsigned int c=0; c<nWires; c++) {
+			wireValues[c] = cathADC[c] * norms[c];
+			isClipped[c] = (cathADC[c] + cathPed[c]) > 3950;
+		}
+	} else {
+		for(unsigned int c=0; c<nWires; c++) {
+			wireValues[c] = cathADC[c] * norms[c];
+			isClipped[c] = cathADC[c] > 3950;
 		}
-		// values above 70 count towards multiplicity
-		if(wireValues[c]>70)
-			h.multiplicity++;
+	}
+	// clipped and above-threshold (70) counts
+	unsigned int nClipped = 0;
+	unsigned int multiplicity = 0;
+	for(unsigned int c=0; c<nWires; c++) {
+		nClipped += isClipped[c];
+		multiplicity += wireValues[c]>70;
+	}
+	h.nClipped = nClipped;
+	h.multiplicity = multiplicity;
+	// summed in wire order (not reassociated) so results match the scalar sum exactly
+	for(unsigned int c=0; c<nWires; c++)
 		h.cathodeSum += wireValues[c];
+	
+	// compact usable wires, locating maximum
+	for(unsigned int c=0; c<nWires; c++) {
+		if(isClipped[c]) continue;
+		xs[nxs] = cpos[c];
+		ys[nxs] = wireValues[c];
+		nxs++;
 		// check if this is the maximum value found so far
-		if(wireValues[c] >= h.maxValue && !isClipped) {
+		if(wireValues[c] >= h.maxValue) {
 			// if wires are tied for max value, randomly choose which is labeled as maxWire
-			if(wireValues[c] == h.maxValue && rand()%2)
+			if(wireValues[c] == h.maxValue && (rnd?rnd->Integer(2):rand()%2))
 				continue;
 			h.maxValue = wireValues[c];
 			h.maxWire = c;
-			maxn = (int)xs.size()-1;
+			maxn = (int)nxs-1;
 		}
 	}
 	
@@ -278,7 +300,7 @@ wireHit WirechamberCalibrator::calcHitPos(Side s, AxisDirection d, const float*
 		h.errflags |= WIRES_MULTICLIP;
 	if(h.maxValue <= 0)
 		h.errflags |= WIRES_NONE;
-	if(maxn==0 || maxn==int(xs.size())-1)
+	if(maxn==0 || maxn==int(nxs)-1)
 		h.errflags |= WIRES_EDGE;
 		
 	//---------------
@@ -286,12 +308,12 @@ wireHit WirechamberCalibrator::calcHitPos(Side s, AxisDirection d, const float*
 	//---------------
 	
 	// no usable wires? There's no hit to reconstruct.
-	if(h.maxValue <= 0 || !xs.size()) {
+	if(h.maxValue <= 0 || !nxs) {
 		h.center = h.width = h.height = 0;
 		return h;
 	}
 	// only one usable wire?
-	if(xs.size()==1) {
+	if(nxs==1) {
 		h.errflags |= WIRES_SINGLET;
 		h.rawCenter = h.center = xs[0];
 		h.height = ys[0];
@@ -379,6 +401,18 @@ wireHit WirechamberCalibrator::calcHitPos(Side s, AxisDirection d, const float*
 	return h;
 }
 
+void WirechamberCalibrator::calcHitPos(unsigned int nEvents, const float* cathADC, const float* cathPed, wireHit* hits, TRandom* rnd) const {
+	const unsigned int nPlanes = BOTH*2;
+	for(unsigned int e=0; e<nEvents; e++) {
+		for(Side s = EAST; s <= WEST; ++s) {
+			for(AxisDirection d = X_DIRECTION; d <= Y_DIRECTION; ++d) {
+				const unsigned int i = e*nPlanes+s*2+d;
+				hits[i] = calcHitPos(s,d,cathADC+i*kMaxCathodes,cathPed?cathPed+i*kMaxCathodes:NULL,rnd);
+			}
+		}
+	}
+}
+
 void WirechamberCalibrator::drawWires(Side s, AxisDirection p, TVirtualPad* C, Int_t color, AxisDirection onAxis) const {
 	smassert(C);
 	smassert(s<=WEST && p<=Y_DIRECTION);
@@ -7,6 +7,7 @@
 #include "PositionResponse.hh"
 #include "CathSegCalibrator.hh"
 #include "ManualInfo.hh"
+#include <TRandom.h>
 #include <vector>
 #include <map>
 
@@ -63,8 +64,11 @@ public:
 	/// get alternate energy calibration method
 	const MWPC_Ecal_Spec& getAltEcal(Side s, ChargeProxyType tp) const;
 	
-	/// calculate hit position from wire values array; optionally, calculate other centering variables
-	wireHit calcHitPos(Side s, AxisDirection d, const float* cathADC, const float* cathPed = NULL) const;
+	/// calculate hit position from wire values array; max wire ties broken with rnd (or rand() if NULL)
+	wireHit calcHitPos(Side s, AxisDirection d, const float* cathADC, const float* cathPed = NULL, TRandom* rnd = NULL) const;
+	/// calculate hit positions for a block of nEvents events on both planes of both sides,
+	/// with cathADC, cathPed laid out as [event][side][plane][kMaxCathodes] and hits as [event][side][plane]
+	void calcHitPos(unsigned int nEvents, const float* cathADC, const float* cathPed, wireHit* hits, TRandom* rnd = NULL) const;
 	
 	/// special case for calculating hit position from two points
 	void calcDoubletHitPos(wireHit& h, float x0, float x1, float y0, float y1) const;
@@ -134,8 +138,11 @@ protected:
 	float mwpcGainCorr[BOTH];										///< gain correction factor for each side
 	float ccloudGainCorr[BOTH];										///< charge cloud method gain correction factor for each side
 	std::vector<CathSegCalibrator*> cathsegs[BOTH][2];				///< cathode segments for each [side][plane]
+	std::vector<CathSegCorrection> cathcorrs[BOTH][2];				///< compiled cathode segment position corrections
 	std::vector<double> wirePos[BOTH][2];							///< cathode wire positions on each plane
 	std::vector<double> domains[BOTH][2];							///< dividing lines between ``domains'' of each wire
+	double cathNorms[BOTH][2][kMaxCathodes];						///< flat copy of cathode normalizations for calcHitPos
+	float cathPos[BOTH][2][kMaxCathodes];							///< flat copy of cathode positions for calcHitPos
 };
 
 
@@ -3,9 +3,11 @@
 #include "PenelopeToPMT.hh"
 #include "CalDBSQL.hh"
 #include "FierzFitter.hh"
+#include "FierzFitEngine.hh"
 
 // ROOT includes
 #include <TH1F.h>
+#include <TH2F.h>
 #include <TLegend.h>
 #include <TF1.h>
 #include <TVirtualFitter.h>
@@ -237,7 +239,7 @@ int main(int argc, char *argv[])
 	// set all expectation values for this range
 	for (int m = 0; m < 3; m++)
 		for (int n = 0; n < 3; n++)
-			expected[m][n] = evaluate_expected_fierz(m, n, min_E, max_E);
+			expected[m][n] = FierzFitEngine::spectrumMoment(m, n, min_E, max_E);
 	
 	// find the predicted inverse covariance matrix for this range
 	double A = -0.12;
@@ -303,6 +305,41 @@ int main(int argc, char *argv[])
 	cout << "    Expected cor(A,b) = " << p_cov[1][0] / p_sig_A / p_sig_b << endl;
 	cout << "    Actual cor(A,b) = " << cov[1][0] / sqrt(cov[0][0] * cov[1][1]) << endl;
 
+	// repeat the fit with precomputed model arrays and analytic gradients
+	const unsigned int nP = FierzFitEngine::FIT_NPARAMS;
+	FierzFitEngine engine(min_E, max_E, 1);
+	engine.setRange(min_E, max_E);
+	engine.setAsymmetryData(asymmetry_energy, asymmetry_values, asymmetry_errors);
+	engine.setRatioData(fierzratio_energy, fierzratio_values, fierzratio_errors, expected[0][1]);
+	double e_p[nP] = { -0.12, 0, 0 };
+	double e_cov[nP*nP];
+	double e_chi2 = engine.fit(e_p, e_cov);
+	double e_sig_A = sqrt(e_cov[FierzFitEngine::FIT_A*nP + FierzFitEngine::FIT_A]);
+	double e_sig_b = sqrt(e_cov[FierzFitEngine::FIT_B*nP + FierzFitEngine::FIT_B]);
+	int e_ndf = engine.nPoints() - engine.nFree();
+
+	cout << endl;
+	cout << " FAST ENGINE FIT:\n";
+	cout << "    A = " << e_p[FierzFitEngine::FIT_A] << " +/- " << e_sig_A << endl;
+	cout << "    b = " << e_p[FierzFitEngine::FIT_B] << " +/- " << e_sig_b << endl;
+	cout << "    cor(A,b) = " << e_cov[FierzFitEngine::FIT_A*nP + FierzFitEngine::FIT_B] / e_sig_A / e_sig_b << endl;
+	cout << "    chi^2 = " << e_chi2 << ", ndf = " << e_ndf << ", chi^2/ndf = " << e_chi2/e_ndf << endl;
+
+	// profile chi^2 over (A,b) for error ellipse contours; grid points at histogram bin centers
+	const unsigned int nScan = 101;
+	double A_lo = e_p[FierzFitEngine::FIT_A] - 4*e_sig_A, A_hi = e_p[FierzFitEngine::FIT_A] + 4*e_sig_A;
+	double b_lo = e_p[FierzFitEngine::FIT_B] - 4*e_sig_b, b_hi = e_p[FierzFitEngine::FIT_B] + 4*e_sig_b;
+	double dA = (A_hi - A_lo)/(nScan-1), db = (b_hi - b_lo)/(nScan-1);
+	vector<double> profile_chi2;
+	engine.profileScan(A_lo, A_hi, nScan, b_lo, b_hi, nScan, profile_chi2);
+	TH2F* profile_histogram = new TH2F("profile_histogram", "#Delta#chi^{2}(A,b);A;b",
+									   nScan, A_lo - dA/2, A_hi + dA/2, nScan, b_lo - db/2, b_hi + db/2);
+	for (unsigned int iA = 0; iA < nScan; iA++)
+		for (unsigned int ib = 0; ib < nScan; ib++)
+			profile_histogram->SetBinContent(iA+1, ib+1, profile_chi2[iA*nScan + ib] - e_chi2);
+	double contour_levels[2] = { 2.30, 6.18 };	// 68% and 95% for 2 parameters
+	profile_histogram->SetContour(2, contour_levels);
+
 	/*
 	// A fit histogram for output to gnuplot
     TH1F *fierz_fit_histogram = new TH1F(*asymmetry_histogram);
@@ -333,11 +370,9 @@ int main(int argc, char *argv[])
 	asymmetry_histogram->Draw();
 	func->SetRange(min_E, max_E);
 	func->DrawCopy("cont1 same");
-	/*
 	c1->cd(2);
-	asymmetry->Draw("lego");
-	func->DrawCopy("surf1 same");
-	*/
+	profile_histogram->SetStats(0);
+	profile_histogram->Draw("cont1");
 	c1->cd(3);
 	func->SetRange(min_E, max_E);
 	fierzratio_histogram->Draw();
@@ -3,6 +3,8 @@
 #include "PenelopeToPMT.hh"
 #include "CalDBSQL.hh"
 #include "FierzFitter.hh"
+#include "FierzFitEngine.hh"
+#include "PathUtils.hh"
 
 // ROOT includes
 #include <TH1F.h>
@@ -105,6 +107,8 @@ class FierzHistogram {
 
 /// ug. needs to be static
 FierzHistogram mc(0,1500,bins);
+/// Monte Carlo response basis (SM and m_e/E-weighted) for fast spectrum fits
+FierzFitEngine mc_basis(0,1500,bins);
 
 /**
  * x[0] : kenetic energy
@@ -422,10 +426,12 @@ void output_histogram(string filename, TH1F* h, double ax, double ay)
 }
 
 
+/// usage: ExtractFierzTerm [Monte Carlo basis output file; default $UCNA_ANA_PLOTS/Fierz/mc_basis.txt]
 int main(int argc, char *argv[]) 
 {
 	TH1::AddDirectory(kFALSE);
-	expected_fierz = evaluate_expected_fierz(min_E, max_E);
+	const std::string mc_basis_filename = argc > 1 ? argv[1] : getEnvSafe("UCNA_ANA_PLOTS")+"/Fierz/mc_basis.txt";
+	expected_fierz = FierzFitEngine::spectrumMoment(0, 1, min_E, max_E);
 	std::cout << "Expected Fierz " << expected_fierz << "\n";
 	
 	// Geant4 MC data scanner object
@@ -542,6 +548,7 @@ int main(int argc, char *argv[])
 			// calculate the energy with a distortion factor
 			double energy = scale_x * G2P.getErecon();
             mc.sm_histogram[s][load]->Fill(energy, 1);
+			mc_basis.addMCEvent(energy, G2P.ePrim);
 
 			tntuple->Fill(s, load, energy);
 
@@ -556,6 +563,9 @@ int main(int argc, char *argv[])
 	std::cout << "Total number of Monte Carlo entries with cuts: " << nSimmed << std::endl;
 	std::cout << "Total number of Monte Carlo entries with cuts: " << nSimmed << std::endl;
 
+	makePath(mc_basis_filename,true);
+	mc_basis.writeBasis(mc_basis_filename);
+
 	tntuple->SetDirectory(mc_tfile);
 	tntuple->Write();
 
@@ -840,6 +850,26 @@ int main(int argc, char *argv[])
     fierz_fit->SetParameter(0,0);
 	fierz_ratio_histogram->Fit(fierz_fit, "Sr");
 
+	// fast fit of the super sum spectrum shape to the Monte Carlo response basis
+	if (super_sum_histogram->GetNbinsX() == bins)
+	{
+		const unsigned int nP = FierzFitEngine::FIT_NPARAMS;
+		vector<double> ss_counts(bins), ss_errors(bins);
+		for (int i = 0; i < bins; i++)
+		{
+			ss_counts[i] = super_sum_histogram->GetBinContent(i+1);
+			ss_errors[i] = super_sum_histogram->GetBinError(i+1);
+		}
+		mc_basis.setRange(min_E, max_E);
+		mc_basis.setSpectrumData(ss_counts, ss_errors);
+		double ss_p[nP] = { 0, 0, 0 };
+		double ss_cov[nP*nP];
+		double ss_chi2 = mc_basis.fit(ss_p, ss_cov);
+		printf("Fast spectrum fit: b = %f +/- %f, chi^2/ndf = %f/%u\n",
+			   ss_p[FierzFitEngine::FIT_B], sqrt(ss_cov[FierzFitEngine::FIT_B*nP + FierzFitEngine::FIT_B]),
+			   ss_chi2, mc_basis.nPoints() - mc_basis.nFree());
+	}
+
 	// A fit histogram for output to gnuplot
     TH1F *fierz_fit_histogram = new TH1F(*super_sum_histogram);
 	for (int i = 0; i < fierz_fit_histogram->GetNbinsX(); i++)
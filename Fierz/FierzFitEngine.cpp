@@ -0,0 +1,366 @@
+#include "FierzFitEngine.hh"
+#include "FierzFitter.hh"
+#include "SMExcept.hh"
+#include <cmath>
+#include <algorithm>
+#include <stdio.h>
+
+double FierzFitEngine::Q = ::Q;
+
+/// plain phase space spectrum shape p E (Q-K)^2
+static double phaseSpace(double K, double Q) {
+	if(K <= 0 || K >= Q) return 0;
+	const double E = K + m_e;
+	return sqrt(E*E - m_e*m_e)*E*(Q-K)*(Q-K);
+}
+
+/// accumulate gradient and Fisher information contributions gc*J, hc*J*J^T
+static inline void addTerm(double* g, double* H, double gc, double hc, const double* J) {
+	for(unsigned int i=0; i<FierzFitEngine::FIT_NPARAMS; i++) {
+		g[i] += gc*J[i];
+		for(unsigned int j=0; j<FierzFitEngine::FIT_NPARAMS; j++)
+			H[i*FierzFitEngine::FIT_NPARAMS+j] += hc*J[i]*J[j];
+	}
+}
+
+/// solve k*k system M x = v in place (v <- x) by Gaussian elimination with partial pivoting; returns false if singular
+static bool solveLinear(unsigned int k, double* M, double* v) {
+	for(unsigned int c=0; c<k; c++) {
+		unsigned int piv = c;
+		for(unsigned int r=c+1; r<k; r++)
+			if(fabs(M[r*k+c]) > fabs(M[piv*k+c])) piv = r;
+		if(!(fabs(M[piv*k+c]) > 0)) return false;
+		if(piv != c) {
+			for(unsigned int j=0; j<k; j++) std::swap(M[c*k+j],M[piv*k+j]);
+			std::swap(v[c],v[piv]);
+		}
+		for(unsigned int r=c+1; r<k; r++) {
+			double f = M[r*k+c]/M[c*k+c];
+			for(unsigned int j=c; j<k; j++) M[r*k+j] -= f*M[c*k+j];
+			v[r] -= f*v[c];
+		}
+	}
+	for(unsigned int c=k; c-- > 0;) {
+		for(unsigned int j=c+1; j<k; j++) v[c] -= M[c*k+j]*v[j];
+		v[c] /= M[c*k+c];
+	}
+	return true;
+}
+
+FierzFitEngine::FierzFitEngine(double E0, double E1, unsigned int nb):
+e0(E0), e1(E1), nBins(nb), S(nb), F(nb), ratioX(0) {
+	smassert(nBins && e1 > e0);
+	for(unsigned int i=0; i<FIT_NPARAMS; i++) fixed[i] = false;
+	setRange(e0,e1);
+}
+
+void FierzFitEngine::setRange(double Emin, double Emax) {
+	emin = Emin;
+	emax = Emax;
+	b0 = nBins;
+	b1 = 0;
+	for(unsigned int i=0; i<nBins; i++) {
+		if(!inRange(binCenter(i))) continue;
+		if(i < b0) b0 = i;
+		b1 = i+1;
+	}
+	if(b1 < b0) b0 = b1;
+}
+
+void FierzFitEngine::clearBasis() {
+	S.assign(nBins,0);
+	F.assign(nBins,0);
+}
+
+void FierzFitEngine::setTheoryBasis() {
+	const unsigned int nsub = 8;
+	const double h = (e1-e0)/nBins/nsub;
+	for(unsigned int i=0; i<nBins; i++) {
+		S[i] = F[i] = 0;
+		// Simpson's rule over bin
+		for(unsigned int j=0; j<=nsub; j++) {
+			double K = e0 + (i*nsub+j)*h;
+			double c = (j==0 || j==nsub)? 1 : (j%2? 4 : 2);
+			double w = c*phaseSpace(K,Q);
+			S[i] += w;
+			F[i] += w*m_e/(K+m_e);
+		}
+		S[i] *= h/3;
+		F[i] *= h/3;
+	}
+}
+
+void FierzFitEngine::addMCEvent(double Erecon, double KEprim, double w) {
+	if(!(Erecon >= e0 && Erecon < e1)) return;
+	unsigned int i = (unsigned int)((Erecon-e0)/(e1-e0)*nBins);
+	if(i >= nBins) return;
+	S[i] += w;
+	F[i] += w*m_e/(KEprim+m_e);
+}
+
+void FierzFitEngine::writeBasis(const std::string& fname) const {
+	FILE* f = fopen(fname.c_str(),"w");
+	if(!f) {
+		SMExcept e("fileUnwriteable");
+		e.insert("fname",fname);
+		throw(e);
+	}
+	fprintf(f,"# FierzFitEngine basis\n%.10g\t%.10g\t%u\n",e0,e1,nBins);
+	for(unsigned int i=0; i<nBins; i++)
+		fprintf(f,"%.12g\t%.12g\n",S[i],F[i]);
+	fclose(f);
+}
+
+bool FierzFitEngine::readBasis(const std::string& fname) {
+	FILE* f = fopen(fname.c_str(),"r");
+	if(!f) return false;
+	double fe0, fe1;
+	unsigned int fnb;
+	bool ok = fscanf(f,"# FierzFitEngine basis %lg %lg %u",&fe0,&fe1,&fnb) == 3 && fnb == nBins
+		&& fabs(fe0-e0) <= 1e-9*(e1-e0) && fabs(fe1-e1) <= 1e-9*(e1-e0);
+	std::vector<double> fS(nBins), fF(nBins);
+	for(unsigned int i=0; ok && i<nBins; i++)
+		ok = fscanf(f,"%lg %lg",&fS[i],&fF[i]) == 2;
+	fclose(f);
+	if(!ok) {
+		printf("Basis file '%s' unreadable or binning mismatch; ignored.\n",fname.c_str());
+		return false;
+	}
+	S = fS;
+	F = fF;
+	return true;
+}
+
+void FierzFitEngine::setAsymmetryData(const std::vector<double>& E, const std::vector<double>& v, const std::vector<double>& err) {
+	smassert(v.size() == E.size() && err.size() == E.size());
+	asymE = E;
+	asymV = v;
+	asymU.resize(E.size());
+	asymW.resize(E.size());
+	for(unsigned int i=0; i<E.size(); i++) {
+		asymU[i] = m_e/(E[i]+m_e);
+		asymW[i] = err[i] > 0 ? 1./(err[i]*err[i]) : 0;
+	}
+}
+
+void FierzFitEngine::setSpectrumData(const std::vector<double>& n, const std::vector<double>& err) {
+	smassert(n.size() == nBins || !n.size());
+	smassert(err.size() == n.size() || !err.size());
+	specN = n;
+	specW.resize(err.size());
+	for(unsigned int i=0; i<err.size(); i++)
+		specW[i] = err[i] > 0 ? 1./(err[i]*err[i]) : 0;
+}
+
+void FierzFitEngine::setRatioData(const std::vector<double>& E, const std::vector<double>& v, const std::vector<double>& err, double xbar) {
+	smassert(v.size() == E.size() && err.size() == E.size());
+	ratioE = E;
+	ratioV = v;
+	ratioX = xbar;
+	ratioU.resize(E.size());
+	ratioW.resize(E.size());
+	for(unsigned int i=0; i<E.size(); i++) {
+		ratioU[i] = m_e/(E[i]+m_e);
+		ratioW[i] = err[i] > 0 ? 1./(err[i]*err[i]) : 0;
+	}
+}
+
+double FierzFitEngine::eval(const double* p, double* g, double* H) const {
+	double gg[FIT_NPARAMS];
+	double HH[FIT_NPARAMS*FIT_NPARAMS];
+	for(unsigned int i=0; i<FIT_NPARAMS; i++) gg[i] = 0;
+	for(unsigned int i=0; i<FIT_NPARAMS*FIT_NPARAMS; i++) HH[i] = 0;
+	const bool wantDerivs = g || H;
+	const double A = p[FIT_A];
+	const double b = p[FIT_B];
+	const double N = p[FIT_N];
+	double c2 = 0;
+	double J[FIT_NPARAMS] = {0,0,0};
+
+	// asymmetry A/(1 + b u)
+	for(unsigned int i=0; i<asymE.size(); i++) {
+		if(!inRange(asymE[i])) continue;
+		const double d = 1./(1.+b*asymU[i]);
+		const double r = asymV[i] - A*d;
+		c2 += r*r*asymW[i];
+		if(!wantDerivs) continue;
+		J[FIT_A] = d;
+		J[FIT_B] = -A*asymU[i]*d*d;
+		J[FIT_N] = 0;
+		addTerm(gg, HH, -2*r*asymW[i], 2*asymW[i], J);
+	}
+
+	// spectrum N (S_i + b F_i)/(Stot + b Ftot)
+	if(specN.size()) {
+		double Stot = 0, Ftot = 0;
+		for(unsigned int i=b0; i<b1; i++) { Stot += S[i]; Ftot += F[i]; }
+		const double D = Stot + b*Ftot;
+		const bool poisson = !specW.size();
+		for(unsigned int i=b0; i<b1; i++) {
+			const double s = (S[i] + b*F[i])/D;
+			const double mu = N*s;
+			double gc, hc;
+			if(poisson) {
+				if(!(mu > 0)) continue;
+				const double n = specN[i];
+				c2 += 2*(mu - n + (n > 0 ? n*log(n/mu) : 0));
+				gc = 2*(1 - n/mu);
+				hc = 2/mu;
+			} else {
+				const double r = specN[i] - mu;
+				c2 += r*r*specW[i];
+				gc = -2*r*specW[i];
+				hc = 2*specW[i];
+			}
+			if(!wantDerivs) continue;
+			J[FIT_A] = 0;
+			J[FIT_B] = N*(F[i] - s*Ftot)/D;
+			J[FIT_N] = s;
+			addTerm(gg, HH, gc, hc, J);
+		}
+	}
+
+	// ratio (1 + b u)/(1 + b xbar)
+	if(ratioE.size()) {
+		const double d = 1./(1.+b*ratioX);
+		for(unsigned int i=0; i<ratioE.size(); i++) {
+			if(!inRange(ratioE[i])) continue;
+			const double r = ratioV[i] - (1.+b*ratioU[i])*d;
+			c2 += r*r*ratioW[i];
+			if(!wantDerivs) continue;
+			J[FIT_A] = 0;
+			J[FIT_B] = (ratioU[i]-ratioX)*d*d;
+			J[FIT_N] = 0;
+			addTerm(gg, HH, -2*r*ratioW[i], 2*ratioW[i], J);
+		}
+	}
+
+	if(g) for(unsigned int i=0; i<FIT_NPARAMS; i++) g[i] = gg[i];
+	if(H) for(unsigned int i=0; i<FIT_NPARAMS*FIT_NPARAMS; i++) H[i] = HH[i];
+	return c2;
+}
+
+bool FierzFitEngine::isFree(unsigned int i) const {
+	if(fixed[i]) return false;
+	if(i == FIT_A) return asymE.size();
+	if(i == FIT_N) return specN.size();
+	return true;
+}
+
+unsigned int FierzFitEngine::nFree() const {
+	unsigned int k = 0;
+	for(unsigned int i=0; i<FIT_NPARAMS; i++) k += isFree(i);
+	return k;
+}
+
+unsigned int FierzFitEngine::nPoints() const {
+	unsigned int n = 0;
+	for(unsigned int i=0; i<asymE.size(); i++) n += inRange(asymE[i]);
+	if(specN.size()) n += b1-b0;
+	for(unsigned int i=0; i<ratioE.size(); i++) n += inRange(ratioE[i]);
+	return n;
+}
+
+double FierzFitEngine::fit(double* p, double* cov) const {
+	unsigned int fp[FIT_NPARAMS];
+	unsigned int k = 0;
+	for(unsigned int i=0; i<FIT_NPARAMS; i++)
+		if(isFree(i)) fp[k++] = i;
+	if(isFree(FIT_N) && !(p[FIT_N] > 0))
+		for(unsigned int i=b0; i<b1; i++) p[FIT_N] += specN[i];
+
+	// Levenberg-Marquardt iteration on Fisher information
+	double g[FIT_NPARAMS], H[FIT_NPARAMS*FIT_NPARAMS];
+	double c2 = eval(p,g,H);
+	double lambda = 1e-3;
+	for(unsigned int it=0; it<200 && k; it++) {
+		double M[FIT_NPARAMS*FIT_NPARAMS], v[FIT_NPARAMS];
+		for(unsigned int i=0; i<k; i++) {
+			v[i] = -g[fp[i]];
+			for(unsigned int j=0; j<k; j++)
+				M[i*k+j] = H[fp[i]*FIT_NPARAMS+fp[j]]*(i==j ? 1+lambda : 1);
+		}
+		if(!solveLinear(k,M,v)) {
+			printf("FierzFitEngine: singular Fisher information; fit stopped.\n");
+			break;
+		}
+		double pt[FIT_NPARAMS], gt[FIT_NPARAMS], Ht[FIT_NPARAMS*FIT_NPARAMS];
+		for(unsigned int i=0; i<FIT_NPARAMS; i++) pt[i] = p[i];
+		for(unsigned int i=0; i<k; i++) pt[fp[i]] += v[i];
+		double c2t = eval(pt,gt,Ht);
+		if(c2t <= c2) {
+			double dc2 = c2 - c2t;
+			for(unsigned int i=0; i<FIT_NPARAMS; i++) { p[i] = pt[i]; g[i] = gt[i]; }
+			for(unsigned int i=0; i<FIT_NPARAMS*FIT_NPARAMS; i++) H[i] = Ht[i];
+			c2 = c2t;
+			lambda *= 0.1;
+			if(dc2 < 1e-10*(1+c2)) break;
+		} else {
+			lambda *= 10;
+			if(lambda > 1e10) break;
+		}
+	}
+
+	if(cov) {
+		// cov = (H/2)^-1 on free parameters, 0 for fixed
+		for(unsigned int i=0; i<FIT_NPARAMS*FIT_NPARAMS; i++) cov[i] = 0;
+		for(unsigned int c=0; c<k; c++) {
+			double M[FIT_NPARAMS*FIT_NPARAMS], v[FIT_NPARAMS];
+			for(unsigned int i=0; i<k; i++) {
+				v[i] = (i==c);
+				for(unsigned int j=0; j<k; j++) M[i*k+j] = 0.5*H[fp[i]*FIT_NPARAMS+fp[j]];
+			}
+			if(!solveLinear(k,M,v)) break;
+			for(unsigned int i=0; i<k; i++) cov[fp[i]*FIT_NPARAMS+fp[c]] = v[i];
+		}
+	}
+	return c2;
+}
+
+double FierzFitEngine::profileN(double b) const {
+	// Poisson: spectrum shape sums to 1 over range, so N = total counts
+	if(!specW.size()) {
+		double n = 0;
+		for(unsigned int i=b0; i<b1; i++) n += specN[i];
+		return n;
+	}
+	double Stot = 0, Ftot = 0;
+	for(unsigned int i=b0; i<b1; i++) { Stot += S[i]; Ftot += F[i]; }
+	const double D = Stot + b*Ftot;
+	double num = 0, den = 0;
+	for(unsigned int i=b0; i<b1; i++) {
+		const double s = (S[i] + b*F[i])/D;
+		num += specN[i]*s*specW[i];
+		den += s*s*specW[i];
+	}
+	return den > 0 ? num/den : 0;
+}
+
+void FierzFitEngine::profileScan(double A0, double A1, unsigned int nA, double bmin, double bmax, unsigned int nb, std::vector<double>& chi2) const {
+	chi2.resize(nA*nb);
+	double p[FIT_NPARAMS];
+	for(unsigned int ib=0; ib<nb; ib++) {
+		p[FIT_B] = nb > 1 ? bmin + ib*(bmax-bmin)/(nb-1) : bmin;
+		p[FIT_N] = specN.size() ? profileN(p[FIT_B]) : 0;
+		for(unsigned int iA=0; iA<nA; iA++) {
+			p[FIT_A] = nA > 1 ? A0 + iA*(A1-A0)/(nA-1) : A0;
+			chi2[iA*nb+ib] = eval(p);
+		}
+	}
+}
+
+double FierzFitEngine::spectrumMoment(double m, double n, double Emin, double Emax, unsigned int npts) {
+	if(npts%2) npts++;
+	const double h = (Emax-Emin)/npts;
+	double s0 = 0, s1 = 0;
+	for(unsigned int j=0; j<=npts; j++) {
+		const double K = Emin + j*h;
+		const double w = ((j==0 || j==npts)? 1 : (j%2? 4 : 2))*phaseSpace(K,Q);
+		if(!w) continue;
+		const double E = K + m_e;
+		const double u = m_e/E;
+		s0 += w;
+		s1 += w*pow(1-u*u,0.5*m)*pow(u,n);
+	}
+	return s0 > 0 ? s1/s0 : 0;
+}
@@ -0,0 +1,106 @@
+#ifndef FIERZFITENGINE_HH
+#define FIERZFITENGINE_HH
+
+#include <vector>
+#include <string>
+
+/// Binned combined fit for asymmetry A, Fierz term b and spectrum normalization N.
+/// Model spectra are precomputed once into contiguous per-bin arrays (standard-model and m_e/E-weighted ``Fierz''
+/// components, from theory or accumulated from Monte Carlo detector response), so that chi^2 (or Poisson likelihood),
+/// its analytic gradient and Fisher information are evaluated in a single pass over the bins.
+/// Three data blocks may be combined, all sharing b:
+///	- asymmetry A(E) = A/(1 + b m_e/E)
+///	- energy spectrum counts N * (S_i + b F_i)/sum_range(S + b F)
+///	- spectrum ratio to Standard Model Monte Carlo (1 + b m_e/E)/(1 + b <m_e/E>)
+class FierzFitEngine {
+public:
+	/// fit parameters
+	enum FitParam {
+		FIT_A,		///< asymmetry A
+		FIT_B,		///< Fierz term b
+		FIT_N,		///< spectrum counts in fit range
+		FIT_NPARAMS	///< number of fit parameters
+	};
+
+	/// constructor, with basis spectrum binning
+	FierzFitEngine(double e0, double e1, unsigned int nb);
+
+	/// set fit energy range (data and basis bins with centers inside range are used)
+	void setRange(double emin, double emax);
+	/// number of basis bins
+	unsigned int getNBins() const { return nBins; }
+	/// basis bin center energy
+	double binCenter(unsigned int i) const { return e0 + (i+0.5)*(e1-e0)/nBins; }
+
+	/// clear basis spectra
+	void clearBasis();
+	/// fill basis spectra from theory (plain phase space, no detector response)
+	void setTheoryBasis();
+	/// accumulate one Monte Carlo event into response basis, by reconstructed energy and primary kinetic energy
+	void addMCEvent(double Erecon, double KEprim, double w = 1.0);
+	/// write basis spectra to text file
+	void writeBasis(const std::string& fname) const;
+	/// read basis spectra from file written by writeBasis; returns false if absent or binning does not match
+	bool readBasis(const std::string& fname);
+	/// Standard Model basis spectrum
+	const std::vector<double>& getSMBasis() const { return S; }
+	/// m_e/E-weighted basis spectrum
+	const std::vector<double>& getFierzBasis() const { return F; }
+
+	/// set asymmetry data points (kinetic energy, value, error)
+	void setAsymmetryData(const std::vector<double>& E, const std::vector<double>& v, const std::vector<double>& err);
+	/// set spectrum data in basis binning; with no errors given, Poisson likelihood is used for (unweighted) counts
+	void setSpectrumData(const std::vector<double>& n, const std::vector<double>& err = std::vector<double>());
+	/// set data/Monte Carlo spectrum ratio points (kinetic energy, value, error), with expected <m_e/E> for normalization
+	void setRatioData(const std::vector<double>& E, const std::vector<double>& v, const std::vector<double>& err, double xbar);
+
+	/// chi^2 (or Poisson deviance) at p[FIT_NPARAMS]; optionally fill gradient g[FIT_NPARAMS] and Fisher information H[FIT_NPARAMS^2]
+	double eval(const double* p, double* g = NULL, double* H = NULL) const;
+	/// minimize from initial guess p (updated to result); fills covariance matrix cov[FIT_NPARAMS^2] if non-NULL; returns chi^2
+	double fit(double* p, double* cov = NULL) const;
+	/// number of data points in fit
+	unsigned int nPoints() const;
+	/// number of parameters free in current fit (those constrained by data and not fixed)
+	unsigned int nFree() const;
+	/// profile chi^2 over (A,b) grid, with normalization minimized at each point; chi2[iA*nb + ib]
+	void profileScan(double A0, double A1, unsigned int nA, double b0, double b1, unsigned int nb, std::vector<double>& chi2) const;
+
+	/// spectrum-weighted <beta^m (m_e/E)^n> over kinetic energy range
+	static double spectrumMoment(double m, double n, double emin, double emax, unsigned int npts = 1234);
+
+	bool fixed[FIT_NPARAMS];	///< parameters to hold fixed in fit
+	static double Q;			///< beta decay endpoint kinetic energy [keV]
+
+protected:
+	/// whether energy is in fit range
+	bool inRange(double E) const { return emin < E && E < emax; }
+	/// whether parameter is free in fit
+	bool isFree(unsigned int i) const;
+	/// normalization minimizing chi^2 at given b
+	double profileN(double b) const;
+
+	double e0;						///< basis lower edge
+	double e1;						///< basis upper edge
+	unsigned int nBins;				///< number of basis bins
+	double emin;					///< fit range lower limit
+	double emax;					///< fit range upper limit
+	unsigned int b0;				///< first basis bin in fit range
+	unsigned int b1;				///< last+1 basis bin in fit range
+
+	std::vector<double> S;			///< Standard Model spectrum basis
+	std::vector<double> F;			///< m_e/E-weighted spectrum basis
+
+	std::vector<double> asymE;		///< asymmetry point energies
+	std::vector<double> asymU;		///< asymmetry point m_e/E
+	std::vector<double> asymV;		///< asymmetry point values
+	std::vector<double> asymW;		///< asymmetry point weights 1/sigma^2
+	std::vector<double> specN;		///< spectrum counts per basis bin
+	std::vector<double> specW;		///< spectrum weights 1/sigma^2 (empty for Poisson)
+	std::vector<double> ratioE;		///< ratio point energies
+	std::vector<double> ratioU;		///< ratio point m_e/E
+	std::vector<double> ratioV;		///< ratio point values
+	std::vector<double> ratioW;		///< ratio point weights 1/sigma^2
+	double ratioX;					///< expected <m_e/E> for ratio normalization
+};
+
+#endif
@@ -64,7 +64,7 @@ int output_histogram(string filename, TH1F* h, double ax, double ay)
 
 
 /// beta spectrum with little b term
-double fierz_beta_spectrum(const double *val, const double *par) 
+inline double fierz_beta_spectrum(const double *val, const double *par) 
 {
 	const double K = val[0];                    /// kinetic energy
 	if (K <= 0 or K >= Q)
@@ -86,7 +86,7 @@ double fierz_beta_spectrum(const double *val, const double *par)
 
 
 /// beta spectrum with expected x^-n and beta^m
-double beta_spectrum(const double *val, const double *par) 
+inline double beta_spectrum(const double *val, const double *par) 
 {
 	const double K = val[0];                    	///< kinetic energy
 	if (K <= 0 or K >= Q)
@@ -108,7 +108,7 @@ double beta_spectrum(const double *val, const double *par)
 
 
 
-double evaluate_expected_fierz(double m, double n, double min, double max, int integral_size = 1234) 
+inline double evaluate_expected_fierz(double m, double n, double min, double max, int integral_size = 1234) 
 {
     TH1D *h1 = new TH1D("beta_spectrum_fierz", "Beta spectrum with Fierz term", integral_size, min, max);
     TH1D *h2 = new TH1D("beta_spectrum", "Beta Spectrum", integral_size, min, max);
@@ -127,14 +127,14 @@ double evaluate_expected_fierz(double m, double n, double min, double max, int i
 
 
 
-double evaluate_expected_fierz(double min, double max, int integral_size = 1234) 
+inline double evaluate_expected_fierz(double min, double max, int integral_size = 1234) 
 {
 	return evaluate_expected_fierz(0, 1, min, max, integral_size);
 }
 
 
 
-void compute_fit(TH1F* histogram, TF1* fierz_fit) 
+inline void compute_fit(TH1F* histogram, TF1* fierz_fit) 
 {
 	// compute chi squared
     double chisq = fierz_fit->GetChisquare();
@@ -167,7 +167,7 @@ void compute_fit(TH1F* histogram, TF1* fierz_fit)
 
 
 
-double asymmetry_fit_func(double *x, double *par)
+inline double asymmetry_fit_func(double *x, double *par)
 {
 	double A = par[0];
 	double b = par[1];
@@ -178,7 +178,7 @@ double asymmetry_fit_func(double *x, double *par)
 
 
 
-double fierzratio_fit_func(double *x, double *par)
+inline double fierzratio_fit_func(double *x, double *par)
 {
 	double b = par[0];
 	double m_e_E = par[1];
@@ -189,7 +189,7 @@ double fierzratio_fit_func(double *x, double *par)
 
 
 
-double GetEntries(TH1F* histogram, double min, double max)
+inline double GetEntries(TH1F* histogram, double min, double max)
 {
 	double entries = histogram->GetEffectiveEntries();
 	double part_int = histogram->Integral(
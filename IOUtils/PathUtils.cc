@@ -8,6 +8,7 @@
 #include <time.h>
 #include <errno.h>
 #include <string.h>
+#include <stdio.h>
 
 bool fileExists(std::string f) {
 	return !system(("test -r '" + f + "'").c_str());
@@ -51,6 +52,29 @@ double fileAge(const std::string& fname) {
 	return timenow - attrib.st_mtime;
 }
 
+bool fileStamp(const std::string& fname, long long& size, long long& mtime) {
+	struct stat attrib;
+	if(stat(fname.c_str(), &attrib)) {
+		size = mtime = 0;
+		return false;
+	}
+	size = attrib.st_size;
+	mtime = attrib.st_mtime;
+	return true;
+}
+
+unsigned long long fileHash(const std::string& fname) {
+	FILE* f = fopen(fname.c_str(),"rb");
+	if(!f) return 0;
+	std::vector<char> buf(1<<20);
+	unsigned long long h = hashBytes(NULL,0);
+	size_t n;
+	while((n = fread(&buf[0],1,buf.size(),f)))
+		h = hashBytes(&buf[0],n,h);
+	fclose(f);
+	return h;
+}
+
 std::vector<std::string> listdir(const std::string& dir, bool includeHidden) {
 	std::vector<std::string> dirs;
 	dirent* entry;
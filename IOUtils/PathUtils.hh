@@ -14,6 +14,10 @@ void makePath(std::string p, bool forFile = false);
 std::vector<std::string> listdir(const std::string& dir, bool includeHidden = false);
 /// get time since last file modification (s)
 double fileAge(const std::string& fname);
+/// get file size (bytes) and modification time (s); return false if unavailable
+bool fileStamp(const std::string& fname, long long& size, long long& mtime);
+/// hash of file contents (0 if unreadable)
+unsigned long long fileHash(const std::string& fname);
 /// get environment variable, with default or fail if missing
 std::string getEnvSafe(const std::string& v, const std::string& dflt = "FAIL_IF_MISSING");
 
@@ -166,3 +166,18 @@ std::vector< std::vector<float> > readArray(std::ifstream& fin, unsigned int min
 	}
 	return a;
 }
+
+unsigned long long hashBytes(const void* d, size_t n, unsigned long long h) {
+	const unsigned char* c = (const unsigned char*)d;
+	for(size_t i=0; i<n; i++) {
+		h ^= c[i];
+		h *= 1099511628211ULL;
+	}
+	return h;
+}
+
+std::string hashToString(unsigned long long h) {
+	char c[24];
+	sprintf(c,"%016llx",h);
+	return std::string(c);
+}
@@ -54,4 +54,11 @@ std::vector<int> sToInts(const std::string& s, const std::string splitchars = ",
 /// read in an array from a file
 std::vector< std::vector<float> > readArray(std::ifstream& fin, unsigned int minitems = 1, const std::string splitchars = ", \t\r\n");
 
+/// 64-bit FNV-1a hash of a block of data, optionally continuing from a previous hash value
+unsigned long long hashBytes(const void* d, size_t n, unsigned long long h = 0xCBF29CE484222325ULL);
+/// 64-bit FNV-1a hash of a string, optionally continuing from a previous hash value
+inline unsigned long long hashString(const std::string& s, unsigned long long h = 0xCBF29CE484222325ULL) { return hashBytes(s.data(),s.size(),h); }
+/// hash value as fixed-width hexadecimal string
+std::string hashToString(unsigned long long h);
+
 #endif
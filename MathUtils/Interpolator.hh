@@ -5,6 +5,7 @@
 #include <vector>
 #include "SMExcept.hh"
 #include <stdio.h>
+#include <stddef.h>
 
 /// boundary conditions for interpolation
 enum BoundaryCondition {
@@ -156,4 +157,161 @@ protected:
 };
 
 
+//--------------------------------------------------------------------------------------
+// Non-virtual interpolators: boundary condition and kernel fixed at compile time, points in contiguous arrays
+
+/// coerce grid index into [0,npts) for boundary condition BC, as DataSequence::coerce (branch resolved at compile time)
+template<BoundaryCondition BC>
+inline unsigned int coerceIndex(int i, int npts) {
+	if(BC == BC_CYCLIC) {
+		if((unsigned int)i < (unsigned int)npts) return i;
+		return i>=0 ? i%npts : ((i%npts)+npts)%npts;
+	} else if(BC == BC_INFINITE) {
+		if(i<=0) return 0;
+		if(i>=npts) return npts-1;
+		return (unsigned int)i;
+	} else if(BC == BC_DERIVCLAMP_ZERO) {
+		if(i<0) return 1;
+		if(i>=npts) return npts-1;
+		return (unsigned int)i;
+	}
+	return 0;
+}
+
+/// floor(l) as int, without library call
+inline int ifloor(double l) { int i = int(l); return i > l ? i-1 : i; }
+
+/// nearest-neighbor interpolation kernel, as Interpolator
+struct NearestKernel {
+	static const unsigned int support = 1;	///< number of points used
+	/// fill weights for grid coordinate l; return index of first point used
+	int weights(double l, double* w) const {
+		int i = ifloor(l);
+		w[0] = 1;
+		return l-i <= 0.5 ? i : i+1;
+	}
+};
+
+/// linear interpolation kernel, as LinTerpolator
+struct LinearKernel {
+	static const unsigned int support = 2;	///< number of points used
+	/// fill weights for grid coordinate l; return index of first point used
+	int weights(double l, double* w) const {
+		int i = ifloor(l);
+		double y = l-i;
+		w[0] = 1-y;
+		w[1] = y;
+		return i;
+	}
+};
+
+/// cubic convolution interpolation kernel, as CubiTerpolator
+struct CubicKernel {
+	/// constructor, with 'sharpening' a
+	CubicKernel(double a = -0.5): A(a) {}
+	static const unsigned int support = 4;	///< number of points used
+	/// fill weights for grid coordinate l; return index of first point used
+	int weights(double l, double* w) const {
+		int i = ifloor(l);
+		double y = l-i;
+		w[0] = A*(1-y)*(1-y)*y;
+		w[1] = (1-y)*(1-y*((2+A)*y-1));
+		w[2] = -y*(A*(1-y)*(1-y)+y*(2*y-3));
+		w[3] = A*(1-y)*y*y;
+		return i-1;
+	}
+	double A;	///< "sharpening" coefficient
+};
+
+/// interpolate npts evenly-spaced points p at grid coordinate l
+template<BoundaryCondition BC, typename Kernel>
+inline double gridInterpolate(const Kernel& K, const double* p, int npts, double l) {
+	if(BC == BC_CYCLIC && !(l >= 0 && l < npts)) l -= npts*ifloor(l/npts);	// fold into one period
+	double w[Kernel::support];
+	int i = K.weights(l,w);
+	double v = 0;
+	if(i >= 0 && i+(int)Kernel::support <= npts) {
+		for(unsigned int k=0; k<Kernel::support; k++)
+			v += w[k]*p[i+k];
+	} else {
+		for(unsigned int k=0; k<Kernel::support; k++)
+			v += w[k]*p[coerceIndex<BC>(i+k,npts)];
+	}
+	return v;
+}
+
+/// non-virtual equivalent of a DoubleSequence with Interpolator subclass
+/// (npts points spanning input length scale s, point 0 at offset o)
+template<BoundaryCondition BC, typename Kernel>
+class GridTerpolator {
+public:
+	/// constructor, with input scale factor s, offset o
+	GridTerpolator(double s = 1.0, double o = 0.0, const Kernel& k = Kernel()): scale(s), offset(o), K(k) {}
+	/// add data point
+	void addPoint(double p) { pts.push_back(p); }
+	/// get number of points
+	int getNpts() const { return pts.size(); }
+	/// evaluate at x
+	double eval(double x) const { return gridInterpolate<BC>(K, &pts[0], pts.size(), (x-offset)*pts.size()/scale); }
+	/// evaluate at n points x, into y
+	void eval(const double* x, double* y, size_t n) const {
+		const double* p = &pts[0];
+		const int npts = pts.size();
+		for(size_t i=0; i<n; i++)
+			y[i] = gridInterpolate<BC>(K, p, npts, (x[i]-offset)*npts/scale);
+	}
+protected:
+	std::vector<double> pts;	///< data points
+	double scale;				///< internal length scale
+	double offset;				///< zero point coordinate offset
+	Kernel K;					///< interpolation kernel
+};
+
+/// non-virtual equivalent of an Interpolator over an InterpoSequence of DoubleSequence Interpolators:
+/// interpolates in x0 between rows, each interpolated in x1; rows may differ in length, scale and offset,
+/// and are stored in one contiguous array
+template<BoundaryCondition BC0, typename K0, BoundaryCondition BC1, typename K1>
+class NestedTerpolator {
+public:
+	/// constructor, with outer input scale factor s, offset o
+	NestedTerpolator(double s = 1.0, double o = 0.0, const K0& k0 = K0(), const K1& k1 = K1()): scale(s), offset(o), Kr(k0), Kp(k1) {}
+	/// start new row, with input scale factor s, offset o
+	void addRow(double s = 1.0, double o = 0.0) { Row r = {(unsigned int)pts.size(), 0, s, o}; rows.push_back(r); }
+	/// add data point to last row
+	void addPoint(double p) { smassert(rows.size()); pts.push_back(p); rows.back().n++; }
+	/// get number of rows
+	int getNRows() const { return rows.size(); }
+	/// evaluate at (x0,x1)
+	double eval(double x0, double x1) const {
+		const int nr = rows.size();
+		double w[K0::support];
+		int i = Kr.weights((x0-offset)*nr/scale,w);
+		double v = 0;
+		for(unsigned int k=0; k<K0::support; k++) {
+			const Row& r = rows[coerceIndex<BC0>(i+k,nr)];
+			v += w[k]*gridInterpolate<BC1>(Kp, &pts[r.start], r.n, (x1-r.offset)*r.n/r.scale);
+		}
+		return v;
+	}
+	/// evaluate at n points (x0,x1), into y
+	void eval(const double* x0, const double* x1, double* y, size_t n) const {
+		for(size_t i=0; i<n; i++)
+			y[i] = eval(x0[i],x1[i]);
+	}
+protected:
+	/// row location and coordinates
+	struct Row {
+		unsigned int start;	///< first point in pts
+		int n;				///< number of points
+		double scale;		///< internal length scale
+		double offset;		///< zero point coordinate offset
+	};
+	std::vector<double> pts;	///< data points for all rows
+	std::vector<Row> rows;		///< rows
+	double scale;				///< outer internal length scale
+	double offset;				///< outer zero point coordinate offset
+	K0 Kr;						///< outer interpolation kernel
+	K1 Kp;						///< row interpolation kernel
+};
+
 #endif
@@ -12,9 +12,64 @@ SectorCutter::SectorCutter(unsigned int N, float R): n(N), r(R) {
 			ndivs.push_back((unsigned int)ceil(2*M_PI*i));
 		cumdivs.push_back(cumdivs[i]+ndivs[i]);
 	}
+	makeRaster();
 }
 
-unsigned int SectorCutter::sector(float x, float y) const {
+void SectorCutter::makeRaster() {
+	raster.clear();
+	nPix = std::min(32*n,(unsigned int)2048);	// ~32 pixels per ring width
+	rPix = (n==1?2*r:r)*1.001;					// cover outer boundary of last ring
+	if(!nPix || !(rPix > 0)) { nPix = 0; rPix = pixScale = 0; return; }
+	pixScale = nPix/(2*rPix);
+	raster.resize(nPix*nPix);
+	
+	const unsigned int straddle = nSectors()+1;
+	const double w = 2*rPix/nPix;
+	const double eps = 1e-3;	// margin on ring and phi division coordinates, and relative pixel size, to absorb rounding
+	for(unsigned int iy=0; iy<nPix; iy++) {
+		for(unsigned int ix=0; ix<nPix; ix++) {
+			double x0 = -rPix+(ix-eps)*w;
+			double x1 = -rPix+(ix+1+eps)*w;
+			double y0 = -rPix+(iy-eps)*w;
+			double y1 = -rPix+(iy+1+eps)*w;
+			
+			// range of ring coordinate over pixel
+			double cx = x0>0?x0:x1<0?x1:0;
+			double cy = y0>0?y0:y1<0?y1:0;
+			double fx = std::max(fabs(x0),fabs(x1));
+			double fy = std::max(fabs(y0),fabs(y1));
+			double rr0 = sqrt(cx*cx+cy*cy)/r*(n-0.5)-eps;
+			double rr1 = sqrt(fx*fx+fy*fy)/r*(n-0.5)+eps;
+			unsigned int rng0 = (n>1 && rr0>=0.5)?(unsigned int)(rr0+0.5):0;
+			unsigned int rng1 = (n>1 && rr1>=0.5)?(unsigned int)(rr1+0.5):0;
+			bool out0 = rng0>=n || (n==1 && rr0>1);
+			bool out1 = rng1>=n || (n==1 && rr1>1);
+			unsigned int& px = raster[iy*nPix+ix];
+			if(out0 && out1) { px = nSectors(); continue; }
+			if(out0 != out1 || rng0 != rng1) { px = straddle; continue; }
+			if(ndivs[rng0]==1) { px = cumdivs[rng0]; continue; }
+			
+			// phi division range over pixel corners, unless crossing phi=0 cut on positive x axis
+			if(y0 <= 0 && y1 >= 0 && x1 > 0) { px = straddle; continue; }
+			double ph0 = ndivs[rng0];
+			double ph1 = 0;
+			for(unsigned int c=0; c<4; c++) {
+				double ph = (atan2(-(c&1?y1:y0),-(c&2?x1:x0))+M_PI)/(2*M_PI)*ndivs[rng0];
+				ph0 = std::min(ph0,ph-eps);
+				ph1 = std::max(ph1,ph+eps);
+			}
+			if(ph0 < 0 || ph1 >= ndivs[rng0] || floor(ph0) != floor(ph1)) { px = straddle; continue; }
+			px = cumdivs[rng0]+(unsigned int)ph0;
+		}
+	}
+}
+
+void SectorCutter::sectors(const float* x, const float* y, unsigned int* out, size_t npts) const {
+	for(size_t i=0; i<npts; i++)
+		out[i] = sector(x[i],y[i]);
+}
+
+unsigned int SectorCutter::sectorExact(float x, float y) const {
 	
 	// which ring this belongs in
 	unsigned int rng = 0;
@@ -2,8 +2,11 @@
 #define SECTORCUTTER_HH
 
 #include <vector>
+#include <stddef.h>
+#include <math.h>
 
-/// class for dividing a circular region into smaller radial/angular patches
+/// class for dividing a circular region into smaller radial/angular patches;
+/// sector lookups use a precomputed pixel ownership raster, with direct calculation only for pixels straddling sector boundaries
 class SectorCutter {
 public:
 	/// constructor
@@ -11,7 +14,19 @@ public:
 	/// return the total number of sectors
 	unsigned int nSectors()  const { return cumdivs[n]; }
 	/// identify sector for a given point
-	unsigned int sector(float x, float y) const;
+	unsigned int sector(float x, float y) const {
+		if(!(fabs(x) < rPix && fabs(y) < rPix)) return sectorExact(x,y);
+		unsigned int ix = (unsigned int)((x+rPix)*pixScale);
+		unsigned int iy = (unsigned int)((y+rPix)*pixScale);
+		if(ix >= nPix) ix = nPix-1;
+		if(iy >= nPix) iy = nPix-1;
+		unsigned int s = raster[iy*nPix+ix];
+		return s <= nSectors() ? s : sectorExact(x,y);
+	}
+	/// identify sector for a given point by direct calculation (identical result to sector)
+	unsigned int sectorExact(float x, float y) const;
+	/// identify sectors for npts points
+	void sectors(const float* x, const float* y, unsigned int* out, size_t npts) const;
 	/// identify the ring of this sector
 	unsigned int getRing(unsigned int s) const;	
 	/// get number of sectors in ring
@@ -35,6 +50,15 @@ public:
 	float r;							///< radius of outermost ring
 	std::vector<unsigned int> ndivs;	///< number of phi divisions in each ring
 	std::vector<unsigned int> cumdivs;	///< cumulative number of divisions in lower rings
+	
+protected:
+	/// fill pixel ownership raster
+	void makeRaster();
+	
+	unsigned int nPix;					///< number of raster pixels along each axis
+	float rPix;							///< raster half-width (points outside are calculated directly)
+	float pixScale;						///< raster pixels per unit length
+	std::vector<unsigned int> raster;	///< sector owning each pixel [iy*nPix+ix]; > nSectors() for pixels straddling boundaries
 };
 
 #endif
@@ -0,0 +1,88 @@
+#include "ReplayThreads.hh"
+#include "SMExcept.hh"
+#include <stdio.h>
+#include <TLeaf.h>
+#include <TObjArray.h>
+
+DBWriteQueue::DBWriteQueue(): busy(false), quit(false) {
+	writer = std::thread(&DBWriteQueue::processQueue,this);
+}
+
+DBWriteQueue::~DBWriteQueue() {
+	{
+		std::lock_guard<std::mutex> l(qLock);
+		quit = true;
+	}
+	qCond.notify_all();
+	writer.join();
+}
+
+void DBWriteQueue::push(const std::function<void()>& f) {
+	{
+		std::lock_guard<std::mutex> l(qLock);
+		tasks.push_back(f);
+	}
+	qCond.notify_all();
+}
+
+void DBWriteQueue::finish() {
+	std::unique_lock<std::mutex> l(qLock);
+	while(tasks.size() || busy)
+		qCond.wait(l);
+	if(err) {
+		std::exception_ptr e = err;
+		err = std::exception_ptr();
+		std::rethrow_exception(e);
+	}
+}
+
+void DBWriteQueue::processQueue() {
+	std::unique_lock<std::mutex> l(qLock);
+	while(true) {
+		while(!tasks.size() && !quit)
+			qCond.wait(l);
+		if(!tasks.size())
+			break;
+		std::function<void()> f = tasks.front();
+		tasks.pop_front();
+		busy = true;
+		l.unlock();
+		std::exception_ptr p;
+		try {
+			f();
+		} catch(...) {
+			// nothing may escape the thread; keep for re-throwing on the main thread
+			printf("*** DB write failed! ***\n");
+			p = std::current_exception();
+			try { std::rethrow_exception(p); }
+			catch(SMExcept& e) { e.display(); }
+			catch(std::exception& e) { printf("\t%s\n",e.what()); }
+			catch(...) { }
+		}
+		l.lock();
+		if(p && !err) err = p;
+		busy = false;
+		qCond.notify_all();
+	}
+}
+
+void TreeDigest::add(TTree* T) {
+	TObjArray* leaves = T->GetListOfLeaves();
+	for(int i=0; i<leaves->GetEntriesFast(); i++) {
+		TLeaf* l = (TLeaf*)leaves->At(i);
+		const unsigned char* p = (const unsigned char*)l->GetValuePointer();
+		if(!p) continue;
+		const size_t nb = l->GetLen()*l->GetLenType();
+		for(size_t j=0; j<nb; j++) {
+			h ^= p[j];
+			h *= 1099511628211ULL;
+		}
+	}
+	n++;
+}
+
+std::string TreeDigest::toString() const {
+	char c[64];
+	sprintf(c,"%u entries, %016llx",n,h);
+	return c;
+}
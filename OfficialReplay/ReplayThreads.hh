@@ -0,0 +1,106 @@
+#ifndef REPLAYTHREADS_HH
+#define REPLAYTHREADS_HH
+
+#include "Types.hh"
+#include <mutex>
+#include <thread>
+#include <condition_variable>
+#include <functional>
+#include <deque>
+#include <exception>
+#include <string>
+#include <TTree.h>
+
+/// scoped lock on an optional mutex (no-op when NULL, for serial replay)
+class OptionalLock: private NoCopy {
+public:
+	/// constructor, locking mutex if provided
+	OptionalLock(std::mutex* m): myLock(m) { if(myLock) myLock->lock(); }
+	/// destructor, releasing lock
+	~OptionalLock() { if(myLock) myLock->unlock(); }
+protected:
+	std::mutex* myLock;	///< mutex held for scope lifetime
+};
+
+/// queue of DB write tasks, executed in order on a single writer thread
+class DBWriteQueue: private NoCopy {
+public:
+	/// constructor, starting writer thread
+	DBWriteQueue();
+	/// destructor, completing all queued tasks
+	~DBWriteQueue();
+	/// add task to end of queue
+	void push(const std::function<void()>& f);
+	/// block until all queued tasks are complete; re-throws the first error from any task since last call
+	void finish();
+	
+protected:
+	/// writer thread loop
+	void processQueue();
+	
+	std::deque< std::function<void()> > tasks;	///< pending tasks
+	bool busy;									///< whether a task is currently executing
+	bool quit;									///< signal writer thread to exit when queue is empty
+	std::mutex qLock;							///< lock on queue state
+	std::condition_variable qCond;				///< queue state change notification
+	std::thread writer;							///< writer thread
+	std::exception_ptr err;						///< first error thrown by a task, for re-throwing in finish()
+};
+
+/// bounded blocking FIFO connecting stages of the event pipeline
+template<typename T>
+class BoundedQueue: private NoCopy {
+public:
+	/// constructor, with maximum number of queued items
+	BoundedQueue(size_t n): nMax(n), closed(false) {}
+	/// add item, blocking while queue is full; returns false (dropping item) if queue was closed
+	bool push(const T& x) {
+		std::unique_lock<std::mutex> l(qLock);
+		while(items.size() >= nMax && !closed)
+			qCond.wait(l);
+		if(closed) return false;
+		items.push_back(x);
+		qCond.notify_all();
+		return true;
+	}
+	/// remove item, blocking while queue is empty; returns false when closed and empty
+	bool pop(T& x) {
+		std::unique_lock<std::mutex> l(qLock);
+		while(!items.size() && !closed)
+			qCond.wait(l);
+		if(!items.size()) return false;
+		x = items.front();
+		items.pop_front();
+		qCond.notify_all();
+		return true;
+	}
+	/// mark end of input, releasing all waiting threads
+	void close() {
+		std::lock_guard<std::mutex> l(qLock);
+		closed = true;
+		qCond.notify_all();
+	}
+	
+protected:
+	size_t nMax;					///< maximum queue length
+	bool closed;					///< whether input has ended
+	std::deque<T> items;			///< queued items
+	std::mutex qLock;				///< lock on queue state
+	std::condition_variable qCond;	///< queue state change notification
+};
+
+/// running digest of the branch contents for each entry filled into a TTree, for comparing replay outputs
+class TreeDigest {
+public:
+	/// constructor
+	TreeDigest(): h(14695981039346656037ULL), n(0) {}
+	/// add current branch contents of T (call after each Fill)
+	void add(TTree* T);
+	/// summary string
+	std::string toString() const;
+	
+	unsigned long long h;	///< FNV-1a hash of all entries
+	unsigned int n;			///< number of entries
+};
+
+#endif
@@ -42,10 +42,9 @@ public:
 			wireHit wirePos[BOTH][2];
 			for(Side s = EAST; s <= WEST; ++s) {
 				for(AxisDirection d = X_DIRECTION; d <= Y_DIRECTION; ++d) {
-					for(unsigned int c=0; c<cathNames[s][d].size(); c++) {
-						cathPeds[c] = PCal.getPedestal(cathNames[s][d][c],fTimeScaler[BOTH]);
+					PCal.cathodePedestals(s,d,fTimeScaler[BOTH],cathPeds);
+					for(unsigned int c=0; c<cathNames[s][d].size(); c++)
 						f_MWPC_caths[s][d][c] = r_MWPC_caths[s][d][c] - cathPeds[c];
-					}
 					wirePos[s][d] = PCal.calcHitPos(s, d, f_MWPC_caths[s][d], cathPeds);
 				}
 				fCathMaxSum[s].val = wirePos[s][X_DIRECTION].maxValue+wirePos[s][Y_DIRECTION].maxValue;
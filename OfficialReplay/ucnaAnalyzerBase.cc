@@ -2,7 +2,7 @@
 
 ucnaAnalyzerBase::ucnaAnalyzerBase(RunNum R, const std::string& bp, const std::string& nm, CalDB* CDB):
 TChainScanner("h1"), OutputManager(nm+"_"+itos(R), bp+"/hists/"), rn(R), PCal(R,CDB),
-fAbsTimeEnd(0), totalTime(0), deltaT(0), ignore_beam_out(false) {
+fAbsTimeEnd(0), totalTime(0), deltaT(0), ignore_beam_out(false), readTarget(this), fillReadCache(false) {
 
 	// beta scintillator TDC timing cuts
 	for(Side s = EAST; s <= WEST; ++s) {
@@ -41,68 +41,119 @@ void ucnaAnalyzerBase::setIgnoreBeamOut(bool ibo) {
 		fBeamclock.R.end = FLT_MAX;
 }
 
+unsigned int ucnaAnalyzerBase::readCacheMB = 2048;
+
+void ucnaAnalyzerBase::startReadCache() {
+	clearReadCache();
+	size_t nmax = size_t(readCacheMB)*1024*1024/sizeof(ucnaReadin);
+	if(!nmax) return;
+	readCache.reserve(nEvents<nmax?nEvents:nmax);
+	fillReadCache = true;
+}
+
+void ucnaAnalyzerBase::clearReadCache() {
+	std::vector<ucnaReadin>().swap(readCache);
+	fillReadCache = false;
+}
+
+void ucnaAnalyzerBase::speedload(unsigned int e) {
+	if(e < readCache.size()) {
+		*readTarget = readCache[e];
+		return;
+	}
+	TChainScanner::speedload(e);
+	if(fillReadCache && e == readCache.size()) {
+		if(readCache.size() < readCache.capacity())
+			readCache.push_back(*readTarget);
+		else {
+			printf("[raw events cache full at %i events] ",e);
+			fillReadCache = false;
+		}
+	}
+}
+
+void ucnaAnalyzerBase::gotoEvent(unsigned int e) {
+	if(e < readCache.size()) {
+		currentEvent = e;
+		*readTarget = readCache[e];
+		return;
+	}
+	TChainScanner::gotoEvent(e);
+}
+
+void ucnaAnalyzerBase::setReadTarget(ucnaReadin* R) {
+	readTarget = R?R:this;
+	setReadpoints();
+}
+
 void ucnaAnalyzerBase::readInTiming() {
-	SetBranchAddress("Sis00",&r_Sis00);				// trigger type flags Sis00
-	SetBranchAddress("Number",&r_TriggerNumber);	// trigger number
-	SetBranchAddress("Clk0",&r_Clk[EAST]);			// E clock
-	SetBranchAddress("Clk1",&r_Clk[WEST]);			// W clock
-	SetBranchAddress("S83028",&r_Clk[BOTH]);		// unblinded runclock
-	SetBranchAddress("S8200",&r_BClk);				// protonClock
-	SetBranchAddress("Delt0",&r_Delt0);				// high resolution delta-t since previous event
-	SetBranchAddress("Time",&r_AbsTime);			// absolute time during run
+	ucnaReadin& R = *readTarget;
+	SetBranchAddress("Sis00",&R.r_Sis00);				// trigger type flags Sis00
+	SetBranchAddress("Number",&R.r_TriggerNumber);	// trigger number
+	SetBranchAddress("Clk0",&R.r_Clk[EAST]);			// E clock
+	SetBranchAddress("Clk1",&R.r_Clk[WEST]);			// W clock
+	SetBranchAddress("S83028",&R.r_Clk[BOTH]);		// unblinded runclock
+	SetBranchAddress("S8200",&R.r_BClk);				// protonClock
+	SetBranchAddress("Delt0",&R.r_Delt0);				// high resolution delta-t since previous event
+	SetBranchAddress("Time",&R.r_AbsTime);			// absolute time during run
 	// PMTs and TDCs, in quadrant order (+x towards SCS, +y up, +z from East to West)
 	const int pmt_tdc_nums[] = {2,3,0,1, 16, 8,9,14,11, 17}; // including 2of4 TDCs 16,17
 	for(Side s = EAST; s <= WEST; ++s)
 		for(unsigned int t=0; t<=nBetaTubes; t++)
-			SetBranchAddress("Tdc0"+itos(pmt_tdc_nums[t+(nBetaTubes+1)*s]),&r_PMTTDC[s][t]);
+			SetBranchAddress("Tdc0"+itos(pmt_tdc_nums[t+(nBetaTubes+1)*s]),&R.r_PMTTDC[s][t]);
 }
 
 void ucnaAnalyzerBase::readInWirechambers() {
+	ucnaReadin& R = *readTarget;
 	const int anode_pdc_nums[] = {30,34};
 	for(Side s = EAST; s<=WEST; ++s) {
 		for(AxisDirection d = X_DIRECTION; d <= Y_DIRECTION; ++d) {
 			cathNames[s][d].clear();
 			std::vector<std::string> cchans = PCal.getCathChans(s,d);
 			for(unsigned int i=0; i<cchans.size(); i++) {
-				SetBranchAddress(cchans[i],&r_MWPC_caths[s][d][i]);
+				SetBranchAddress(cchans[i],&R.r_MWPC_caths[s][d][i]);
 				cathNames[s][d].push_back(sideSubst("MWPC%c",s)+(d==X_DIRECTION?"x":"y")+itos(i+1));
 			}
 		}
-		SetBranchAddress("Pdc"+itos(anode_pdc_nums[s]),&r_MWPC_anode[s]);
+		SetBranchAddress("Pdc"+itos(anode_pdc_nums[s]),&R.r_MWPC_anode[s]);
 	}
 }
 
 void ucnaAnalyzerBase::readInUCNMon() {
+	ucnaReadin& R = *readTarget;
 	const int ucn_mon_adc_nums[kNumUCNMons] = {38,39,310,311};
 	for(unsigned int n=0; n<kNumUCNMons; n++)
-		SetBranchAddress("Pdc"+itos(ucn_mon_adc_nums[n]),&r_MonADC[n]);
+		SetBranchAddress("Pdc"+itos(ucn_mon_adc_nums[n]),&R.r_MonADC[n]);
 }
 
 void ucnaAnalyzerBase::readInPMTADC() {
+	ucnaReadin& R = *readTarget;
 	// PMTs and TDCs, in quadrant order (+x towards SCS, +y up, +z from East to West)
 	const int pmt_adc_nums[] = {2,3,0,1,4,5,6,7};
 	for(Side s = EAST; s <= WEST; ++s)
 		for(unsigned int t=0; t<nBetaTubes; t++)
-			SetBranchAddress("Qadc"+itos(pmt_adc_nums[t+4*s]),&r_PMTADC[s][t]);
+			SetBranchAddress("Qadc"+itos(pmt_adc_nums[t+4*s]),&R.r_PMTADC[s][t]);
 }
 
 void ucnaAnalyzerBase::readInMuonVetos() {
+	ucnaReadin& R = *readTarget;
 	const int back_tdc_nums[] = {18,20};
 	const int back_adc_nums[] = {8,10};
 	const int drift_tac_nums[] = {313,315};
 	for(Side s = EAST; s<=WEST; ++s) {
-		SetBranchAddress("Tdc0"+itos(back_tdc_nums[s]),&r_Backing_TDC[s]);
-		SetBranchAddress("Pdc"+itos(drift_tac_nums[s]),&r_Drift_TAC[s]);
-		SetBranchAddress("Qadc"+itos(back_adc_nums[s]),&r_Backing_ADC[s]);
+		SetBranchAddress("Tdc0"+itos(back_tdc_nums[s]),&R.r_Backing_TDC[s]);
+		SetBranchAddress("Pdc"+itos(drift_tac_nums[s]),&R.r_Drift_TAC[s]);
+		SetBranchAddress("Qadc"+itos(back_adc_nums[s]),&R.r_Backing_ADC[s]);
 	}
-	SetBranchAddress("Tdc019",&r_Top_TDC[EAST]);
-	SetBranchAddress("Qadc9",&r_Top_ADC[EAST]);
+	SetBranchAddress("Tdc019",&R.r_Top_TDC[EAST]);
+	SetBranchAddress("Qadc9",&R.r_Top_ADC[EAST]);
 }
 
 void ucnaAnalyzerBase::readInHeaderChecks() {
+	ucnaReadin& R = *readTarget;
 	for(size_t i=0; i<kNumModules; i++) {
-		SetBranchAddress("Evnb"+itos(i),&r_Evnb[i]);
-		SetBranchAddress("Bkhf"+itos(i),&r_Bkhf[i]);
+		SetBranchAddress("Evnb"+itos(i),&R.r_Evnb[i]);
+		SetBranchAddress("Bkhf"+itos(i),&R.r_Bkhf[i]);
 	}
 }
 
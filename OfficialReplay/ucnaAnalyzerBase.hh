@@ -20,8 +20,30 @@ enum UCN_MON_ID {
 	UCN_MON_SCS = 3
 };
 
+/// raw event variables read in from the input TChain
+struct ucnaReadin {
+	Float_t r_Sis00;							///< Sis00 trigger flags
+	Float_t r_TriggerNumber;					///< event trigger number
+	BlindTime r_Clk;							///< event time blinded clock
+	Float_t r_BClk;								///< proton beam clock
+	Float_t r_Delt0;							///< time since last event
+	Float_t r_AbsTime;							///< absolute time clock
+	Float_t r_PMTADC[BOTH][nBetaTubes];			///< PMT ADCs
+	Float_t r_PMTTDC[BOTH][nBetaTubes+1];		///< PMT TDCs
+	Float_t r_MWPC_caths[BOTH][2][kMaxCathodes];///< cathodes on [side][xplane][wire]
+	Float_t r_MWPC_anode[BOTH];					///< MWPC anode on each side
+	Float_t r_MonADC[kNumUCNMons];				///< UCN monitor ADCs
+	Float_t r_Backing_TDC[BOTH];				///< Backing Veto TDC
+	Float_t r_Drift_TAC[BOTH];					///< Drift tubes TAC
+	Float_t r_Backing_ADC[BOTH];				///< Backing Veto ADC
+	Float_t r_Top_TDC[BOTH];					///< Top Veto TDC (for East only)
+	Float_t r_Top_ADC[BOTH];					///< Top Veto ADC (for East only)
+	Float_t r_Evnb[kNumModules];				///< header and footer counters per module
+	Float_t r_Bkhf[kNumModules];				///< header and footer counters per module
+};
+
 /// new clean-ish re-write of data analyzer; try to be backward compatible with old output tree
-class ucnaAnalyzerBase: public TChainScanner, public OutputManager {
+class ucnaAnalyzerBase: public TChainScanner, public OutputManager, protected ucnaReadin {
 public:
 	/// constructor
 	ucnaAnalyzerBase(RunNum R, const std::string& bp, const std::string& nm, CalDB* CDB);
@@ -40,29 +62,16 @@ public:
 	
 	/// whether event passes beam time cuts (+ manual time cuts)
 	bool passesBeamCuts() const;
+	
+	/// load identified "speed scan" point, from raw events cache if available
+	virtual void speedload(unsigned int e);
+	/// jump scanner to specified event, from raw events cache if available
+	virtual void gotoEvent(unsigned int e);
+	
+	static unsigned int readCacheMB;			///< memory limit [MB] for raw events cache
 		
 protected:
 
-	// read variables
-	Float_t r_Sis00;							///< Sis00 trigger flags
-	Float_t r_TriggerNumber;					///< event trigger number
-	BlindTime r_Clk;							///< event time blinded clock
-	Float_t r_BClk;								///< proton beam clock
-	Float_t r_Delt0;							///< time since last event
-	Float_t r_AbsTime;							///< absolute time clock
-	Float_t r_PMTADC[BOTH][nBetaTubes];			///< PMT ADCs
-	Float_t r_PMTTDC[BOTH][nBetaTubes+1];		///< PMT TDCs
-	Float_t r_MWPC_caths[BOTH][2][kMaxCathodes];///< cathodes on [side][xplane][wire]
-	Float_t r_MWPC_anode[BOTH];					///< MWPC anode on each side
-	Float_t r_MonADC[kNumUCNMons];				///< UCN monitor ADCs
-	Float_t r_Backing_TDC[BOTH];				///< Backing Veto TDC
-	Float_t r_Drift_TAC[BOTH];					///< Drift tubes TAC
-	Float_t r_Backing_ADC[BOTH];				///< Backing Veto ADC
-	Float_t r_Top_TDC[BOTH];					///< Top Veto TDC (for East only)
-	Float_t r_Top_ADC[BOTH];					///< Top Veto ADC (for East only)
-	Float_t r_Evnb[kNumModules];				///< header and footer counters per module
-	Float_t r_Bkhf[kNumModules];				///< header and footer counters per module
-
 	// whole run variables
 	RunNum rn;									///< run number for file being processed
 	PMTCalibrator PCal;							///< PMT Calibrator for this run
@@ -75,6 +84,9 @@ protected:
 	std::vector<std::string> cathNames[BOTH][2];///< cathode sensor names on each [side][xplane]
 
 	bool ignore_beam_out;						///< whether to ignore long beam outages (e.g. for a source run)
+	ucnaReadin* readTarget;						///< destination for input TChain read points (default: this)
+	std::vector<ucnaReadin> readCache;			///< cached raw events, by event number
+	bool fillReadCache;							///< whether to add newly loaded events to readCache
 
 	// event-by-event calibrated variables and cuts
 	int iTriggerNumber;							///< trigger number
@@ -93,6 +105,12 @@ protected:
 	CutVariable fCathMax[BOTH];					///< min(max cathode each plane) for each side
 	CutVariable fCathMaxSum[BOTH];				///< sum of max cathode from each plane for each side
 
+	/// start caching raw events as they are loaded, so later scans need not decompress the input again
+	void startReadCache();
+	/// release raw events cache
+	void clearReadCache();
+	/// redirect input TChain read points to another buffer (NULL for this), e.g. for a separate reader thread
+	void setReadTarget(ucnaReadin* R);
 	/// set to read in timing variables
 	void readInTiming();
 	/// set to read in wirechamber variables
@@ -7,11 +7,15 @@
 #include "SMExcept.hh"
 #include <stdio.h>
 #include <unistd.h>
+#include "CalDBLocked.hh"
+#include "ROOTThreads.hh"
+#include <stdlib.h>
 #include <TStyle.h>
 #include <TDatime.h>
+#include <exception>
 
 ucnaDataAnalyzer11b::ucnaDataAnalyzer11b(RunNum R, std::string bp, CalDB* CDB):
-ucnaAnalyzerBase(R, bp, "spec", CDB), analyzeLED(false), needsPeds(false), colorPlots(true), CDBout(NULL),
+ucnaAnalyzerBase(R, bp, "spec", CDB), analyzeLED(false), needsPeds(false), colorPlots(true), pipelineWorkers(0), digestTrees(false), CDBout(NULL), dbQueue(NULL), serialLock(NULL),
 nLiveTrigs(0), nFailedEvnb(0), nFailedBkhf(0),
 gvMonChecker(5,5.0), prevPassedCuts(true), prevPassedGVRate(true) {
 	plotPath = bp+"/figures/run_"+itos(R)+"/";
@@ -21,21 +25,33 @@ gvMonChecker(5,5.0), prevPassedCuts(true), prevPassedGVRate(true) {
 
 void ucnaDataAnalyzer11b::analyze() {
 	
-	defaultCanvas->cd();
-	
-	loadCuts();
-	setupOutputTree();
+	{
+		OptionalLock L(serialLock);
+		defaultCanvas->cd();
+		loadCuts();
+		setupOutputTree();
+	}
 	
 	pedestalPrePass();
 	printf("\nRun wall time is %.1fs\n\n",wallTime);
-	setupHistograms();
+	{
+		OptionalLock L(serialLock);
+		setupHistograms();
+	}
 	
 	printf("Scanning input data...\n");
-	startScan();
-	nextPoint();	// load data for first event
-	while(processEvent()) continue;
+	posRnd.SetSeed(rn);	// same tie-breaking sequence regardless of other runs on other threads
+	if(pipelineWorkers) {
+		scanPipelined();
+	} else {
+		startScan();
+		nextPoint();	// load data for first event
+		while(processEvent()) continue;
+	}
+	clearReadCache();
 	printf("Done.\n");
 	
+	OptionalLock L(serialLock);
 	processBiPulser();
 	muonVetoAccidentals();
 	calcTrigEffic();
@@ -134,13 +150,12 @@ void ucnaDataAnalyzer11b::reconstructPosition() {
 	float cathPeds[kMaxCathodes];
 	for(Side s = EAST; s <= WEST; ++s) {
 		for(AxisDirection d = X_DIRECTION; d <= Y_DIRECTION; ++d) {
-			for(unsigned int c=0; c<cathNames[s][d].size(); c++) {
-				cathPeds[c] = PCal.getPedestal(cathNames[s][d][c],fTimeScaler[BOTH]);
+			PCal.cathodePedestals(s,d,fTimeScaler[BOTH],cathPeds);
+			for(unsigned int c=0; c<cathNames[s][d].size(); c++)
 				f_MWPC_caths[s][d][c] = r_MWPC_caths[s][d][c] - cathPeds[c];
-			}
-			wirePos[s][d] = PCal.calcHitPos(s,d,f_MWPC_caths[s][d],cathPeds);
+			wirePos[s][d] = PCal.calcHitPos(s,d,f_MWPC_caths[s][d],cathPeds,&posRnd);
 		}
-		fMWPC_anode[s].val -= PCal.getPedestal(sideSubst("MWPC%cAnode",s),fTimeScaler[BOTH]);
+		fMWPC_anode[s].val -= PCal.anodePedestal(s,fTimeScaler[BOTH]);
 		fCathSum[s].val = wirePos[s][X_DIRECTION].cathodeSum + wirePos[s][Y_DIRECTION].cathodeSum;
 		fCathMax[s].val = wirePos[s][X_DIRECTION].maxValue<wirePos[s][Y_DIRECTION].maxValue?wirePos[s][X_DIRECTION].maxValue:wirePos[s][Y_DIRECTION].maxValue;
 		fCathMaxSum[s].val = wirePos[s][X_DIRECTION].maxValue+wirePos[s][Y_DIRECTION].maxValue;
@@ -154,21 +169,22 @@ void ucnaDataAnalyzer11b::reconstructPosition() {
 }
 
 void ucnaDataAnalyzer11b::reconstructVisibleEnergy() {
-	
-	for(Side s = EAST; s <= WEST; ++s) {
-		// get calibrated energy from the 4 tubes combined; also, wirechamber energy deposition estimate
-		if(passedMWPC(s)) {
-			PCal.calibrateEnergy(s,wirePos[s][X_DIRECTION].center,wirePos[s][Y_DIRECTION].center,sevt[s],fTimeScaler[BOTH]);
-			// second pass with tweaked positions
-			for(AxisDirection d = X_DIRECTION; d <= Y_DIRECTION; ++d)
-				PCal.tweakPosition(s,d,wirePos[s][d],sevt[s].energy.x);
-			PCal.calibrateEnergy(s,wirePos[s][X_DIRECTION].center,wirePos[s][Y_DIRECTION].center,sevt[s],fTimeScaler[BOTH]);
-			fEMWPC[s] = PCal.wirechamberEnergy(s, wirePos[s][X_DIRECTION], wirePos[s][Y_DIRECTION], mwpcs[s]);
-		} else {
-			PCal.calibrateEnergy(s,0,0,sevt[s],fTimeScaler[BOTH]);
-			fEMWPC[s] = PCal.wirechamberEnergy(s, wirePos[s][X_DIRECTION], wirePos[s][Y_DIRECTION], mwpcs[s]);
-		}
+	for(Side s = EAST; s <= WEST; ++s)
+		sideVisibleEnergy(s, passedMWPC(s), fTimeScaler[BOTH], sevt[s], wirePos[s], mwpcs[s], fEMWPC[s]);
+}
+
+void ucnaDataAnalyzer11b::sideVisibleEnergy(Side s, bool passedWires, float time, ScintEvent& evt, wireHit* wires, const MWPCevent& mwpc, Float_t& emwpc) const {
+	// get calibrated energy from the 4 tubes combined; also, wirechamber energy deposition estimate
+	if(passedWires) {
+		PCal.calibrateEnergy(s,wires[X_DIRECTION].center,wires[Y_DIRECTION].center,evt,time);
+		// second pass with tweaked positions
+		for(AxisDirection d = X_DIRECTION; d <= Y_DIRECTION; ++d)
+			PCal.tweakPosition(s,d,wires[d],evt.energy.x);
+		PCal.calibrateEnergy(s,wires[X_DIRECTION].center,wires[Y_DIRECTION].center,evt,time);
+	} else {
+		PCal.calibrateEnergy(s,0,0,evt,time);
 	}
+	emwpc = PCal.wirechamberEnergy(s, wires[X_DIRECTION], wires[Y_DIRECTION], mwpc);
 }
 
 void ucnaDataAnalyzer11b::checkMuonVetos() {
@@ -272,8 +288,12 @@ void ucnaDataAnalyzer11b::calcTrigEffic() {
 					tparams.push_back(efficfit.GetParameter(i));
 					terrs.push_back(efficfit.GetParError(i));
 				}
-				CDBout->deleteTrigeff(rn,s,t);
-				CDBout->uploadTrigeff(rn,s,t,tparams,terrs);
+				CalDBSQL* cdb = CDBout;
+				RunNum r = rn;
+				dbWrite([=]() {
+					cdb->deleteTrigeff(r,s,t);
+					cdb->uploadTrigeff(r,s,t,tparams,terrs);
+				});
 			}
 			
 			// plot
@@ -308,6 +328,7 @@ bool ucnaDataAnalyzer11b::processEvent() {
 		for(Side s = EAST; s <= WEST; ++s)
 			PCal.calibrateEnergy(s,0.,0.,sevt[s],fTimeScaler[BOTH]);
 		TLED->Fill();
+		if(digestTrees) ledDigest.add(TLED);
 	}
 	
 	if(isScintTrigger() && !isLED()) {
@@ -326,11 +347,18 @@ bool ucnaDataAnalyzer11b::processEvent() {
 	fillLookaheadHistograms();
 	
 	// fill output tree
-	if(isScintTrigger() && !isLED() && fPassedGlobal) TPhys->Fill();
+	if(isScintTrigger() && !isLED() && fPassedGlobal) {
+		TPhys->Fill();
+		if(digestTrees) physDigest.add(TPhys);
+	}
 	
 	return np;
 }
 
+std::string ucnaDataAnalyzer11b::outputDigest() const {
+	return "phys: "+physDigest.toString()+"; LED: "+ledDigest.toString();
+}
+
 void ucnaDataAnalyzer11b::processBiPulser() {
 	
 	printf("\nFitting Bi Pulser...\n");
@@ -396,10 +424,14 @@ void ucnaDataAnalyzer11b::processBiPulser() {
 				// upload to DB
 				std::string mon_name = PCal.sensorNames[s][t];
 				printf("Uploading pulser data '%s'...\n",mon_name.c_str());
-				unsigned int cgid = CDBout->uploadGraph(itos(rn)+" "+mon_name+" Pulser Centers",times,centers,std::vector<double>(),dcenters);
-				unsigned int wgid = CDBout->uploadGraph(itos(rn)+" "+mon_name+" Pulser Widths",times,widths,std::vector<double>(),dwidths);
-				CDBout->deleteRunMonitor(rn,mon_name,"Chris_peak");
-				CDBout->addRunMonitor(rn,mon_name,"Chris_peak",cgid,wgid);				
+				CalDBSQL* cdb = CDBout;
+				RunNum r = rn;
+				dbWrite([=]() {
+					unsigned int cgid = cdb->uploadGraph(itos(r)+" "+mon_name+" Pulser Centers",times,centers,std::vector<double>(),dcenters);
+					unsigned int wgid = cdb->uploadGraph(itos(r)+" "+mon_name+" Pulser Widths",times,widths,std::vector<double>(),dwidths);
+					cdb->deleteRunMonitor(r,mon_name,"Chris_peak");
+					cdb->addRunMonitor(r,mon_name,"Chris_peak",cgid,wgid);
+				});
 			}
 			drawSimulHistos(hBiPulser[s][t]);
 			printCanvas(sideSubst("PMTs/BiPulser_%c",s)+itos(t));
@@ -427,22 +459,33 @@ void ucnaDataAnalyzer11b::tallyRunTime() {
 
 void ucnaDataAnalyzer11b::replaySummary() {
 	if(!CDBout) return;
-	sprintf(CDBout->query,"DELETE FROM analysis WHERE run_number = %i",rn);
-	CDBout->execute();
+	// compose queries now; execute (possibly later) through write queue
+	std::vector<std::string> queries;
+	char q[1024];
+	sprintf(q,"DELETE FROM analysis WHERE run_number = %i",rn);
+	queries.push_back(q);
 	TDatime tNow;
-	sprintf(CDBout->query,
+	sprintf(q,
 			"INSERT INTO analysis(run_number,analysis_time,live_time_e,live_time_w,live_time,total_time,n_trigs,total_trigs,misaligned,tdc_corrupted) \
 			VALUES (%i,'%s',%f,%f,%f,%f,%u,%u,%i,%i)",
 			int(rn),tNow.AsSQLString(),totalTime[EAST],totalTime[WEST],totalTime[BOTH],
 			wallTime,nLiveTrigs,nEvents,int(nFailedEvnb),int(nFailedBkhf));
-	CDBout->execute();
+	queries.push_back(q);
 	TDatime tStart(fAbsTimeStart);
 	std::string sts(tStart.AsSQLString());
 	TDatime tEnd(fAbsTimeEnd);
 	std::string ste(tEnd.AsSQLString());
-	sprintf(CDBout->query,"UPDATE run SET start_time='%s', end_time='%s' WHERE run_number=%i",sts.c_str(),ste.c_str(),int(rn));
-	printf("%s\n",CDBout->query);
-	CDBout->execute();
+	sprintf(q,"UPDATE run SET start_time='%s', end_time='%s' WHERE run_number=%i",sts.c_str(),ste.c_str(),int(rn));
+	printf("%s\n",q);
+	queries.push_back(q);
+	
+	CalDBSQL* cdb = CDBout;
+	dbWrite([=]() {
+		for(std::vector<std::string>::const_iterator it = queries.begin(); it != queries.end(); it++) {
+			sprintf(cdb->query,"%s",it->c_str());
+			cdb->execute();
+		}
+	});
 }
 
 void ucnaDataAnalyzer11b::quickAnalyzerSummary() const {
@@ -476,6 +519,137 @@ void printHelp(const char* argname) {
 	printf("\t\tnoroot: skip saving output .root file (plots/summary only)\n");
 	printf("\t\tledtree: produce separate TTree with only LED events\n");
 	printf("\t\tforceped: force recalculation of pedestals\n");
+	printf("\t\tthreads=<n>: replay run range on n parallel worker threads\n");
+	printf("\t\tpipeline=<n>: scan events with separate reader thread and n calibration threads\n");
+	printf("\t\trawcache=<MB>: memory limit for keeping raw events from pedestal pre-pass, shared between threads (default %i; 0 to re-read input)\n",ucnaAnalyzerBase::readCacheMB);
+	printf("\t\tgmsbucket=<s>: approximate GMS corrections as constant over time buckets of given width (default %g: exact)\n",LinearityCorrector::gmsTimeBucket);
+	printf("\t\tpipecheck: replay each run serially (no DB output), then pipelined, and compare output trees\n");
+}
+
+/// command-line replay options
+struct ReplayOptions {
+	/// constructor
+	ReplayOptions(): cutBeam(false), nodbout(false), noroot(false), ledtree(false), forceped(false), nThreads(1), nPipeline(0), pipeCheck(false) {}
+	bool cutBeam;			///< cut beam pulses and low GV rate
+	bool nodbout;			///< skip output DB writes
+	bool noroot;			///< skip output .root file
+	bool ledtree;			///< produce separate LED events tree
+	bool forceped;			///< force pedestals recalculation
+	unsigned int nThreads;	///< number of parallel replay threads
+	unsigned int nPipeline;	///< number of calibration threads for pipelined event scan
+	bool pipeCheck;			///< compare serial and pipelined replay outputs
+};
+
+/// replay one run; optionally, with shared write queue and serializing lock for parallel replays; returns output digest if checking
+std::string replayRun(RunNum r, const ReplayOptions& O, const std::string& outDir, CalDB* CDBin, CalDBSQL* CDBw,
+			   DBWriteQueue* Q = NULL, std::mutex* L = NULL) {
+	
+	std::string inDir = getEnvSafe("UCNADATADIR");
+	if(!fileExists(inDir+"/full"+itos(r)+".root") && r > 16300)
+		inDir = "/data/ucnadata/2011/rootfiles/";
+	
+	ucnaDataAnalyzer11b* A;
+	{
+		OptionalLock l(L);
+		A = new ucnaDataAnalyzer11b(r,outDir,CDBin);
+		A->setIgnoreBeamOut(!O.cutBeam);
+		A->analyzeLED = O.ledtree;
+		A->needsPeds = O.forceped;
+		A->pipelineWorkers = O.nPipeline;
+		A->digestTrees = O.pipeCheck;
+#ifdef PUBLICATION_PLOTS
+		A->colorPlots = false;
+#endif
+		if(CDBw) {
+			A->setOutputDB(CDBw);
+			A->setWriteQueue(Q);
+		}
+		A->setSerialLock(L);
+		A->addFile(inDir+"/full"+itos(r)+".root");
+	}
+	A->analyze();
+	OptionalLock l(L);
+	A->setWriteRoot(!O.noroot);
+	A->write();
+	std::string d = O.pipeCheck ? A->outputDigest() : "";
+	delete A;
+	return d;
+}
+
+/// replay runs serially and pipelined, comparing output; returns number of mismatched runs
+int checkPipeline(RunNum r0, RunNum r1, const ReplayOptions& O, const std::string& outDir) {
+	enableROOTThreads();
+	ReplayOptions Os = O;
+	Os.nPipeline = 0;
+	int nBad = 0;
+	for(RunNum r = r0; r <= r1; r++) {
+		std::string d0 = replayRun(r,Os,outDir,CalDBSQL::getCDB(true),NULL);
+		CalDBSQL* CDBw = NULL;
+		if(!O.nodbout) {
+			printf("Connecting to output DB...\n");
+			CDBw = CalDBSQL::getCDB(false);
+		}
+		std::string d1 = replayRun(r,O,outDir,CalDBSQL::getCDB(true),CDBw);
+		printf("\nRun %i serial    %s\nRun %i pipelined %s\n",r,d0.c_str(),r,d1.c_str());
+		if(d0 != d1) {
+			printf("*** Run %i pipelined replay output differs from serial! ***\n",r);
+			nBad++;
+		}
+	}
+	return nBad;
+}
+
+/// replay run range on worker threads, sharing one calibrations DB connection and output DB writer
+void replayRunsParallel(RunNum r0, RunNum r1, const ReplayOptions& O, const std::string& outDir) {
+	
+	enableROOTThreads();
+	
+	CalDBLocked CDBin(CalDBSQL::getCDB(true));
+	CalDBSQL* CDBw = NULL;
+	if(!O.nodbout) {
+		printf("Connecting to output DB...\n");
+		CDBw = CalDBSQL::getCDB(false);
+	}
+	DBWriteQueue Q;
+	std::mutex L;
+	
+	// split raw events cache memory budget between concurrently replayed runs
+	const unsigned int nWorkers = O.nThreads < r1-r0+1 ? O.nThreads : r1-r0+1;
+	const unsigned int cacheMB = ucnaAnalyzerBase::readCacheMB;
+	ucnaAnalyzerBase::readCacheMB = cacheMB/nWorkers;
+	
+	RunNum rnext = r0;
+	std::mutex runLock;
+	std::vector<std::thread> workers;
+	for(unsigned int i=0; i<nWorkers; i++) {
+		workers.push_back(std::thread([&]() {
+			while(true) {
+				RunNum r;
+				{
+					std::lock_guard<std::mutex> l(runLock);
+					if(rnext > r1) return;
+					r = rnext++;
+				}
+				try {
+					replayRun(r,O,outDir,&CDBin,CDBw,&Q,&L);
+				} catch(...) {
+					// report and continue with other runs; nothing may escape the thread
+					std::exception_ptr p = std::current_exception();
+					printf("*** Replay of run %i failed! ***\n",r);
+					try { std::rethrow_exception(p); }
+					catch(SMExcept& e) { e.display(); }
+					catch(std::exception& e) { printf("\t%s\n",e.what()); }
+					catch(...) { }
+				}
+			}
+		}));
+	}
+	for(std::vector<std::thread>::iterator it = workers.begin(); it != workers.end(); it++)
+		it->join();
+	ucnaAnalyzerBase::readCacheMB = cacheMB;
+	
+	printf("Waiting for DB writes to complete...\n");
+	Q.finish();
 }
 
 int main(int argc, char** argv) {
@@ -496,23 +670,29 @@ int main(int argc, char** argv) {
 		rlist.push_back(rlist[0]);
 	
 	// other options
-	bool cutBeam = false;
-	bool nodbout = false;
-	bool noroot = false;
-	bool ledtree = false;
-	bool forceped = false;
+	ReplayOptions O;
 	for(int i=2; i<argc; i++) {
 		std::string arg(argv[i]);
 		if(arg=="cutbeam")
-			cutBeam = true;
+			O.cutBeam = true;
 		else if(arg=="nodbout")
-			nodbout = true;
+			O.nodbout = true;
 		else if(arg=="noroot")
-			noroot = true;
+			O.noroot = true;
 		else if(arg=="ledtree")
-			ledtree = true;
+			O.ledtree = true;
 		else if(arg=="forceped")
-			forceped = true;
+			O.forceped = true;
+		else if(startsWith(arg,"threads=") && atoi(arg.substr(8).c_str()) > 0)
+			O.nThreads = atoi(arg.substr(8).c_str());
+		else if(startsWith(arg,"pipeline=") && atoi(arg.substr(9).c_str()) > 0)
+			O.nPipeline = atoi(arg.substr(9).c_str());
+		else if(startsWith(arg,"rawcache="))
+			ucnaAnalyzerBase::readCacheMB = atoi(arg.substr(9).c_str());
+		else if(startsWith(arg,"gmsbucket="))
+			LinearityCorrector::gmsTimeBucket = atof(arg.substr(10).c_str());
+		else if(arg=="pipecheck")
+			O.pipeCheck = true;
 		else {
 			printHelp(argv[0]);
 			exit(1);
@@ -523,27 +703,27 @@ int main(int argc, char** argv) {
 	
 	std::string outDir = getEnvSafe("UCNAOUTPUTDIR");
 	
+	if(O.pipeCheck) {
+		if(!O.nPipeline)
+			O.nPipeline = 2;
+		return checkPipeline((RunNum)rlist[0],(RunNum)rlist[1],O,outDir) ? 1 : 0;
+	}
+	
+	if(O.nPipeline)
+		enableROOTThreads();
+	
+	if(O.nThreads > 1 && rlist[1] > rlist[0]) {
+		replayRunsParallel((RunNum)rlist[0],(RunNum)rlist[1],O,outDir);
+		return 0;
+	}
+	
 	for(RunNum r = (RunNum)rlist[0]; r<=(RunNum)rlist[1]; r++) {
-		
-		std::string inDir = getEnvSafe("UCNADATADIR");
-		if(!fileExists(inDir+"/full"+itos(r)+".root") && r > 16300)
-			inDir = "/data/ucnadata/2011/rootfiles/";
-		
-		ucnaDataAnalyzer11b A(r,outDir,CalDBSQL::getCDB(true));
-		A.setIgnoreBeamOut(!cutBeam);
-		A.analyzeLED = ledtree;
-		A.needsPeds = forceped;
-#ifdef PUBLICATION_PLOTS
-		A.colorPlots = false;
-#endif
-		if(!nodbout) {
+		CalDBSQL* CDBw = NULL;
+		if(!O.nodbout) {
 			printf("Connecting to output DB...\n");
-			A.setOutputDB(CalDBSQL::getCDB(false));
+			CDBw = CalDBSQL::getCDB(false);
 		}
-		A.addFile(inDir+"/full"+itos(r)+".root");
-		A.analyze();
-		A.setWriteRoot(!noroot);
-		A.write();
+		replayRun(r,O,outDir,CalDBSQL::getCDB(true),CDBw);
 	}
 	
 	return 0;
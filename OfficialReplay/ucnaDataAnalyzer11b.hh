@@ -5,6 +5,8 @@
 #include "ManualInfo.hh"
 #include "RollingWindow.hh"
 #include "EventClassifier.hh"
+#include "ReplayThreads.hh"
+#include <TRandom3.h>
 
 /// cut blip in data
 struct Blip {
@@ -14,6 +16,56 @@ struct Blip {
 	BlindTime length() const { return end-start; }
 };
 
+/// level of calibration applied to an event
+enum EventCalLevel {
+	CAL_NONE = 0,	///< timing and pedestal subtraction only
+	CAL_LED = 1,	///< LED tree event: position, PMT energy at center
+	CAL_BETA = 2	///< scintillator trigger: position, visible energy, wirechamber energy
+};
+
+/// snapshot of one event passed between stages of the pipelined replay
+struct ReplayEvent {
+	unsigned int evtN;							///< event number in input TChain
+	EventCalLevel calLevel;						///< calibration to apply
+	Float_t rawDelt0;							///< raw Delt0, for previous event's look-ahead window
+	
+	// ordered stage: timing, cuts, pedestals, positions
+	Int_t sis00;								///< DAQ trigger bits
+	Int_t iTriggerNumber;						///< trigger number
+	Int_t fEvnbGood;							///< Event number header good
+	Int_t fBkhfGood;							///< Block header good
+	Int_t fPassedGlobal;						///< passed global cuts
+	BlindTime fTimeScaler;						///< event time
+	Float_t fBeamclock;							///< time since beam pulse
+	Float_t fDelt0;								///< time since previous event
+	Float_t fScint_tdc[BOTH][nBetaTubes+1];		///< scintillator TDCs
+	Float_t fMonADC[kNumUCNMons];				///< UCN monitor ADCs
+	Float_t fTop_tdc;							///< East top veto TDC
+	Float_t fTop_adc;							///< East top veto ADC
+	Float_t fBacking_tdc[BOTH];					///< backing veto TDCs
+	Float_t fBacking_adc[BOTH];					///< backing veto ADCs
+	Float_t fDrift_tac[BOTH];					///< drift tube TACs
+	Int_t fTaggedTop[BOTH];						///< top veto tags
+	Int_t fTaggedBack[BOTH];					///< backing veto tags
+	Int_t fTaggedDrift[BOTH];					///< drift tube tags
+	Float_t fMWPC_anode[BOTH];					///< anode (pedestal subtracted after position reconstruction)
+	Float_t f_MWPC_caths[BOTH][2][kMaxCathodes];///< pedestal-subtracted cathodes
+	Float_t fCathSum[BOTH];						///< cathode sum
+	Float_t fCathMax[BOTH];						///< cathode max
+	Float_t fCathMaxSum[BOTH];					///< cathode max sum
+	Int_t fPassedAnode[BOTH];					///< passed anode cut
+	Int_t fPassedCath[BOTH];					///< passed cathode sum cut
+	Int_t fPassedCathMax[BOTH];					///< passed cathode max cut
+	Int_t fPassedCathMaxSum[BOTH];				///< passed cathode max sum cut
+	Int_t passedMWPC[BOTH];						///< overall wirechamber cut
+	MWPCevent mwpcs[BOTH];						///< MWPC information
+	
+	// calibration workers stage
+	ScintEvent sevt[BOTH];						///< scintillator event (pedestal-subtracted ADCs in; energies out)
+	wireHit wirePos[BOTH][2];					///< wire positions (tweaked for energy)
+	Float_t fEMWPC[BOTH];						///< wirechamber energy
+};
+
 /// new clean-ish re-write of data analyzer; try to be backward compatible with old output tree
 class ucnaDataAnalyzer11b: public ucnaAnalyzerBase, public EventClassifier {
 public:
@@ -24,6 +76,10 @@ public:
 	void analyze();
 	/// set output DB connection
 	inline void setOutputDB(CalDBSQL* CDB = NULL) { CDBout = CDB; }
+	/// set queue for serializing output DB writes (NULL to write immediately)
+	inline void setWriteQueue(DBWriteQueue* Q = NULL) { dbQueue = Q; }
+	/// set lock for stages that are not thread-safe (fits, plots, DB reads), when running parallel replays
+	inline void setSerialLock(std::mutex* L = NULL) { serialLock = L; }
 	
 	/// figure out whether this is a Bi pulser trigger
 	bool isPulserTrigger();
@@ -34,6 +90,12 @@ public:
 	bool needsPeds;
 	/// set whether to produce color or black-and-white plots
 	bool colorPlots;
+	/// set number of calibration worker threads for pipelined event scan (0 for serial scan)
+	unsigned int pipelineWorkers;
+	/// set whether to accumulate output tree digests (for comparing serial/pipelined replay)
+	bool digestTrees;
+	/// output trees digest summary
+	std::string outputDigest() const;
 	
 	//---- event classifier subclass functions
 	/// event type classification
@@ -47,6 +109,11 @@ protected:
 
 	// whole run variables
 	CalDBSQL* CDBout;							///< output database connection
+	DBWriteQueue* dbQueue;						///< optional queue for output DB writes
+	std::mutex* serialLock;						///< optional lock for non-thread-safe stages
+	TRandom3 posRnd;							///< wirechamber position tie-breaking random source, seeded by run number
+	/// perform output DB write, through queue if available
+	void dbWrite(const std::function<void()>& f) { if(dbQueue) dbQueue->push(f); else f(); }
 	Float_t wallTime;							///< initial estimate of run time before actually scanning events; after scanning, total run time
 	unsigned int nLiveTrigs;					///< number of triggers not removed by cuts
 	Float_t nFailedEvnb;						///< total Evnb failures
@@ -77,6 +144,8 @@ protected:
 	wireHit wirePos[BOTH][2];					///< wire positioning data for [side][direction]
 	Float_t fEMWPC[BOTH];						///< reconstructed energy deposition in wirechamber
 	Float_t fEtrue;								///< event reconstructed true energy
+	TreeDigest physDigest;						///< digest of TPhys entries
+	TreeDigest ledDigest;						///< digest of TLED entries
 	
 	/// pre-scan data to extract pedestals
 	void pedestalPrePass();
@@ -98,11 +167,23 @@ protected:
 	void reconstructPosition();
 	/// apply PMT calibrations to get visible energy
 	void reconstructVisibleEnergy();
+	/// visible and wirechamber energy for one side (thread-safe given tabulated GMS factors)
+	void sideVisibleEnergy(Side s, bool passedWires, float time, ScintEvent& evt, wireHit* wires, const MWPCevent& mwpc, Float_t& emwpc) const;
 	/// classify muon veto response
 	void checkMuonVetos();
 	/// reconstruct true energy based on event type
 	void reconstructTrueEnergy();
 	
+	/*--- pipelined event processing ---*/
+	/// scan events with separate reader thread, calibration workers, and ordered output (same results as serial scan)
+	void scanPipelined();
+	/// ordered stage: timing, cuts, pedestals, positions for raw event, saved to E
+	void sequenceEvent(const ucnaReadin& raw, unsigned int e, ReplayEvent& E);
+	/// worker stage: energy calibrations on event snapshot
+	void calibrateEvent(ReplayEvent& E) const;
+	/// ordered output stage: restore event state, classify, fill histograms and trees
+	void writeEvent(const ReplayEvent& E, Float_t nextDelt0);
+	
 	/*--- end of processing ---*/
 	/// trigger efficiency curves
 	void calcTrigEffic();
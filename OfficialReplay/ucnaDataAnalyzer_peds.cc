@@ -33,6 +33,7 @@ void ucnaDataAnalyzer11b::pedestalPrePass() {
 	std::vector<float> anodePeds[2];
 	std::vector<float> cathPeds[2][2][kMaxCathodes];
 	std::vector<float> mwpcTimes[2];
+	startReadCache();	// keep raw events for main pass, so input is only decompressed once
 	startScan();
 	while (nextPoint()) {
 		convertReadin();
@@ -53,7 +54,10 @@ void ucnaDataAnalyzer11b::pedestalPrePass() {
 		}
 	}
 	
+	printf("Cached %i/%i raw events (%.0f MB) for main pass\n",(int)readCache.size(),nEvents,readCache.size()*sizeof(ucnaReadin)/(1024.*1024.));
+	
 	// fit pedestals, save results
+	OptionalLock L(serialLock);
 	for(Side s = EAST; s <= WEST; ++s) {
 		for(unsigned int t=0; t<nBetaTubes; t++)
 			monitorPedestal(pmtPeds[s][t],pmtTimes[s],PCal.sensorNames[s][t],50,true);
@@ -175,10 +179,14 @@ void ucnaDataAnalyzer11b::monitorPedestal(const std::vector<float>& vdata, const
 	// optionally add to Calibrations DB
 	if(CDBout) {
 		printf("Uploading pedestal '%s'...\n",mon_name.c_str());
-		unsigned int cgid = CDBout->uploadGraph(itos(rn)+" "+mon_name+(isPed?" Pedestal":" Peak")+" Centers",times,centers,dtimes,dcenters);
-		unsigned int wgid = CDBout->uploadGraph(itos(rn)+" "+mon_name+(isPed?" Pedestal":" Peak")+" Widths",times,sigmas,dtimes);
-		CDBout->deleteRunMonitor(rn,mon_name,isPed?"pedestal":"GMS_peak");
-		CDBout->addRunMonitor(rn,mon_name,isPed?"pedestal":"GMS_peak",cgid,wgid);
+		CalDBSQL* cdb = CDBout;
+		RunNum r = rn;
+		dbWrite([=]() {
+			unsigned int cgid = cdb->uploadGraph(itos(r)+" "+mon_name+(isPed?" Pedestal":" Peak")+" Centers",times,centers,dtimes,dcenters);
+			unsigned int wgid = cdb->uploadGraph(itos(r)+" "+mon_name+(isPed?" Pedestal":" Peak")+" Widths",times,sigmas,dtimes);
+			cdb->deleteRunMonitor(r,mon_name,isPed?"pedestal":"GMS_peak");
+			cdb->addRunMonitor(r,mon_name,isPed?"pedestal":"GMS_peak",cgid,wgid);
+		});
 	}
 	
 	delete(p);
@@ -0,0 +1,288 @@
+#include "ucnaDataAnalyzer11b.hh"
+#include "SMExcept.hh"
+#include <exception>
+#include <string.h>
+
+/// batch of events passed through the calibration workers
+struct ReplayBatch {
+	/// constructor
+	ReplayBatch(): done(false) {}
+	std::vector<ReplayEvent> evts;	///< events in batch
+	bool done;						///< whether calibrations are complete
+	std::exception_ptr err;			///< exception thrown during calibration
+};
+
+void ucnaDataAnalyzer11b::sequenceEvent(const ucnaReadin& raw, unsigned int e, ReplayEvent& E) {
+
+	// same order-dependent steps as processEvent, using analyzer state
+	ucnaReadin::operator=(raw);
+	currentEvent = e;
+	convertReadin();
+	checkHeaderQuality();
+	calibrateTimes();
+	checkMuonVetos();
+	for(Side s = EAST; s <= WEST; ++s)
+		PCal.pedSubtract(s, sevt[s].adc, fTimeScaler[BOTH]);
+
+	// positions are reconstructed here, in order, since calcHitPos breaks ties from the run's random sequence
+	E.calLevel = CAL_NONE;
+	if(isLED() && TLED) E.calLevel = CAL_LED;
+	else if(isScintTrigger() && !isLED()) E.calLevel = CAL_BETA;
+	if(E.calLevel != CAL_NONE)
+		reconstructPosition();
+
+	// save snapshot
+	E.evtN = e;
+	E.rawDelt0 = r_Delt0;
+	E.sis00 = SIS00;
+	E.iTriggerNumber = iTriggerNumber;
+	E.fEvnbGood = fEvnbGood;
+	E.fBkhfGood = fBkhfGood;
+	E.fPassedGlobal = fPassedGlobal;
+	E.fTimeScaler = fTimeScaler;
+	E.fBeamclock = fBeamclock.val;
+	E.fDelt0 = fDelt0;
+	for(unsigned int i=0; i<kNumUCNMons; i++)
+		E.fMonADC[i] = fMonADC[i].val;
+	E.fTop_tdc = fTop_tdc[EAST].val;
+	E.fTop_adc = fTop_adc[EAST];
+	for(Side s = EAST; s <= WEST; ++s) {
+		for(unsigned int t=0; t<=nBetaTubes; t++)
+			E.fScint_tdc[s][t] = fScint_tdc[s][t].val;
+		E.fBacking_tdc[s] = fBacking_tdc[s].val;
+		E.fBacking_adc[s] = fBacking_adc[s];
+		E.fDrift_tac[s] = fDrift_tac[s].val;
+		E.fTaggedTop[s] = fTaggedTop[s];
+		E.fTaggedBack[s] = fTaggedBack[s];
+		E.fTaggedDrift[s] = fTaggedDrift[s];
+		E.fMWPC_anode[s] = fMWPC_anode[s].val;
+		E.sevt[s] = sevt[s];
+		if(E.calLevel == CAL_NONE) continue;
+		for(AxisDirection d = X_DIRECTION; d <= Y_DIRECTION; ++d) {
+			memcpy(E.f_MWPC_caths[s][d],f_MWPC_caths[s][d],cathNames[s][d].size()*sizeof(Float_t));
+			E.wirePos[s][d] = wirePos[s][d];
+		}
+		E.fCathSum[s] = fCathSum[s].val;
+		E.fCathMax[s] = fCathMax[s].val;
+		E.fCathMaxSum[s] = fCathMaxSum[s].val;
+		E.fPassedAnode[s] = fPassedAnode[s];
+		E.fPassedCath[s] = fPassedCath[s];
+		E.fPassedCathMax[s] = fPassedCathMax[s];
+		E.fPassedCathMaxSum[s] = fPassedCathMaxSum[s];
+		E.passedMWPC[s] = passedMWPC(s);
+		E.mwpcs[s] = mwpcs[s];
+	}
+}
+
+void ucnaDataAnalyzer11b::calibrateEvent(ReplayEvent& E) const {
+	for(Side s = EAST; s <= WEST; ++s) {
+		if(E.calLevel == CAL_LED)
+			PCal.calibrateEnergy(s,0.,0.,E.sevt[s],E.fTimeScaler[BOTH]);
+		else if(E.calLevel == CAL_BETA)
+			sideVisibleEnergy(s, E.passedMWPC[s], E.fTimeScaler[BOTH], E.sevt[s], E.wirePos[s], E.mwpcs[s], E.fEMWPC[s]);
+	}
+}
+
+void ucnaDataAnalyzer11b::writeEvent(const ReplayEvent& E, Float_t nextDelt0) {
+
+	// restore event state; calibration outputs are left untouched (as in processEvent) for uncalibrated events
+	currentEvent = E.evtN;
+	SIS00 = E.sis00;
+	iTriggerNumber = E.iTriggerNumber;
+	fEvnbGood = E.fEvnbGood;
+	fBkhfGood = E.fBkhfGood;
+	fPassedGlobal = E.fPassedGlobal;
+	fTimeScaler = E.fTimeScaler;
+	fBeamclock.val = E.fBeamclock;
+	fDelt0 = E.fDelt0;
+	for(unsigned int i=0; i<kNumUCNMons; i++)
+		fMonADC[i].val = E.fMonADC[i];
+	fTop_tdc[EAST].val = E.fTop_tdc;
+	fTop_adc[EAST] = E.fTop_adc;
+	for(Side s = EAST; s <= WEST; ++s) {
+		for(unsigned int t=0; t<=nBetaTubes; t++)
+			fScint_tdc[s][t].val = E.fScint_tdc[s][t];
+		fBacking_tdc[s].val = E.fBacking_tdc[s];
+		fBacking_adc[s] = E.fBacking_adc[s];
+		fDrift_tac[s].val = E.fDrift_tac[s];
+		fTaggedTop[s] = E.fTaggedTop[s];
+		fTaggedBack[s] = E.fTaggedBack[s];
+		fTaggedDrift[s] = E.fTaggedDrift[s];
+		fMWPC_anode[s].val = E.fMWPC_anode[s];
+		if(E.calLevel == CAL_NONE) {
+			for(unsigned int t=0; t<nBetaTubes; t++)
+				sevt[s].adc[t] = E.sevt[s].adc[t];
+			continue;
+		}
+		sevt[s] = E.sevt[s];
+		for(AxisDirection d = X_DIRECTION; d <= Y_DIRECTION; ++d) {
+			memcpy(f_MWPC_caths[s][d],E.f_MWPC_caths[s][d],cathNames[s][d].size()*sizeof(Float_t));
+			wirePos[s][d] = E.wirePos[s][d];
+		}
+		fCathSum[s].val = E.fCathSum[s];
+		fCathMax[s].val = E.fCathMax[s];
+		fCathMaxSum[s].val = E.fCathMaxSum[s];
+		fPassedAnode[s] = E.fPassedAnode[s];
+		fPassedCath[s] = E.fPassedCath[s];
+		fPassedCathMax[s] = E.fPassedCathMax[s];
+		fPassedCathMaxSum[s] = E.fPassedCathMaxSum[s];
+		mwpcs[s] = E.mwpcs[s];
+		if(E.calLevel == CAL_BETA)
+			fEMWPC[s] = E.fEMWPC[s];
+	}
+
+	// remainder of processEvent
+	fillEarlyHistograms();
+	if(E.calLevel == CAL_LED) {
+		TLED->Fill();
+		if(digestTrees) ledDigest.add(TLED);
+	}
+	if(E.calLevel == CAL_BETA) {
+		classifyEvent();
+		reconstructTrueEnergy();
+		fillHistograms();
+		if (fPID==PID_BETA) fillRawPMTHistograms();
+	}
+
+	// look-ahead to next event; at end of scan, serial scan has re-loaded the first event and reset the event counter
+	currentEvent = E.evtN+1 < nEvents ? E.evtN+1 : (unsigned int)(-1);
+	fWindow.val = fDelt0 + 1.e-6*nextDelt0;
+	fillLookaheadHistograms();
+
+	if(isScintTrigger() && !isLED() && fPassedGlobal) {
+		TPhys->Fill();
+		if(digestTrees) physDigest.add(TPhys);
+	}
+}
+
+void ucnaDataAnalyzer11b::scanPipelined() {
+
+	const unsigned int batchSize = 1024;
+	const unsigned int maxInFlight = 2*pipelineWorkers+2;
+	printf("Pipelined scan with %i calibration threads... ",pipelineWorkers);
+
+	// GMS factors in read-only table for calibration workers
+	PCal.tabulateGMS(0,wallTime);
+
+	startScan();
+	ucnaReadin readBuf;
+	setReadTarget(&readBuf);
+
+	// reader thread: decompress input in order
+	BoundedQueue< std::vector<ucnaReadin>* > rawQ(4);
+	std::exception_ptr readErr;
+	std::thread reader([&]() {
+		try {
+			std::vector<ucnaReadin>* b = NULL;
+			for(unsigned int e=0; e<nEvents; e++) {
+				speedload(e);
+				if(!b) { b = new std::vector<ucnaReadin>(); b->reserve(batchSize); }
+				b->push_back(readBuf);
+				if(b->size() == batchSize || e+1 == nEvents) {
+					if(!rawQ.push(b)) { delete b; break; }
+					b = NULL;
+				}
+			}
+		} catch(...) {
+			readErr = std::current_exception();
+		}
+		rawQ.close();
+	});
+
+	// calibration workers
+	BoundedQueue<ReplayBatch*> calQ(maxInFlight);
+	std::mutex doneLock;
+	std::condition_variable doneCond;
+	std::vector<std::thread> workers;
+	for(unsigned int i=0; i<pipelineWorkers; i++) {
+		workers.push_back(std::thread([&]() {
+			ReplayBatch* B;
+			while(calQ.pop(B)) {
+				try {
+					for(std::vector<ReplayEvent>::iterator it = B->evts.begin(); it != B->evts.end(); it++)
+						calibrateEvent(*it);
+				} catch(...) {
+					B->err = std::current_exception();
+				}
+				std::lock_guard<std::mutex> l(doneLock);
+				B->done = true;
+				doneCond.notify_all();
+			}
+		}));
+	}
+
+	// this thread: ordered sequencing and output; a batch is written once the next is sequenced, for look-ahead
+	std::deque<ReplayBatch*> inFlight;
+	Float_t firstDelt0 = 0;
+	unsigned int e = 0;
+	std::exception_ptr err;
+	try {
+		std::vector<ucnaReadin>* raw;
+		while(rawQ.pop(raw)) {
+			ReplayBatch* B = new ReplayBatch();
+			inFlight.push_back(B);
+			B->evts.resize(raw->size());
+			for(unsigned int i=0; i<raw->size(); i++, e++) {
+				if(nEvents >= 20 && !(e%(nEvents/20))) {
+					printf("*"); fflush(stdout);
+				}
+				sequenceEvent((*raw)[i],e,B->evts[i]);
+			}
+			delete raw;
+			if(!B->evts[0].evtN) firstDelt0 = B->evts[0].rawDelt0;
+			calQ.push(B);
+
+			while(inFlight.size() > 1) {
+				ReplayBatch* F = inFlight.front();
+				{
+					std::unique_lock<std::mutex> l(doneLock);
+					if(!F->done && inFlight.size() < maxInFlight) break;
+					while(!F->done) doneCond.wait(l);
+				}
+				if(F->err) std::rethrow_exception(F->err);
+				for(unsigned int i=0; i<F->evts.size(); i++)
+					writeEvent(F->evts[i], i+1<F->evts.size() ? F->evts[i+1].rawDelt0 : inFlight[1]->evts[0].rawDelt0);
+				inFlight.pop_front();
+				delete F;
+			}
+		}
+		if(readErr) std::rethrow_exception(readErr);
+
+		// drain remaining batches
+		calQ.close();
+		while(inFlight.size()) {
+			ReplayBatch* F = inFlight.front();
+			{
+				std::unique_lock<std::mutex> l(doneLock);
+				while(!F->done) doneCond.wait(l);
+			}
+			if(F->err) std::rethrow_exception(F->err);
+			for(unsigned int i=0; i<F->evts.size(); i++)
+				writeEvent(F->evts[i], i+1<F->evts.size() ? F->evts[i+1].rawDelt0 :
+						   inFlight.size() > 1 ? inFlight[1]->evts[0].rawDelt0 : firstDelt0);
+			inFlight.pop_front();
+			delete F;
+		}
+	} catch(...) {
+		err = std::current_exception();
+	}
+
+	// shut down threads
+	rawQ.close();
+	calQ.close();
+	reader.join();
+	for(std::vector<std::thread>::iterator it = workers.begin(); it != workers.end(); it++)
+		it->join();
+	std::vector<ucnaReadin>* raw;
+	while(rawQ.pop(raw)) delete raw;
+	while(inFlight.size()) {
+		delete inFlight.front();
+		inFlight.pop_front();
+	}
+
+	// leave input positioned as after serial scan
+	setReadTarget(NULL);
+	printf("\n");
+	startScan();
+	if(err) std::rethrow_exception(err);
+}
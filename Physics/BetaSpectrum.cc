@@ -6,6 +6,7 @@
 #include <vector>
 #include <cassert>
 #include <map>
+#include <mutex>
 #include "SMExcept.hh"
 
 /// hyperbolic sine
@@ -324,6 +325,66 @@ double neutronCorrectedBetaSpectrum(double KE) {
 	return plainPhaseSpace(W,beta_W0)*neutronSpectrumCorrectionFactor(KE);
 }
 
+CorrectionTable::CorrectionTable(const std::function<double(double)>& cf, double w0, bool tb, double tol):
+c(cf), W0(w0), pmin(1e-3*sqrt(W0*W0-1)), pmax(sqrt(W0*W0-1)), timesBeta(tb), maxErr(0) {
+	// start table above any range where the analytic form is cut off to 0
+	const double p0 = pmin;
+	for(unsigned int i=0; i<4096; i++) {
+		double p = p0+(pmax-p0)*i/4096.;
+		double v = tabulated(sqrt(p*p+1));
+		if(!(v != 0 && v == v)) pmin = p0+(pmax-p0)*(i+1)/4096.;
+	}
+	// refine until corrected spectrum at check points between nodes agrees with analytic form
+	for(unsigned int n = 64; n <= (1<<16); n *= 2) {
+		h = (pmax-pmin)/n;
+		y.resize(n);
+		for(unsigned int i=0; i<n; i++)
+			y[i] = tabulated(sqrt(pow(pmin+(i+0.5)*h,2)+1));
+		maxErr = 0;
+		double smax = 0;
+		for(unsigned int i=0; i<=n; i++) {
+			for(unsigned int j=1; j<4; j++) {
+				double p = pmin+(i+0.25*j-0.5)*h;
+				if(p <= pmin || p >= pmax) continue;
+				double W = sqrt(p*p+1);
+				double ps = plainPhaseSpace(W,W0);
+				double y0 = tabulated(W);
+				double e = fabs(interpolate(p)-y0)*ps*(timesBeta?W/p:1);
+				if(e > maxErr) maxErr = e;
+				double s = fabs(y0)*ps*(timesBeta?W/p:1);
+				if(s > smax) smax = s;
+			}
+		}
+		if(smax) maxErr /= smax;
+		if(maxErr <= tol) return;
+	}
+	printf("*** Warning: spectrum correction table with %i points only reaches %g error (wanted %g)\n",(int)y.size(),maxErr,tol);
+}
+
+double CorrectionTable::interpolate(double p) const {
+	// 4-point Lagrange interpolation on nodes at pmin+(i+1/2)h
+	const int n = y.size();
+	double x = (p-pmin)/h-0.5;
+	int i = int(floor(x));
+	if(i < 1) i = 1;
+	if(i > n-3) i = n-3;
+	const double t = x-i;
+	return ( -t*(t-1)*(t-2)*y[i-1] + 3*(t+1)*(t-1)*(t-2)*y[i] - 3*(t+1)*t*(t-2)*y[i+1] + (t+1)*t*(t-1)*y[i+2] )/6.;
+}
+
+double CorrectionTable::operator()(double W) const {
+	if(!(W > 1)) return c(W);
+	const double p = sqrt(W*W-1);
+	if(!(pmin < p && p < pmax)) return c(W);
+	const double v = interpolate(p);
+	return timesBeta?v*W/p:v;
+}
+
+double neutronSpectrumCorrectionFactorTab(double KE) {
+	static const CorrectionTable T([](double W) { return neutronSpectrumCorrectionFactor((W-1)*m_e); }, beta_W0, true);
+	return T((KE+m_e)/m_e);
+}
+
 double Davidson_C1T(double W, double W0, double Z, double R) {
 	double p = sqrt(W*W-1);
 	double y = fs_alpha*Z*W/p;
@@ -373,9 +434,22 @@ double Behrens_Cs137_C(double W, double W0) {
 
 //-----------------------------------------------------//
 
-BetaSpectrumGenerator::BetaSpectrumGenerator(double a, double z, double ep): A(a), Z(z), EP(ep),
+BetaSpectrumGenerator::BetaSpectrumGenerator(double a, double z, double ep): useTable(true), A(a), Z(z), EP(ep),
 W0((EP+m_e)/m_e), R(pow(A,1./3.)*neutron_R0), M0(fabs(Z)*proton_M0+(A-fabs(Z))*neutron_M0),
-forbidden(0), M2_F(0), M2_GT(1) { }
+forbidden(0), M2_F(0), M2_GT(1), table(NULL) { }
+
+BetaSpectrumGenerator::BetaSpectrumGenerator(const BetaSpectrumGenerator& B): useTable(B.useTable),
+A(B.A), Z(B.Z), EP(B.EP), W0(B.W0), R(B.R), M0(B.M0), forbidden(B.forbidden), M2_F(B.M2_F), M2_GT(B.M2_GT), table(B.table.load()) { }
+
+BetaSpectrumGenerator& BetaSpectrumGenerator::operator=(const BetaSpectrumGenerator& B) {
+	A = B.A; Z = B.Z; EP = B.EP; W0 = B.W0; R = B.R; M0 = B.M0;
+	useTable = B.useTable;
+	forbidden = B.forbidden;
+	M2_F = B.M2_F;
+	M2_GT = B.M2_GT;
+	table = B.table.load();
+	return *this;
+}
 
 double BetaSpectrumGenerator::spectrumCorrectionFactor(double W) const {
 	double c = WilkinsonF0(Z,W,R);			// Fermi function Coulomb
@@ -406,7 +480,29 @@ double BetaSpectrumGenerator::spectrumCorrectionFactor(double W) const {
 double BetaSpectrumGenerator::decayProb(double KE) const {
 	double W = (KE+m_e)/m_e;
 	if(W<1 || W>W0) return 0;
-	return plainPhaseSpace(W,W0)*spectrumCorrectionFactor(W);
+	return plainPhaseSpace(W,W0)*(useTable?spectrumCorrectionFactorTab(W):spectrumCorrectionFactor(W));
+}
+
+double BetaSpectrumGenerator::spectrumCorrectionFactorTab(double W) const {
+	const CorrectionTable* t = table.load(std::memory_order_acquire);
+	if(!t) {
+		// tables shared between generators, built once per process for each parameter set
+		double k[] = {A, Z, EP, R, M0, (double)forbidden, M2_F, M2_GT};
+		std::vector<double> key(k,k+sizeof(k)/sizeof(k[0]));
+		static std::map< std::vector<double>, CorrectionTable* > tables;
+		static std::mutex tablesLock;
+		std::lock_guard<std::mutex> lk(tablesLock);
+		std::map< std::vector<double>, CorrectionTable* >::iterator it = tables.find(key);
+		if(it == tables.end()) {
+			BetaSpectrumGenerator B = *this;
+			B.useTable = false;
+			B.table = NULL;
+			it = tables.insert(std::make_pair(key, new CorrectionTable([B](double w) { return B.spectrumCorrectionFactor(w); }, W0, Z>0))).first;
+		}
+		t = it->second;
+		table.store(t, std::memory_order_release);
+	}
+	return (*t)(W);
 }
 
 //-----------------------------------------------------//
@@ -421,6 +517,11 @@ double shann_h_minus_g_a2pi(double W, double W0) {
 			+athb/b*(2.-2.*b*b) - (W0-W)*(W0-W)/(6.*W*W) )*fs_alpha/(2.*M_PI);
 }
 
+double asymmetryCorrectionFactorTab(double KE) {
+	static const CorrectionTable T([](double W) { return asymmetryCorrectionFactor((W-1)*m_e); }, beta_W0, false);
+	return T((KE+m_e)/m_e);
+}
+
 double WilkinsonACorrection(double W) {
 	const double W0 = neutronBetaEp/m_e+1.;
 	const double mu = 2.792847356-(-1.91304273);	// mu_p - mu_n = 2.792847356(23) - -1.91304273(45) PDG 2010
@@ -11,6 +11,9 @@
 // [5] Wilkinson, Evaluation of Beta-Decay V,   NIM A 365 (1995) 497-507
 	
 #include <math.h>
+#include <vector>
+#include <functional>
+#include <atomic>
 // useful physics constants; several in hbar=m_e=c=1 "natural units"
 const double neutronBetaEp = 782.347;			///< neutron beta decay endpoint, keV
 const double m_e = 511.00;						///< electron mass, keV/c^2
@@ -81,18 +84,85 @@ double neutronSpectrumCorrectionFactor(double KE);
 /// corrected beta spectrum for unpolarized neutron beta decay
 double neutronCorrectedBetaSpectrum(double KE);
 
+/// Piecewise-cubic table of a spectrum correction c(W) up to W0, uniformly spaced in electron momentum,
+/// refined on construction until the corrected spectrum plainPhaseSpace(W)*c(W) agrees with the analytic form
+/// to a given tolerance (relative to the spectrum maximum). Coulomb-type corrections (diverging as 1/beta at W->1)
+/// are tabulated as c*beta.
+class CorrectionTable {
+public:
+	/// constructor, tabulating c(W) to tolerance tol
+	CorrectionTable(const std::function<double(double)>& c, double W0, bool timesBeta, double tol = 1e-7);
+	/// evaluate correction at W (analytic form outside table range: lowest 0.1% of momentum, and below any cutoff to 0)
+	double operator()(double W) const;
+	/// number of tabulated points
+	unsigned int nPoints() const { return y.size(); }
+	/// largest corrected spectrum error found in self-check, relative to spectrum maximum
+	double getMaxErr() const { return maxErr; }
+	
+protected:
+	/// interpolate tabulated value at momentum p
+	double interpolate(double p) const;
+	/// tabulated quantity at W
+	double tabulated(double W) const { return timesBeta?c(W)*sqrt(W*W-1)/W:c(W); }
+	
+	std::function<double(double)> c;	///< analytic form
+	double W0;							///< endpoint energy
+	double pmin;						///< start of tabulated momentum range
+	double pmax;						///< endpoint momentum
+	bool timesBeta;						///< whether c*beta is tabulated
+	double h;							///< momentum step
+	std::vector<double> y;				///< tabulated values at momenta pmin+(i+1/2)*h
+	double maxErr;						///< self-check maximum error
+};
+
+/// tabulated (fast) neutronSpectrumCorrectionFactor
+double neutronSpectrumCorrectionFactorTab(double KE);
+
 /// beta decay spectrum calculating class
 class BetaSpectrumGenerator {
 public:
 	/// constructor
 	BetaSpectrumGenerator(double a, double z, double ep);
+	/// copy constructor
+	BetaSpectrumGenerator(const BetaSpectrumGenerator& B);
+	/// assignment
+	BetaSpectrumGenerator& operator=(const BetaSpectrumGenerator& B);
+	
+	/// set "forbidden" level of decay
+	void setForbidden(unsigned int f) { forbidden = f; table = NULL; }
+	/// set Fermi and Gamov-Teller matrix elements
+	void setMatrixElements(double m2f, double m2gt) { M2_F = m2f; M2_GT = m2gt; table = NULL; }
+	/// get "forbidden" level of decay
+	unsigned int getForbidden() const { return forbidden; }
+	/// get |M_F|^2 Fermi decay matrix element
+	double getM2_F() const { return M2_F; }
+	/// get |M_GT|^2 Gamov-Teller decay matrix element
+	double getM2_GT() const { return M2_GT; }
 	
 	/// shape correction to basic phase space
 	double spectrumCorrectionFactor(double W) const;
 	
 	/// decay probability at given KE
 	double decayProb(double KE) const;
+	/// spectrumCorrectionFactor from table shared by all generators with the same parameters, looked up on first use after parameter changes
+	double spectrumCorrectionFactorTab(double W) const;
+	
+	/// get number of nucleons
+	double getA() const { return A; }
+	/// get number of protons
+	double getZ() const { return Z; }
+	/// get endpoint kinetic energy, keV
+	double getEP() const { return EP; }
+	/// get endpoint total energy, m_e*c^2
+	double getW0() const { return W0; }
+	/// get effective nuclear radius
+	double getR() const { return R; }
+	/// get nuclear mass, m_e*c^2
+	double getM0() const { return M0; }
+	
+	bool useTable;			///< whether decayProb uses tabulated corrections
 	
+protected:
 	double A;				///< number of nucleons
 	double Z;				///< number of protons
 	double EP;				///< endpoint kinetic energy, keV
@@ -102,6 +172,7 @@ public:
 	unsigned int forbidden;	///< "forbidden" level of decay
 	double M2_F;			///< |M_F|^2 Fermi decay matrix element
 	double M2_GT;			///< |M_GT|^2 Gamov-Teller decay matrix element
+	mutable std::atomic<const CorrectionTable*> table;	///< tabulated corrections for current parameters (NULL until looked up)
 };
 
 
@@ -121,5 +192,9 @@ double WilkinsonACorrection(double W);
 inline double asymmetryCorrectionFactor(double KE) { double W = (KE+m_e)/m_e; return 1.0+WilkinsonACorrection(W)+shann_h_minus_g_a2pi(W); }
 /// corrected asymmetry
 inline double correctedAsymmetry(double KE, double costheta=0.5) { return plainAsymmetry(KE,costheta)*asymmetryCorrectionFactor(KE); }
+/// tabulated (fast) asymmetryCorrectionFactor
+double asymmetryCorrectionFactorTab(double KE);
+/// corrected asymmetry, from tabulated corrections
+inline double correctedAsymmetryTab(double KE, double costheta=0.5) { return plainAsymmetry(KE,costheta)*asymmetryCorrectionFactorTab(KE); }
 
 #endif
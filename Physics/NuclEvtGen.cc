@@ -6,17 +6,65 @@
 #include <cfloat>
 #include <stdlib.h>
 #include <algorithm>
+#include <mutex>
 #include <TRandom.h>
 
+/// per-thread replacement for gRandom in event generation
+static thread_local TRandom* evtGenRandom = NULL;
+
+void setEvtGenRandom(TRandom* r) { evtGenRandom = r; }
+
+/// random generator for event generation in current thread
+static inline TRandom* evtRandom() { return evtGenRandom ? evtGenRandom : gRandom; }
+
+/// lock for building alias tables on first use by concurrent selections
+static std::mutex aliasLock;
+
+void PSelector::buildAlias() const {
+	std::lock_guard<std::mutex> lk(aliasLock);
+	if(aliasValid.load(std::memory_order_relaxed)) return;
+	const unsigned int n = getN();
+	smassert(n && cumprob.back() > 0);
+	aliasTable.resize(n);
+	// Vose's method: split scaled probabilities into under- and over-full columns, pairing each under-full with an over-full donor
+	std::vector<double> q(n);
+	std::vector<unsigned int> small, large;
+	for(unsigned int i=0; i<n; i++) {
+		q[i] = (cumprob[i+1]-cumprob[i])*n/cumprob.back();
+		if(q[i] < 1) small.push_back(i);
+		else large.push_back(i);
+	}
+	while(small.size() && large.size()) {
+		unsigned int s = small.back(); small.pop_back();
+		unsigned int l = large.back();
+		aliasTable[s].prob = q[s];
+		aliasTable[s].alias = l;
+		q[l] -= 1-q[s];
+		if(q[l] < 1) { large.pop_back(); small.push_back(l); }
+	}
+	// remaining columns are full (up to rounding)
+	for(std::vector<unsigned int>::const_iterator it = large.begin(); it != large.end(); it++) { aliasTable[*it].prob = 1; aliasTable[*it].alias = *it; }
+	for(std::vector<unsigned int>::const_iterator it = small.begin(); it != small.end(); it++) { aliasTable[*it].prob = 1; aliasTable[*it].alias = *it; }
+	aliasValid.store(true, std::memory_order_release);
+}
+
 unsigned int PSelector::select(double* x) const {
-	static double rnd_tmp;
-	if(!x) { x=&rnd_tmp; rnd_tmp=gRandom->Uniform(0,cumprob.back()); }
-	else { smassert(0. <= *x && *x <= 1.); (*x) *= cumprob.back(); }
-	std::vector<double>::const_iterator itsel = std::upper_bound(cumprob.begin(),cumprob.end(),*x);
-	unsigned int selected = (unsigned int)(itsel-cumprob.begin()-1);
-	smassert(selected<cumprob.size()-1);
-	(*x) = ((*x) - cumprob[selected])/(cumprob[selected+1]-cumprob[selected]);
-	return selected;
+	if(!aliasValid.load(std::memory_order_acquire)) buildAlias();
+	double u;
+	if(!x) u = evtRandom()->Uniform(0,1);
+	else { smassert(0. <= *x && *x <= 1.); u = *x; }
+	const unsigned int n = aliasTable.size();
+	double un = u*n;
+	unsigned int i = (unsigned int)un;
+	if(i >= n) i = n-1;
+	const double f = un-i;
+	const aliasEntry& a = aliasTable[i];
+	if(f < a.prob || a.prob >= 1) {
+		if(x) (*x) = f/a.prob;
+		return i;
+	}
+	if(x) (*x) = (f-a.prob)/(1-a.prob);
+	return a.alias;
 }
 
 void PSelector::scale(double s) {
@@ -48,8 +96,8 @@ DecayType particleType(const std::string& s) {
 }
 
 void randomDirection(double& x, double& y, double& z, double* rnd) {
-	double phi = 2.0*M_PI*(rnd?rnd[1]:gRandom->Uniform(0,1));
-	double costheta = 2.0*(rnd?rnd[0]:gRandom->Uniform(0,1))-1.0;
+	double phi = 2.0*M_PI*(rnd?rnd[1]:evtRandom()->Uniform(0,1));
+	double costheta = 2.0*(rnd?rnd[0]:evtRandom()->Uniform(0,1))-1.0;
 	double sintheta = sqrt(1.0-costheta*costheta);
 	x = cos(phi)*sintheta;
 	y = sin(phi)*sintheta;
@@ -99,7 +147,7 @@ void DecayAtom::load(const Stringmap& m) {
 }
 
 void DecayAtom::genAuger(std::vector<NucDecayEvent>& v) {
-	if(gRandom->Uniform(0,1) > pAuger) return;
+	if(evtRandom()->Uniform(0,1) > pAuger) return;
 	NucDecayEvent evt;
 	evt.d = D_ELECTRON;
 	evt.E = Eauger;
@@ -234,11 +282,11 @@ void ConversionGamma::scale(double s) {
 BetaDecayTrans::BetaDecayTrans(NucLevel& f, NucLevel& t, bool pstrn, unsigned int forbidden):
 TransitionBase(f,t), positron(pstrn), BSG(to.A,to.Z*(positron?-1:1),from.E-to.E),
 betaTF1((f.name+"-"+t.name+"_Beta").c_str(),this,&BetaDecayTrans::evalBeta,0,1,0) {
-	BSG.forbidden = forbidden;
+	BSG.setForbidden(forbidden);
 	betaTF1.SetNpx(1000);
 	betaTF1.SetRange(0,from.E-to.E);
-	if(from.jpi==to.jpi) { BSG.M2_F = 1; BSG.M2_GT = 0; }
-	else { BSG.M2_GT = 1; BSG.M2_F = 0; } // TODO not strictly true; need more general mechanism to fix
+	if(from.jpi==to.jpi) BSG.setMatrixElements(1,0);
+	else BSG.setMatrixElements(0,1); // TODO not strictly true; need more general mechanism to fix
 	betaQuantiles = new TF1_Quantiles(betaTF1);
 }
 
@@ -248,7 +296,7 @@ BetaDecayTrans::~BetaDecayTrans() {
 
 void BetaDecayTrans::display(bool verbose) const {
 	printf("Beta(%.1f) ",from.E-to.E);
-	if(BSG.forbidden) printf("%u-forbidden F=%g GT=%g ", BSG.forbidden, BSG.M2_F, BSG.M2_GT);
+	if(BSG.getForbidden()) printf("%u-forbidden F=%g GT=%g ", BSG.getForbidden(), BSG.getM2_F(), BSG.getM2_GT());
 	TransitionBase::display(verbose);
 }
 
@@ -266,7 +314,7 @@ double BetaDecayTrans::evalBeta(double* x, double*) { return BSG.decayProb(x[0])
 //-----------------------------------------
 
 void ECapture::run(std::vector<NucDecayEvent>&, double*) {
-	isKCapt = gRandom->Uniform(0,1) < toAtom->IMissing;
+	isKCapt = evtRandom()->Uniform(0,1) < toAtom->IMissing;
 }
 
 //-----------------------------------------
@@ -332,8 +380,7 @@ NucDecaySystem::NucDecaySystem(const QFile& Q, const BindingEnergyLibrary& B, do
 										it->getDefault("forbidden",0));
 		BD->Itotal = it->getDefault("I",0)/100.0;
 		if(it->count("M2_F") || it->count("M2_GT")) {
-			BD->BSG.M2_F = it->getDefault("M2_F",0);
-			BD->BSG.M2_GT = it->getDefault("M2_GT",0);
+			BD->BSG.setMatrixElements(it->getDefault("M2_F",0),it->getDefault("M2_GT",0));
 		}
 		addTransition(BD);
 	}
@@ -555,7 +602,7 @@ GammaForest::GammaForest(const std::string& fname, double E2keV) {
 }
 
 void GammaForest::genDecays(std::vector<NucDecayEvent>& v, double n) {
-	while(n>=1. || gRandom->Uniform(0,1)<n) {
+	while(n>=1. || evtRandom()->Uniform(0,1)<n) {
 		NucDecayEvent evt;
 		evt.d = D_GAMMA;
 		evt.t = 0;
@@ -577,12 +624,12 @@ void square2circle(double& x, double& y, double r) {
 
 void CubePosGen::genPos(double* v, double* rnd) const {
 	for(AxisDirection d = X_DIRECTION; d <= Z_DIRECTION; ++d)
-		v[d] = rnd?rnd[d]:gRandom->Uniform(0,1);
+		v[d] = rnd?rnd[d]:evtRandom()->Uniform(0,1);
 }
 
 void CylPosGen::genPos(double* v, double* rnd) const {
 	for(AxisDirection d = X_DIRECTION; d <= Z_DIRECTION; ++d)
-		v[d] = rnd?rnd[d]:gRandom->Uniform(0,1);
+		v[d] = rnd?rnd[d]:evtRandom()->Uniform(0,1);
 	square2circle(v[X_DIRECTION],v[Y_DIRECTION],r);
 	v[Z_DIRECTION] = (v[Z_DIRECTION]-0.5)*dz;
 }
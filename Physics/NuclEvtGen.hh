@@ -6,7 +6,9 @@
 #include "FloatErr.hh"
 #include "GraphUtils.hh"
 #include "TChainScanner.hh"
+#include "PSelector.hh"
 #include <TF1.h>
+#include <TRandom.h>
 #include <vector>
 #include <map>
 #include <set>
@@ -14,27 +16,8 @@
 #include <float.h>
 #include <stdio.h>
 
-/// random event selector
-class PSelector {
-public:
-	/// constructor
-	PSelector() { cumprob.push_back(0); }
-	/// add a probability
-	void addProb(double p) { cumprob.push_back(p+cumprob.back()); }
-	/// select partition for given input (random if not specified); re-scale input to partition range to pass along to sub-selections
-	unsigned int select(double* x = NULL) const;
-	/// get cumulative probability
-	double getCumProb() const { return cumprob.back(); }
-	/// get number of items
-	unsigned int getN() const { return cumprob.size()-1; }
-	/// get probability of numbered item
-	double getProb(unsigned int n) const;
-	/// scale all probabilities
-	void scale(double s);
-		
-protected:
-	std::vector<double> cumprob;	///< cumulative probabilites
-};
+/// set generator for random draws not supplied by the caller's rnd[] inputs, for event generation in calling thread (NULL for gRandom)
+void setEvtGenRandom(TRandom* r);
 
 /// generate an isotropic random direction, from optional random in [0,1]^2
 void randomDirection(double& x, double& y, double& z, double* rnd = NULL);
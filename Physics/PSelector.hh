@@ -0,0 +1,45 @@
+#ifndef PSELECTOR_HH
+#define PSELECTOR_HH
+
+#include <vector>
+#include <atomic>
+#include <stddef.h>
+
+/// random event selector
+class PSelector {
+public:
+	/// constructor
+	PSelector(): aliasValid(false) { cumprob.push_back(0); }
+	/// copy constructor
+	PSelector(const PSelector& S): cumprob(S.cumprob), aliasValid(false) { }
+	/// assignment
+	PSelector& operator=(const PSelector& S) { cumprob = S.cumprob; aliasValid = false; return *this; }
+	/// add a probability
+	void addProb(double p) { cumprob.push_back(p+cumprob.back()); aliasValid = false; }
+	/// select partition for given input (random if not specified); re-scale input to partition range to pass along to sub-selections
+	unsigned int select(double* x = NULL) const;
+	/// get cumulative probability
+	double getCumProb() const { return cumprob.back(); }
+	/// get number of items
+	unsigned int getN() const { return cumprob.size()-1; }
+	/// get probability of numbered item
+	double getProb(unsigned int n) const;
+	/// scale all probabilities
+	void scale(double s);
+		
+protected:
+	/// (re)build alias table from current probabilities
+	void buildAlias() const;
+	
+	/// alias table column
+	struct aliasEntry {
+		double prob;		///< probability of keeping column item (vs. alias)
+		unsigned int alias;	///< alternate item for column
+	};
+	
+	std::vector<double> cumprob;				///< cumulative probabilites
+	mutable std::vector<aliasEntry> aliasTable;	///< Walker/Vose alias table for O(1) selection
+	mutable std::atomic<bool> aliasValid;		///< whether alias table is up to date (release-stored after building)
+};
+
+#endif
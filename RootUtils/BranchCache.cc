@@ -0,0 +1,135 @@
+#include "BranchCache.hh"
+#include "SMExcept.hh"
+#include <TChain.h>
+#include <stdio.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+static const char branchCacheMagic[8] = {'B','R','C','A','C','H','E','1'};
+
+void BranchCache::build(const std::string& rootFile, const std::string& treeName, const std::vector<column>& cols, const std::string& fname) {
+	TChain ch(treeName.c_str());
+	if(!ch.Add(rootFile.c_str(),0)) {
+		SMExcept e("missingFiles");
+		e.insert("fileName",rootFile);
+		throw(e);
+	}
+	const uint32_t nEvts = ch.GetEntries();
+	const uint32_t nCols = cols.size();
+	printf("Building column cache '%s' (%i events)...\n",fname.c_str(),nEvts);
+	
+	// read only cached branches, into private buffers
+	std::vector< std::vector<char> > buf(nCols);
+	ch.SetBranchStatus("*",0);
+	for(uint32_t i=0; i<nCols; i++) {
+		buf[i].resize(cols[i].width);
+		ch.SetBranchStatus(cols[i].name.c_str(),1);
+		ch.SetBranchAddress(cols[i].name.c_str(),&buf[i][0]);
+	}
+	
+	// header: magic, nEvts, nCols, {name length, name, width, offset} per column
+	uint64_t pos = sizeof(branchCacheMagic)+2*sizeof(uint32_t);
+	for(uint32_t i=0; i<nCols; i++)
+		pos += 2*sizeof(uint32_t)+cols[i].name.size()+sizeof(uint64_t);
+	std::vector<uint64_t> offset(nCols);
+	for(uint32_t i=0; i<nCols; i++) {
+		pos = ((pos+63)/64)*64;
+		offset[i] = pos;
+		pos += (uint64_t)nEvts*cols[i].width;
+	}
+	
+	std::string tmpname = fname+".tmp";
+	FILE* f = fopen(tmpname.c_str(),"wb");
+	if(!f) {
+		SMExcept e("fileWriteError");
+		e.insert("fileName",tmpname);
+		throw(e);
+	}
+	fwrite(branchCacheMagic,sizeof(branchCacheMagic),1,f);
+	fwrite(&nEvts,sizeof(uint32_t),1,f);
+	fwrite(&nCols,sizeof(uint32_t),1,f);
+	for(uint32_t i=0; i<nCols; i++) {
+		uint32_t l = cols[i].name.size();
+		fwrite(&l,sizeof(uint32_t),1,f);
+		fwrite(cols[i].name.data(),1,l,f);
+		fwrite(&cols[i].width,sizeof(uint32_t),1,f);
+		fwrite(&offset[i],sizeof(uint64_t),1,f);
+	}
+	
+	// transpose in chunks of events
+	const uint32_t nChunk = 1<<14;
+	std::vector< std::vector<char> > chunk(nCols);
+	for(uint32_t i=0; i<nCols; i++) chunk[i].resize((size_t)nChunk*cols[i].width);
+	for(uint32_t e0 = 0; e0 < nEvts; e0 += nChunk) {
+		const uint32_t n = nEvts-e0 < nChunk ? nEvts-e0 : nChunk;
+		for(uint32_t j=0; j<n; j++) {
+			ch.GetEntry(e0+j);
+			for(uint32_t i=0; i<nCols; i++)
+				memcpy(&chunk[i][0]+(size_t)j*cols[i].width, &buf[i][0], cols[i].width);
+		}
+		for(uint32_t i=0; i<nCols; i++) {
+			fseeko(f, offset[i]+(uint64_t)e0*cols[i].width, SEEK_SET);
+			fwrite(&chunk[i][0], cols[i].width, n, f);
+		}
+	}
+	if(fclose(f) || rename(tmpname.c_str(),fname.c_str())) {
+		SMExcept e("fileWriteError");
+		e.insert("fileName",fname);
+		throw(e);
+	}
+}
+
+BranchCache::BranchCache(const std::string& fname, const std::vector<column>& c): cols(c), mapped(NULL), mapLen(0), nEvts(0) {
+	int fd = open(fname.c_str(),O_RDONLY);
+	if(fd < 0) return;
+	struct stat st;
+	if(!fstat(fd,&st) && st.st_size > 0) {
+		mapLen = st.st_size;
+		mapped = mmap(NULL,mapLen,PROT_READ,MAP_SHARED,fd,0);
+		if(mapped == MAP_FAILED) mapped = NULL;
+	}
+	close(fd);
+	if(!mapped) return;
+	
+	// parse header, locating each requested column
+	const char* d = (const char*)mapped;
+	const char* p = d;
+	const char* end = d+mapLen;
+	bool ok = mapLen >= sizeof(branchCacheMagic)+2*sizeof(uint32_t) && !memcmp(d,branchCacheMagic,sizeof(branchCacheMagic));
+	uint32_t nCols = 0;
+	if(ok) {
+		p += sizeof(branchCacheMagic);
+		memcpy(&nEvts,p,sizeof(uint32_t)); p += sizeof(uint32_t);
+		memcpy(&nCols,p,sizeof(uint32_t)); p += sizeof(uint32_t);
+	}
+	src.assign(cols.size(),(const char*)NULL);
+	for(uint32_t i=0; ok && i<nCols; i++) {
+		uint32_t l, w;
+		uint64_t o;
+		ok = (size_t)(end-p) >= sizeof(uint32_t);
+		if(!ok) break;
+		memcpy(&l,p,sizeof(uint32_t)); p += sizeof(uint32_t);
+		ok = (size_t)(end-p) >= l+sizeof(uint32_t)+sizeof(uint64_t);
+		if(!ok) break;
+		std::string nm(p,l); p += l;
+		memcpy(&w,p,sizeof(uint32_t)); p += sizeof(uint32_t);
+		memcpy(&o,p,sizeof(uint64_t)); p += sizeof(uint64_t);
+		ok = o+(uint64_t)nEvts*w <= mapLen;
+		for(unsigned int j=0; ok && j<cols.size(); j++)
+			if(cols[j].name == nm && cols[j].width == w) src[j] = d+o;
+	}
+	for(unsigned int j=0; ok && j<cols.size(); j++)
+		ok = src[j] || !nEvts;
+	if(!ok) {
+		munmap(mapped,mapLen);
+		mapped = NULL;
+		mapLen = 0;
+		nEvts = 0;
+	}
+}
+
+BranchCache::~BranchCache() {
+	if(mapped) munmap(mapped,mapLen);
+}
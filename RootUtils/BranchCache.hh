@@ -0,0 +1,48 @@
+#ifndef BRANCHCACHE_HH
+#define BRANCHCACHE_HH
+
+#include "Types.hh"
+#include <string>
+#include <vector>
+#include <string.h>
+#include <stdint.h>
+
+/// Columnar (struct-of-arrays) cache of fixed-size TTree branches for one input file: each branch is stored
+/// as a contiguous array of its raw read-point contents, memory-mapped on open. Filling the read points for an
+/// event is then a few memcpy's, with no ROOT decompression.
+class BranchCache: private NoCopy {
+public:
+	/// cached branch description
+	struct column {
+		std::string name;	///< branch name
+		void* dest;			///< read point to fill
+		uint32_t width;		///< bytes per event
+	};
+	
+	/// constructor, opening cache file and matching it to requested columns; check isValid() for success
+	BranchCache(const std::string& fname, const std::vector<column>& cols);
+	/// destructor
+	~BranchCache();
+	
+	/// write cache file for columns of named tree in ROOT file
+	static void build(const std::string& rootFile, const std::string& treeName, const std::vector<column>& cols, const std::string& fname);
+	
+	/// whether cache file was opened and matches requested columns
+	bool isValid() const { return mapped != NULL; }
+	/// number of events in cache
+	unsigned int nEvents() const { return nEvts; }
+	/// fill column read points for event e
+	void load(unsigned int e) const {
+		for(unsigned int i=0; i<cols.size(); i++)
+			memcpy(cols[i].dest, src[i]+(size_t)e*cols[i].width, cols[i].width);
+	}
+	
+protected:
+	std::vector<column> cols;		///< requested columns
+	std::vector<const char*> src;	///< data location for each requested column
+	void* mapped;					///< memory-mapped file
+	size_t mapLen;					///< length of mapped region
+	uint32_t nEvts;					///< number of events
+};
+
+#endif
@@ -0,0 +1,78 @@
+#include "BulkRandom.hh"
+#include "SMExcept.hh"
+#include <cmath>
+
+BulkRandom::BulkRandom(TRandom* r, unsigned int nbuf): R(r), u(nbuf), i(nbuf) {
+	smassert(R && nbuf);
+}
+
+void BulkRandom::refill() {
+	R->RndmArray(u.size(),&u[0]);
+	// guard against exact 0 from sources returning [0,1)
+	for(std::vector<double>::iterator it = u.begin(); it != u.end(); it++)
+		if(!(*it > 0)) *it = 0.5/4294967296.;
+	i = 0;
+}
+
+void BulkRandom::uniform(double* v, unsigned int n) {
+	while(n) {
+		if(i == u.size()) refill();
+		unsigned int m = u.size()-i;
+		if(m > n) m = n;
+		for(unsigned int k=0; k<m; k++) v[k] = u[i+k];
+		i += m;
+		v += m;
+		n -= m;
+	}
+}
+
+void BulkRandom::gaus(double* v, unsigned int n) {
+	uniform(v,n);
+	// Box-Muller on pairs of uniforms
+	for(unsigned int k=0; k+1<n; k+=2) {
+		double r = sqrt(-2.*log(v[k]));
+		double a = 2*M_PI*v[k+1];
+		v[k] = r*cos(a);
+		v[k+1] = r*sin(a);
+	}
+	if(n%2) v[n-1] = sqrt(-2.*log(v[n-1]))*cos(2*M_PI*uniform());
+}
+
+double BulkRandom::poisson(double mu) {
+	if(!(mu > 0)) return 0;
+	if(mu < 10) {
+		// inversion by sequential search, until terms underflow; redraw if x lands in the rounding gap below 1
+		while(true) {
+			double p = exp(-mu);
+			double F = p;
+			double x = uniform();
+			unsigned int k = 0;
+			while(x > F && p > 0) {
+				k++;
+				p *= mu/k;
+				F += p;
+			}
+			if(x <= F) return k;
+		}
+	}
+	// PTRS (W. Hormann, Insurance: Mathematics and Economics 12, 39 (1993))
+	const double slam = sqrt(mu);
+	const double loglam = log(mu);
+	const double b = 0.931 + 2.53*slam;
+	const double a = -0.059 + 0.02483*b;
+	const double invalpha = 1.1239 + 1.1328/(b-3.4);
+	const double vr = 0.9277 - 3.6224/(b-2);
+	while(true) {
+		double U = uniform()-0.5;
+		double V = uniform();
+		double us = 0.5-fabs(U);
+		double k = floor((2*a/us + b)*U + mu + 0.43);
+		if(us >= 0.07 && V <= vr) return k;
+		if(k < 0 || (us < 0.013 && V > us)) continue;
+		if(log(V) + log(invalpha) - log(a/(us*us)+b) <= -mu + k*loglam - lgamma(k+1)) return k;
+	}
+}
+
+void BulkRandom::poisson(const double* mu, double* v, unsigned int n) {
+	for(unsigned int k=0; k<n; k++) v[k] = poisson(mu[k]);
+}
@@ -0,0 +1,36 @@
+#ifndef BULKRANDOM_HH
+#define BULKRANDOM_HH
+
+#include <TRandom.h>
+#include <vector>
+
+/// Buffered bulk random variates: uniforms are drawn from a TRandom a block at a time (RndmArray),
+/// then transformed in tight loops to Gaussian (Box-Muller) or Poisson variates (inversion for means below 10,
+/// Hormann's PTRS transformed rejection, exact for any larger mean), without a virtual generator call per draw.
+/// The source TRandom is advanced in whole buffer-fills, so results depend only on its state when filled.
+class BulkRandom {
+public:
+	/// constructor, with uniform source and buffer size
+	BulkRandom(TRandom* r, unsigned int nbuf = 4096);
+	
+	/// uniform random number on (0,1)
+	double uniform() { if(i == u.size()) refill(); return u[i++]; }
+	/// fill array with uniform random numbers on (0,1)
+	void uniform(double* v, unsigned int n);
+	/// fill array with normal (mean 0, sigma 1) random numbers
+	void gaus(double* v, unsigned int n);
+	/// Poisson random number with mean mu (0 for mu <= 0)
+	double poisson(double mu);
+	/// fill array with Poisson random numbers for means mu[n]
+	void poisson(const double* mu, double* v, unsigned int n);
+	
+protected:
+	/// refill uniforms buffer from source
+	void refill();
+	
+	TRandom* R;				///< uniform random source
+	std::vector<double> u;	///< buffered uniforms
+	unsigned int i;			///< next buffered uniform
+};
+
+#endif
@@ -0,0 +1,22 @@
+#include "CounterRNG.hh"
+
+ULong64_t CounterRNG::mix64(ULong64_t z) {
+	z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+	z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+	return z ^ (z >> 31);
+}
+
+void CounterRNG::setStream(UInt_t run, ULong64_t evt, UInt_t sub) {
+	key = mix64(baseSeed + 0x9E3779B97F4A7C15ULL);
+	key = mix64(key ^ run);
+	key = mix64(key ^ evt);
+	key = mix64(key ^ sub);
+	ctr = 0;
+}
+
+void CounterRNG::RndmArray(Int_t n, Float_t* array) {
+	for(Int_t i=0; i<n; i++) {
+		// reject values that round up to 1 in single precision
+		do { array[i] = toDouble(next()); } while(array[i] >= 1.f);
+	}
+}
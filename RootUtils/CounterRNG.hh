@@ -0,0 +1,49 @@
+#ifndef COUNTERRNG_HH
+#define COUNTERRNG_HH
+
+#include <TRandom.h>
+#include <RVersion.h>
+
+/// Counter-based random number generator: the n^th draw of a stream is a pure function of (stream key, n),
+/// so any stream can be regenerated independently of all others (e.g. per-event streams for parallel simulation).
+/// Plugs in anywhere a TRandom is used (Uniform, Gaus, PoissonD, ... all draw through Rndm()).
+class CounterRNG: public TRandom {
+public:
+	/// constructor, with base seed
+	CounterRNG(ULong64_t s = 0): TRandom(0), baseSeed(s), key(0), ctr(0) { setStream(0,0); }
+
+	/// set base seed mixed into all stream keys; resets to stream (0,0)
+	void setBaseSeed(ULong64_t s) { baseSeed = s; setStream(0,0); }
+	/// get base seed
+	ULong64_t getBaseSeed() const { return baseSeed; }
+	/// select stream for (run, event, sub-event) under current base seed, restarting its draw counter
+	void setStream(UInt_t run, ULong64_t evt, UInt_t sub = 0);
+	/// number of draws taken from current stream
+	ULong64_t getCounter() const { return ctr; }
+
+	/// uniform random number on (0,1)
+#if ROOT_VERSION_CODE >= ROOT_VERSION(6,0,0)
+	virtual Double_t Rndm() { return toDouble(next()); }
+#else
+	virtual Double_t Rndm(Int_t = 0) { return toDouble(next()); }
+#endif
+	/// fill array with uniform random numbers on (0,1)
+	virtual void RndmArray(Int_t n, Double_t* array) { for(Int_t i=0; i<n; i++) array[i] = toDouble(next()); }
+	/// fill array with uniform random numbers on (0,1)
+	virtual void RndmArray(Int_t n, Float_t* array);
+
+	/// 64-bit integer mixing function (SplitMix64 finalizer)
+	static ULong64_t mix64(ULong64_t z);
+
+protected:
+	/// next 64 random bits from current stream
+	ULong64_t next() { return mix64(key + mix64((++ctr)*0x9E3779B97F4A7C15ULL)); }
+	/// convert 64 random bits to double on (0,1)
+	static Double_t toDouble(ULong64_t x) { return ((x >> 11) + 0.5) * (1.0/9007199254740992.0); }
+
+	ULong64_t baseSeed;	///< base seed for all streams
+	ULong64_t key;		///< current stream key
+	ULong64_t ctr;		///< draws taken from current stream
+};
+
+#endif
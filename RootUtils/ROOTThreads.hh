@@ -0,0 +1,7 @@
+#ifndef ROOTTHREADS_HH
+#define ROOTTHREADS_HH
+
+/// enable ROOT internal locking for multithreaded use (call from main thread before starting workers)
+void enableROOTThreads();
+
+#endif
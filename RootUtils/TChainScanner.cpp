@@ -1,11 +1,12 @@
 #include "TChainScanner.hh"
 #include "SMExcept.hh"
+#include "CounterRNG.hh"
 #include <stdlib.h>
 #include <time.h>
 #include <SMExcept.hh>
 
 TChainScanner::TChainScanner(const std::string& treeName): nEvents(0), nFiles(0), Tch(new TChain(treeName.c_str())),
-currentEvent(0), noffset(0), nLocalEvents(0) {
+currentEvent(0), noffset(0), nLocalEvents(0), startSeed(0), nRandomStarts(0) {
 	Tch->SetMaxVirtualSize(10000000);
 }
 
@@ -26,6 +27,7 @@ int TChainScanner::addFile(const std::string& filename) {
 		e.insert("nFiles",nfAdded);
 		throw e;
 	}
+	fileNames.push_back(filename);
 	if(!nFiles)
 		setReadpoints();
 	nFiles+=nfAdded;
@@ -47,8 +49,12 @@ void TChainScanner::startScan(bool startRandom) {
 	}
 	if(startRandom) {
 		if(!currentEvent) {
-			srand(time(NULL));	// random random seed
-			gotoEvent(rand()%Tch->GetEntries());
+			if(startSeed) {
+				gotoEvent(CounterRNG::mix64(startSeed+CounterRNG::mix64(++nRandomStarts))%nEvents);
+			} else {
+				srand(time(NULL));	// random random seed
+				gotoEvent(rand()%nEvents);
+			}
 			printf("Scan Starting at offset %i/%i: ",currentEvent,nEvents);
 		} else {
 			printf("Scan Continuing at offset %i/%i: ",currentEvent,nEvents);
@@ -18,6 +18,8 @@ public:
 	
 	/// start a "speed scan," possibly at a random entry number
 	virtual void startScan(bool startRandom = false);
+	/// set seed for reproducible random scan starting points (0 for clock-seeded)
+	void setStartSeed(ULong64_t s) { startSeed = s; nRandomStarts = 0; }
 	/// jump scanner to specified event
 	virtual void gotoEvent(unsigned int e);
 	/// load identified "speed scan" point
@@ -36,6 +38,10 @@ public:
 	unsigned int getLocal(unsigned int e) { return Tch->LoadTree(e); }
 	/// get number of files
 	virtual unsigned int getnFiles() const { return nFiles; }
+	/// get list of file names (as passed to addFile)
+	const std::vector<std::string>& getFileNames() const { return fileNames; }
+	/// get number of events in each added file
+	const std::vector<unsigned int>& getFileEvents() const { return nnEvents; }
 		
 	UInt_t nEvents;						///< number of events in current TChain
 	
@@ -47,12 +53,15 @@ protected:
 	void SetBranchAddress(const std::string& bname, void* bdata);
 	
 	std::vector<unsigned int> nnEvents;	///< number of events in each loaded TChain;
+	std::vector<std::string> fileNames;	///< file names added to TChain
 	unsigned int nFiles;				///< get number of loaded files
 	
 	TChain* Tch;						///< TChain of relevant runs
 	unsigned int currentEvent;			///< event number of current event in chain
 	unsigned int noffset;				///< offset of current event relative to currently loaded tree
 	unsigned int nLocalEvents;			///< number of events in currently loaded tree
+	ULong64_t startSeed;				///< seed for random scan starting points (0 for clock-seeded)
+	unsigned int nRandomStarts;			///< number of random starting points drawn from startSeed
 };
 
 #endif
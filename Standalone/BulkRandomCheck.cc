@@ -0,0 +1,54 @@
+#include "BulkRandom.hh"
+#include <TRandom3.h>
+#include <vector>
+#include <stdio.h>
+#include <math.h>
+
+/// mean and RMS accumulator
+struct MomentSum {
+	MomentSum(): n(0), s(0), s2(0) {}
+	void fill(double x) { n++; s += x; s2 += x*x; }
+	double mean() const { return s/n; }
+	double var() const { return s2/n - mean()*mean(); }
+	double n, s, s2;
+};
+
+/// z-score for difference of means between two samples
+double zMean(const MomentSum& a, const MomentSum& b) {
+	double e = sqrt(a.var()/a.n + b.var()/b.n);
+	return e > 0 ? (a.mean()-b.mean())/e : 0;
+}
+
+/// approximate z-score for ratio of variances between two samples (assuming near-normal distributions)
+double zVar(const MomentSum& a, const MomentSum& b) {
+	if(!(a.var() > 0 && b.var() > 0)) return 0;
+	return log(a.var()/b.var())/sqrt(2./a.n + 2./b.n);
+}
+
+/// compare BulkRandom Poisson and Gaussian variates against TRandom
+int main(int, char**) {
+	TRandom3 R(12345);
+	const unsigned int nDraw = 200000;
+	const double mus[] = {0.3, 3, 9.99, 10, 25, 100, 3000, 1e5, 1e8};
+	bool ok = true;
+	BulkRandom B(&R);
+	printf("%8s %10s %10s %8s %8s\n","mu","mean","var","z(mean)","z(var)");
+	for(unsigned int m=0; m<sizeof(mus)/sizeof(mus[0]); m++) {
+		MomentSum a, b;
+		for(unsigned int i=0; i<nDraw; i++) {
+			a.fill(B.poisson(mus[m]));
+			b.fill(R.PoissonD(mus[m]));
+		}
+		double zm = zMean(a,b), zv = zVar(a,b);
+		printf("%8g %10.4g %10.4g %8.2f %8.2f\n",mus[m],a.mean(),a.var(),zm,zv);
+		if(fabs(zm) > 5 || fabs(zv) > 5) ok = false;
+	}
+	std::vector<double> g(nDraw);
+	B.gaus(&g[0],nDraw);
+	MomentSum a;
+	for(unsigned int i=0; i<nDraw; i++) a.fill(g[i]);
+	printf("%8s %10.4g %10.4g\n","gaus",a.mean(),a.var());
+	if(fabs(a.mean())*sqrt(nDraw) > 5 || fabs(a.var()-1)*sqrt(nDraw/2.) > 5) ok = false;
+	printf(ok?"Bulk random variates statistically consistent with TRandom.\n":"*** Bulk random variates inconsistent with TRandom! ***\n");
+	return ok?0:1;
+}
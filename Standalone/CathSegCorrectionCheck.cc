@@ -0,0 +1,65 @@
+#include "CathSegCalibrator.hh"
+#include <TRandom.h>
+#include <TStopwatch.h>
+#include <algorithm>
+#include <stdio.h>
+#include <math.h>
+
+/// fill calibrator with nc random smooth coefficient curves, with knots every dk keV up to 1000 keV
+void makeCoeffs(CathSegCalibrator& C, unsigned int nc, double dk) {
+	for(unsigned int i=0; i<nc; i++) {
+		unsigned int nk = (unsigned int)(1000/dk)+1;
+		TGraph* g = new TGraph(nk);
+		double a = gRandom->Gaus(0,0.1)/(1+i/2);
+		double l = gRandom->Uniform(100,400);
+		for(unsigned int k=0; k<nk; k++)
+			g->SetPoint(k,k*dk,a*(1+exp(-(k*dk)/l))+gRandom->Gaus(0,0.005));
+		C.pcoeffs.push_back(g);
+	}
+}
+
+/// compare compiled CathSegCorrection against CathSegCalibrator::adjustPos, for accuracy and speed
+int main(int, char**) {
+	const unsigned int nEvt = 1<<18;
+	std::vector<float> x0(nEvt), E(nEvt), x(nEvt);
+	for(unsigned int i=0; i<nEvt; i++) {
+		x0[i] = gRandom->Uniform(-0.5,0.5);
+		E[i] = gRandom->Uniform(-50,1100);	// include clamped energies
+	}
+
+	bool ok = true;
+	const unsigned int nCoeffs[] = {0, 1, 4, 7, 12};
+	const double knots[] = {50, 37};	// grid-aligned and unaligned coefficient knots
+	printf("%4s %6s %12s %12s %12s %8s\n","nc","knots","max dev","ref [M/s]","batch [M/s]","speedup");
+	for(unsigned int k=0; k<sizeof(knots)/sizeof(knots[0]); k++) {
+		for(unsigned int c=0; c<sizeof(nCoeffs)/sizeof(nCoeffs[0]); c++) {
+			CathSegCalibrator C;
+			makeCoeffs(C,nCoeffs[c],knots[k]);
+			CathSegCorrection CC(C);
+
+			double maxdev = 0;
+			for(unsigned int i=0; i<nEvt; i+=64) {
+				double d = fabs(CC.adjustPos(x0[i],E[i])-C.adjustPos(x0[i],E[i]));
+				maxdev = std::max(maxdev, d==d ? d : HUGE_VAL);
+			}
+
+			TStopwatch W;
+			double xsum = 0;
+			for(unsigned int i=0; i<nEvt; i++) xsum += C.adjustPos(x0[i],E[i]);
+			W.Stop();
+			double tRef = W.CpuTime();
+			W.Start(true);
+			CC.adjustPos(nEvt,&x0[0],&E[0],&x[0]);
+			W.Stop();
+			double tBatch = W.CpuTime();
+			for(unsigned int i=0; i<nEvt; i++) xsum -= x[i];
+
+			printf("%4u %6g %12.3g %12.1f %12.1f %8.2f\n", nCoeffs[c], knots[k], maxdev,
+				   nEvt/tRef*1e-6, nEvt/tBatch*1e-6, tRef/tBatch);
+			// exact up to rounding when knots fall on table grid; otherwise, interpolation error well under wire spacing
+			if(maxdev > (knots[k]==50 ? 1e-9 : 1e-3)) ok = false;
+		}
+	}
+	printf(ok?"CathSegCorrection agrees with CathSegCalibrator.\n":"*** CathSegCorrection disagrees with CathSegCalibrator! ***\n");
+	return ok?0:1;
+}
@@ -0,0 +1,136 @@
+#include "Fierz/FierzFitter.hh"
+#include "Fierz/FierzFitEngine.hh"
+#include <TRandom.h>
+#include <TStopwatch.h>
+#include <algorithm>
+#include <stdio.h>
+#include <math.h>
+
+const double trueA = -0.1184;	///< toy asymmetry
+const double trueB = 0.05;		///< toy Fierz term
+const double trueN = 1e6;		///< toy spectrum counts in fit range
+const double fitMin = 150;		///< fit range lower limit [keV]
+const double fitMax = 700;		///< fit range upper limit [keV]
+
+/// fill engine with toy asymmetry, spectrum (Poisson counts, or Gaussian errors from expected counts if gaussErr) and ratio data
+void makeToy(FierzFitEngine& FE, bool gaussErr) {
+	std::vector<double> E, v, err;
+	for(double e = 105; e < 800; e += 10) {
+		const double u = m_e/(e+m_e);
+		E.push_back(e);
+		v.push_back(trueA/(1+trueB*u)+gRandom->Gaus(0,0.003));
+		err.push_back(0.003);
+	}
+	FE.setAsymmetryData(E,v,err);
+
+	const std::vector<double>& S = FE.getSMBasis();
+	const std::vector<double>& F = FE.getFierzBasis();
+	double Stot = 0, Ftot = 0;
+	for(unsigned int i=0; i<FE.getNBins(); i++) {
+		if(FE.binCenter(i) <= fitMin || FE.binCenter(i) >= fitMax) continue;
+		Stot += S[i];
+		Ftot += F[i];
+	}
+	std::vector<double> n(FE.getNBins()), nerr;
+	for(unsigned int i=0; i<FE.getNBins(); i++) {
+		const double mu = trueN*(S[i]+trueB*F[i])/(Stot+trueB*Ftot);
+		n[i] = gRandom->Poisson(mu);
+		if(gaussErr) nerr.push_back(sqrt(std::max(mu,1.)));
+	}
+	FE.setSpectrumData(n,nerr);
+
+	const double xbar = FierzFitEngine::spectrumMoment(0,1,fitMin,fitMax);
+	for(unsigned int i=0; i<E.size(); i++) {
+		const double u = m_e/(E[i]+m_e);
+		v[i] = (1+trueB*u)/(1+trueB*xbar)+gRandom->Gaus(0,0.005);
+		err[i] = 0.005;
+	}
+	FE.setRatioData(E,v,err,xbar);
+}
+
+/// check FierzFitEngine analytic gradients against finite differences, toy fit pulls, profile chi^2 and timing
+int main(int, char**) {
+	bool ok = true;
+	const char* pnames[FierzFitEngine::FIT_NPARAMS] = {"A","b","N"};
+
+	for(unsigned int gaussErr = 0; gaussErr < 2; gaussErr++) {
+		printf("\n---- spectrum %s ----\n", gaussErr?"Gaussian chi^2":"Poisson deviance");
+		FierzFitEngine FE(0,1000,100);
+		FE.setTheoryBasis();
+		FE.setRange(fitMin,fitMax);
+		makeToy(FE,gaussErr);
+
+		// analytic gradient vs. central finite differences, around the true parameters
+		double maxdev[FierzFitEngine::FIT_NPARAMS] = {0,0,0};
+		const double h[FierzFitEngine::FIT_NPARAMS] = {1e-6, 1e-5, 1e-2};
+		for(unsigned int k=0; k<50; k++) {
+			double p[FierzFitEngine::FIT_NPARAMS] = {trueA+gRandom->Gaus(0,0.01), trueB+gRandom->Gaus(0,0.1), trueN*(1+gRandom->Gaus(0,0.01))};
+			double g[FierzFitEngine::FIT_NPARAMS], H[FierzFitEngine::FIT_NPARAMS*FierzFitEngine::FIT_NPARAMS];
+			FE.eval(p,g,H);
+			for(unsigned int i=0; i<FierzFitEngine::FIT_NPARAMS; i++) {
+				double pp[FierzFitEngine::FIT_NPARAMS], pm[FierzFitEngine::FIT_NPARAMS];
+				std::copy(p,p+FierzFitEngine::FIT_NPARAMS,pp);
+				std::copy(p,p+FierzFitEngine::FIT_NPARAMS,pm);
+				pp[i] += h[i];
+				pm[i] -= h[i];
+				const double fd = (FE.eval(pp)-FE.eval(pm))/(2*h[i]);
+				// deviation relative to gradient scale sqrt(Fisher information) of one-sigma chi^2 change
+				maxdev[i] = std::max(maxdev[i], fabs(g[i]-fd)/(fabs(fd)+sqrt(H[i*FierzFitEngine::FIT_NPARAMS+i])));
+			}
+		}
+		for(unsigned int i=0; i<FierzFitEngine::FIT_NPARAMS; i++) {
+			printf("d chi^2/d%s: max relative deviation from finite difference %.2g\n", pnames[i], maxdev[i]);
+			if(!(maxdev[i] < 1e-4)) ok = false;
+		}
+
+		// toy fit pulls
+		const unsigned int nToys = 1000;
+		double pullSum[2] = {0,0}, pullSum2[2] = {0,0};
+		TStopwatch W;
+		double tFit = 0;
+		for(unsigned int t=0; t<nToys; t++) {
+			FierzFitEngine FT(0,1000,100);
+			FT.setTheoryBasis();
+			FT.setRange(fitMin,fitMax);
+			makeToy(FT,gaussErr);
+			double p[FierzFitEngine::FIT_NPARAMS] = {-0.1, 0, 0};
+			double cov[FierzFitEngine::FIT_NPARAMS*FierzFitEngine::FIT_NPARAMS];
+			W.Start(true);
+			FT.fit(p,cov);
+			W.Stop();
+			tFit += W.CpuTime();
+			const double pull[2] = { (p[FierzFitEngine::FIT_A]-trueA)/sqrt(cov[0]), (p[FierzFitEngine::FIT_B]-trueB)/sqrt(cov[4]) };
+			for(unsigned int i=0; i<2; i++) { pullSum[i] += pull[i]; pullSum2[i] += pull[i]*pull[i]; }
+		}
+		for(unsigned int i=0; i<2; i++) {
+			const double mu = pullSum[i]/nToys;
+			const double rms = sqrt(pullSum2[i]/nToys-mu*mu);
+			printf("%s pulls over %u toys: mean %.3f, rms %.3f\n", pnames[i], nToys, mu, rms);
+			if(!(fabs(mu) < 0.15 && fabs(rms-1) < 0.1)) ok = false;	// ~4.5 sigma statistical tolerance
+		}
+		printf("fit time %.3g ms\n", 1e3*tFit/nToys);
+
+		// profile chi^2 rises by 1 at one sigma in b, minimizing over A (and N)
+		double p[FierzFitEngine::FIT_NPARAMS] = {-0.1, 0, 0};
+		double cov[FierzFitEngine::FIT_NPARAMS*FierzFitEngine::FIT_NPARAMS];
+		const double c2min = FE.fit(p,cov);
+		const double sA = sqrt(cov[0]), sb = sqrt(cov[4]);
+		for(int sgn = -1; sgn <= 1; sgn += 2) {
+			std::vector<double> c2;
+			FE.profileScan(p[FierzFitEngine::FIT_A]-3*sA, p[FierzFitEngine::FIT_A]+3*sA, 601, p[FierzFitEngine::FIT_B]+sgn*sb, 0, 1, c2);
+			const double dc2 = *std::min_element(c2.begin(),c2.end()) - c2min;
+			printf("profile delta chi^2 at b %+i sigma: %.3f\n", sgn, dc2);
+			if(!(fabs(dc2-1) < 0.05)) ok = false;
+		}
+
+		// profile scan timing
+		W.Start(true);
+		std::vector<double> c2;
+		FE.profileScan(p[FierzFitEngine::FIT_A]-3*sA, p[FierzFitEngine::FIT_A]+3*sA, 101, p[FierzFitEngine::FIT_B]-3*sb, p[FierzFitEngine::FIT_B]+3*sb, 101, c2);
+		W.Stop();
+		printf("101x101 profile scan time %.3g ms\n", 1e3*W.CpuTime());
+	}
+
+	printf(ok?"\nFierzFitEngine gradients and fits check out.\n":"\n*** FierzFitEngine check failed! ***\n");
+	return ok?0:1;
+}
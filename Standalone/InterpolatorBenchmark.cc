@@ -0,0 +1,133 @@
+#include "Interpolator.hh"
+#include "SectorCutter.hh"
+#include <TRandom3.h>
+#include <TStopwatch.h>
+#include <algorithm>
+#include <vector>
+#include <stdio.h>
+#include <math.h>
+
+/// largest relative difference between two arrays
+double maxRelDev(const std::vector<double>& a, const std::vector<double>& b) {
+	double d = 0;
+	for(unsigned int i=0; i<a.size(); i++) {
+		double e = fabs(a[i]-b[i])/std::max(1.0,fabs(a[i]));
+		d = std::max(d, e==e ? e : HUGE_VAL);
+	}
+	return d;
+}
+
+/// print comparison line; return whether results agree
+bool report(const char* name, double dev, unsigned int n, double tVirt, double tTmpl, double tBatch) {
+	printf("%-24s %10.3g %12.1f %12.1f %12.1f %8.2f\n", name, dev, n/tVirt*1e-6, n/tTmpl*1e-6, n/tBatch*1e-6, tVirt/tBatch);
+	return dev < 1e-12;
+}
+
+/// compare 1D virtual Interpolator on DoubleSequence against GridTerpolator
+template<BoundaryCondition BC, typename K, typename VI>
+bool check1D(const char* name, TRandom3& R, const std::vector<double>& x) {
+	const unsigned int nGrid = 37;
+	DoubleSequence D(BC);
+	GridTerpolator<BC,K> G(10., 0.3);
+	for(unsigned int i=0; i<nGrid; i++) {
+		double p = R.Uniform(-1,1);
+		D.addPoint(p);
+		G.addPoint(p);
+	}
+	VI V(&D, 10., 0.3);
+
+	const unsigned int n = x.size();
+	std::vector<double> yv(n), yt(n), yb(n);
+	TStopwatch W;
+	for(unsigned int i=0; i<n; i++) {
+		double xx = x[i];
+		yv[i] = V.eval(&xx);
+	}
+	W.Stop();
+	double tVirt = W.CpuTime();
+	W.Start(true);
+	for(unsigned int i=0; i<n; i++) yt[i] = G.eval(x[i]);
+	W.Stop();
+	double tTmpl = W.CpuTime();
+	W.Start(true);
+	G.eval(&x[0],&yb[0],n);
+	W.Stop();
+	double tBatch = W.CpuTime();
+	return report(name, std::max(maxRelDev(yv,yt),maxRelDev(yv,yb)), n, tVirt, tTmpl, tBatch);
+}
+
+/// compare position-map style r-phi nest of virtual interpolators against NestedTerpolator
+template<typename K, typename VI>
+bool checkNest(const char* name, TRandom3& R, unsigned int nRings) {
+	const double radius = 50;
+	const double rScale = radius*(1.0+1.0/(2*nRings-1.0));
+	SectorCutter S(nRings,radius);
+
+	// virtual interpolators, as PositioningInterpolator
+	InterpoSequence sRadial(BC_DERIVCLAMP_ZERO);
+	std::vector<DoubleSequence*> phiSeqs;
+	std::vector<Interpolator*> phiInterps;
+	NestedTerpolator<BC_DERIVCLAMP_ZERO,K,BC_CYCLIC,K> N(rScale,0);
+	for(unsigned int r=0; r<nRings; r++) {
+		phiSeqs.push_back(new DoubleSequence(BC_CYCLIC));
+		phiInterps.push_back(new VI(phiSeqs.back(),2.0*M_PI,M_PI/float(S.getNDivs(r))));
+		sRadial.addPoint(phiInterps.back());
+		N.addRow(2.0*M_PI,M_PI/float(S.getNDivs(r)));
+		for(unsigned int i=0; i<S.getNDivs(r); i++) {
+			double p = R.Uniform(0.8,1.2);
+			phiSeqs.back()->addPoint(p);
+			N.addPoint(p);
+		}
+	}
+	VI L(&sRadial, rScale, 0);
+
+	const unsigned int n = 1<<19;
+	std::vector<double> rs(n), phs(n), yv(n), yt(n), yb(n);
+	for(unsigned int i=0; i<n; i++) {
+		double x = R.Uniform(-60,60);
+		double y = R.Uniform(-60,60);
+		rs[i] = sqrt(x*x+y*y);
+		phs[i] = atan2(y,x);
+	}
+	TStopwatch W;
+	for(unsigned int i=0; i<n; i++) {
+		double xp[2] = {rs[i],phs[i]};
+		yv[i] = L.eval(xp);
+	}
+	W.Stop();
+	double tVirt = W.CpuTime();
+	W.Start(true);
+	for(unsigned int i=0; i<n; i++) yt[i] = N.eval(rs[i],phs[i]);
+	W.Stop();
+	double tTmpl = W.CpuTime();
+	W.Start(true);
+	N.eval(&rs[0],&phs[0],&yb[0],n);
+	W.Stop();
+	double tBatch = W.CpuTime();
+
+	for(unsigned int i=0; i<phiSeqs.size(); i++) {
+		delete phiSeqs[i];
+		delete phiInterps[i];
+	}
+	return report(name, std::max(maxRelDev(yv,yt),maxRelDev(yv,yb)), n, tVirt, tTmpl, tBatch);
+}
+
+/// compare non-virtual templated interpolators against virtual Interpolator classes, for identical results and speed
+int main(int, char**) {
+	TRandom3 R(1);
+	const unsigned int n = 1<<21;
+	std::vector<double> x(n);
+	for(unsigned int i=0; i<n; i++) x[i] = R.Uniform(-12,22);	// includes points beyond both ends
+
+	bool ok = true;
+	printf("%-24s %10s %12s %12s %12s %8s\n","interpolator","max dev","virt[M/s]","templ[M/s]","batch[M/s]","speedup");
+	ok &= check1D<BC_CYCLIC,NearestKernel,Interpolator>("nearest, cyclic",R,x);
+	ok &= check1D<BC_INFINITE,LinearKernel,LinTerpolator>("linear, infinite",R,x);
+	ok &= check1D<BC_CYCLIC,CubicKernel,CubiTerpolator>("cubic, cyclic",R,x);
+	ok &= check1D<BC_INFINITE,CubicKernel,CubiTerpolator>("cubic, infinite",R,x);
+	ok &= check1D<BC_DERIVCLAMP_ZERO,CubicKernel,CubiTerpolator>("cubic, deriv. clamp",R,x);
+	ok &= checkNest<LinearKernel,LinTerpolator>("posmap nest, linear",R,11);
+	ok &= checkNest<CubicKernel,CubiTerpolator>("posmap nest, cubic",R,11);
+	printf(ok?"Templated interpolators agree with virtual interpolators.\n":"*** Templated interpolators disagree with virtual interpolators! ***\n");
+	return ok?0:1;
+}
@@ -775,12 +775,16 @@ int main(int, char**) {
 		TFile f((getEnvSafe("UCNA_ANA_PLOTS")+"/PMTCorrDatNew/PMTCorr.root").c_str(),"READ");
 		TMultiLayerPerceptron* TMLP[2];
 		TriggerProbMLP* TProb[2];
+		// optional tabulated network lattice points per tube, tabulated efficiencies, and validation against exact model
+		const unsigned int nGrid = atoi(getEnvSafe("UCNA_TRIG_MLP_GRID","0").c_str());
 		for(Side s = EAST; s <= WEST; ++s) {
 			TMLP[s] = (TMultiLayerPerceptron*)f.Get(sideSubst("TrigMLP_%c",s).c_str());
 			smassert(TMLP[s]);
 			TMLP[s]->Print();
-			TProb[s] = new TriggerProbMLP(TMLP[s]);
+			TProb[s] = new TriggerProbMLP(TMLP[s],nGrid);
 			L2P.PGen[s].setTriggerProb(TProb[s]);
+			L2P.PGen[s].fastTrig = atoi(getEnvSafe("UCNA_FAST_TRIG","0").c_str());
+			L2P.PGen[s].validateTrig = atoi(getEnvSafe("UCNA_TRIG_VALIDATE","0").c_str());
 		}
 
 		L2P.nToSim = 60000;
@@ -793,6 +797,8 @@ int main(int, char**) {
 		LEDAnalyzer LA("PMTCorrSim",getEnvSafe("UCNA_ANA_PLOTS")+"/PMTCorrSim_C0.2");
 		for(unsigned int i=0; i<9; i++)
 			LA.ScanData(L2P);
+		for(Side s = EAST; s <= WEST; ++s)
+			if(L2P.PGen[s].validateTrig) L2P.PGen[s].reportTrigValidation();
 		LA.CalcCorrelations();
 		LA.CalcTrigEffic();
 		LA.CalcLightBal();
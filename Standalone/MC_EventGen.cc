@@ -1,96 +1,213 @@
 #include "NuclEvtGen.hh"
 #include "ControlMenu.hh"
 #include "PathUtils.hh"
+#include "CounterRNG.hh"
+#include "ROOTThreads.hh"
+#include "SMExcept.hh"
 #include <Math/QuasiRandom.h>
-#include <Math/Random.h>
 #include <TFile.h>
 #include <TTree.h>
+#include <thread>
+#include <exception>
+#include <stdlib.h>
 
 
 using namespace ROOT::Math;
 
+/// random input sources
+enum QRndType {
+	INDEP_RANDOM,
+	QR_SOBOL,
+	QR_NIED
+};
+
+/// settings shared by all generated trees
+struct EvtGenSetup {
+	std::string outPath;			///< output directory
+	unsigned int nTrees;			///< number of trees
+	unsigned int nPerTree;			///< primary decays per tree
+	QRndType qrt;					///< random input source
+	unsigned int decayDF;			///< random DF consumed by decay generator
+	unsigned int totDF;				///< total random DF per decay
+	PositionGenerator* PosGen;		///< vertex position generator (shared, stateless)
+	ULong64_t seed;					///< base seed for pseudo-random streams
+};
+
+/// quasi-random point source, tracking its position in the full sequence
+class QRSource {
+public:
+	/// constructor
+	QRSource(const EvtGenSetup& G): qrt(G.qrt), ndf(G.totDF), pos(0), rSobol(NULL), rNied(NULL) { reset(); }
+	/// destructor
+	~QRSource() { delete rSobol; delete rNied; }
+	/// whether this produces quasi-random points
+	bool isQuasi() const { return rSobol || rNied; }
+	/// position sequence at point p (advancing from current position when possible, otherwise from start)
+	void seek(ULong64_t p) {
+		if(!isQuasi()) return;
+		if(p < pos) reset();
+		std::vector<double> rnd(ndf);
+		while(pos < p) next(&rnd[0]);
+	}
+	/// get next point
+	void next(double* x) {
+		if(rSobol) rSobol->Next(x);
+		else if(rNied) rNied->Next(x);
+		pos++;
+	}
+protected:
+	/// restart sequence
+	void reset() {
+		delete rSobol;
+		delete rNied;
+		rSobol = qrt==QR_SOBOL ? new QuasiRandomSobol(ndf) : NULL;
+		rNied = qrt==QR_NIED ? new QuasiRandomNiederreiter(ndf) : NULL;
+		pos = 0;
+	}
+	QRndType qrt;						///< sequence type
+	unsigned int ndf;					///< sequence dimension
+	ULong64_t pos;						///< position of next point in sequence
+	QuasiRandomSobol* rSobol;			///< Sobol sequence generator
+	QuasiRandomNiederreiter* rNied;		///< Niederreiter sequence generator
+};
+
+/// generate one tree, as independent job: tree tn draws quasi-random points starting at tn*nPerTree in the full
+/// sequence, and pseudo-random numbers from its own counter-based stream, so output does not depend on job scheduling.
+/// Q is advanced to the tree's starting point (free when generating consecutive trees from one source).
+void genTree(NucDecaySystem& NDS, const EvtGenSetup& G, unsigned int tn, QRSource& Q) {
+	
+	printf("Tree %i/%i: %i events\n",tn+1,G.nTrees,G.nPerTree);
+	
+	CounterRNG rng(G.seed);
+	rng.setStream(0,tn);
+	setEvtGenRandom(&rng);
+	
+	std::vector<double> rnd(G.totDF);
+	Q.seek((ULong64_t)tn*G.nPerTree);
+	
+	double vpos[Z_DIRECTION+1];
+	for(AxisDirection d = X_DIRECTION; d <= Z_DIRECTION; ++d) vpos[d] = 0;
+	NucDecayEvent tEvt;
+	
+	TFile f((G.outPath+"/Evts_"+itos(tn)+".root").c_str(),"RECREATE");
+	f.cd();
+	
+	TTree T("Evts","MC initial events");
+	T.Branch("num",&tEvt.eid,"num/I");
+	T.Branch("PID",&tEvt.d,"PID/I");
+	T.Branch("KE",&tEvt.E,"KE/D");
+	T.Branch("vertex",tEvt.x,"vertex[3]/D");
+	T.Branch("direction",tEvt.p,"direction[3]/D");
+	T.Branch("time",&tEvt.t,"time/D");
+	T.Branch("weight",&tEvt.w,"weight/D");
+	
+	unsigned int evtn = tn*G.nPerTree;
+	for(unsigned int i=0; i<G.nPerTree; i++) {
+		std::vector<NucDecayEvent> evts;
+		if(Q.isQuasi()) Q.next(&rnd[0]);
+		else rng.RndmArray(G.totDF,&rnd[0]);
+		
+		NDS.genDecayChain(evts, &rnd[0]);
+		if(G.PosGen) G.PosGen->genPos(vpos,&rnd[G.decayDF+1]);
+		for(unsigned int i=0; i<evts.size(); i++) {
+			tEvt = evts[i];
+			tEvt.eid = evtn;
+			for(AxisDirection d = X_DIRECTION; d <= Z_DIRECTION; ++d) tEvt.x[d] = vpos[d];
+			T.Fill();
+		}
+		evtn++;
+	}
+	
+	T.Write();
+	f.Close();
+	
+	setEvtGenRandom(NULL);
+}
+
+/// generate trees [tn0,tn1) from one quasi-random source, reporting (and continuing past) failed trees
+void genTrees(NucDecaySystem& NDS, const EvtGenSetup& G, unsigned int tn0, unsigned int tn1) {
+	QRSource Q(G);
+	for(unsigned int tn=tn0; tn<tn1; tn++) {
+		try {
+			genTree(NDS,G,tn,Q);
+		} catch(SMExcept& e) {
+			printf("*** Generation of tree %i failed! ***\n",tn);
+			e.display();
+		} catch(std::exception& e) {
+			printf("*** Generation of tree %i failed: %s ***\n",tn,e.what());
+		} catch(...) {
+			printf("*** Generation of tree %i failed! ***\n",tn);
+		}
+		setEvtGenRandom(NULL);
+	}
+}
+
 void mi_evtgen(StreamInteractor* S) {
 
 	// load arguments
-	const unsigned int nTrees = S->popInt();
-	const unsigned int nPerTree = S->popInt();
+	EvtGenSetup G;
+	G.nTrees = S->popInt();
+	G.nPerTree = S->popInt();
 	const std::string rtSelect = S->popString();
 	const std::string vpSelect = S->popString();
-	std::string outPath = S->popString();
+	G.outPath = S->popString();
 	const std::string genName = S->popString();
+	// optional worker threads, each generating whole trees
+	unsigned int nThreads = atoi(getEnvSafe("UCNA_EVTGEN_THREADS","1").c_str());
+	if(nThreads < 1) nThreads = 1;
+	if(nThreads > G.nTrees) nThreads = G.nTrees;
 	
 	// load generators
 	static NucDecayLibrary NDL(getEnvSafe("UCNA_AUX")+"/NuclearDecays/",1e-6);
 	NucDecaySystem& NDS = NDL.getGenerator(genName);
 	NDS.display();
-	PositionGenerator* PosGen = vpSelect=="f" ?	(PositionGenerator*)(new CylPosGen(3.,2.3*0.0254)) :
-								vpSelect=="g" ?	(PositionGenerator*)(new CylPosGen(4.3,.075)) :
-								vpSelect=="c" ?	(PositionGenerator*)(new CubePosGen()) :
-												(PositionGenerator*)(new FixedPosGen());
-	enum QRndType {
-		INDEP_RANDOM,
-		QR_SOBOL,
-		QR_NIED
-	} qrt = (rtSelect=="s") ? QR_SOBOL : (rtSelect=="n"?QR_NIED:INDEP_RANDOM);
-		
-	outPath = outPath+"/"+genName+"_"+vpSelect+"_"+rtSelect+"/";
-	makePath(outPath);
+	G.PosGen = vpSelect=="f" ?	(PositionGenerator*)(new CylPosGen(3.,2.3*0.0254)) :
+				vpSelect=="g" ?	(PositionGenerator*)(new CylPosGen(4.3,.075)) :
+				vpSelect=="c" ?	(PositionGenerator*)(new CubePosGen()) :
+								(PositionGenerator*)(new FixedPosGen());
+	G.qrt = (rtSelect=="s") ? QR_SOBOL : (rtSelect=="n"?QR_NIED:INDEP_RANDOM);
+	// base seed for pseudo-random streams (override to generate statistically independent event sets)
+	G.seed = strtoull(getEnvSafe("UCNA_EVTGEN_SEED","0").c_str(),NULL,0);
 	
-	// set up variables
-	unsigned int evtn = 0;
-	double vpos[Z_DIRECTION+1];
-	for(AxisDirection d = X_DIRECTION; d <= Z_DIRECTION; ++d) vpos[d] = 0;
-	const unsigned int posDF = PosGen ? PosGen->getNDF(): 0;
-	const unsigned int decayDF = NDS.getNDF();
-	const unsigned int totDF = posDF+decayDF+1;
-	std::vector<double> rnd(totDF);
-	NucDecayEvent tEvt;
-	RandomMT r0;
-	QuasiRandomSobol rSobol(totDF);
-	QuasiRandomNiederreiter rNied(totDF);
-	if(qrt==QR_NIED && totDF>12) {
+	G.outPath = G.outPath+"/"+genName+"_"+vpSelect+"_"+rtSelect+"/";
+	makePath(G.outPath);
+	
+	const unsigned int posDF = G.PosGen ? G.PosGen->getNDF(): 0;
+	G.decayDF = NDS.getNDF();
+	G.totDF = posDF+G.decayDF+1;
+	if(G.qrt==QR_NIED && G.totDF>12) {
 		printf("Warning: ROOT's Niederreiter quasi-random generator invalid for >12 DF; switching to Sobol\n");
-		qrt=QR_SOBOL;
+		G.qrt=QR_SOBOL;
 	}
 	
-	printf("Generating events in '%s' with %i+%i+1 random DF\n",outPath.c_str(),posDF,decayDF);
+	printf("Generating events in '%s' with %i+%i+1 random DF on %i threads (seed %llu)\n",
+		   G.outPath.c_str(),posDF,G.decayDF,nThreads,(unsigned long long)G.seed);
 	
-	for(unsigned int tn=0; tn<nTrees; tn++) {
+	if(nThreads == 1) {
+		genTrees(NDS,G,0,G.nTrees);
+		return;
+	}
 	
-		printf("Tree %i/%i: %i events\n",tn+1,nTrees,nPerTree);
+	// decay generators keep per-event state, so each worker gets its own copy (loaded here, serially)
+	enableROOTThreads();
+	std::vector<NucDecayLibrary*> workerNDL;
+	for(unsigned int i=0; i<nThreads; i++) {
+		workerNDL.push_back(new NucDecayLibrary(NDL.datpath,NDL.tcut));
+		workerNDL.back()->getGenerator(genName);
+	}
 	
-		TFile f((outPath+"/Evts_"+itos(tn)+".root").c_str(),"RECREATE");
-		f.cd();
-		
-		TTree T("Evts","MC initial events");
-		T.Branch("num",&tEvt.eid,"num/I");
-		T.Branch("PID",&tEvt.d,"PID/I");
-		T.Branch("KE",&tEvt.E,"KE/D");
-		T.Branch("vertex",tEvt.x,"vertex[3]/D");
-		T.Branch("direction",tEvt.p,"direction[3]/D");
-		T.Branch("time",&tEvt.t,"time/D");
-		T.Branch("weight",&tEvt.w,"weight/D");
-		
-		for(unsigned int i=0; i<nPerTree; i++) {
-			std::vector<NucDecayEvent> evts;
-			if(qrt==INDEP_RANDOM) r0.RndmArray(totDF,&rnd[0]);
-			else if(qrt==QR_SOBOL) rSobol.Next(&rnd[0]);
-			else if(qrt==QR_NIED) rNied.Next(&rnd[0]);
-			
-			NDS.genDecayChain(evts, &rnd[0]);
-			if(PosGen) PosGen->genPos(vpos,&rnd[decayDF+1]);
-			for(unsigned int i=0; i<evts.size(); i++) {
-				tEvt = evts[i];
-				tEvt.eid = evtn;
-				for(AxisDirection d = X_DIRECTION; d <= Z_DIRECTION; ++d) tEvt.x[d] = vpos[d];
-				T.Fill();
-			}
-			evtn++;
-		}
-		
-		T.Write();
-		f.Close();
+	// each worker generates a contiguous block of trees, so its quasi-random source skips ahead only once
+	std::vector<std::thread> workers;
+	for(unsigned int i=0; i<nThreads; i++) {
+		NucDecaySystem* wNDS = &workerNDL[i]->getGenerator(genName);
+		const unsigned int tn0 = (unsigned int)(((ULong64_t)G.nTrees*i)/nThreads);
+		const unsigned int tn1 = (unsigned int)(((ULong64_t)G.nTrees*(i+1))/nThreads);
+		workers.push_back(std::thread([&G,wNDS,tn0,tn1]() { genTrees(*wNDS,G,tn0,tn1); }));
 	}
+	for(std::vector<std::thread>::iterator it = workers.begin(); it != workers.end(); it++)
+		it->join();
+	for(std::vector<NucDecayLibrary*>::iterator it = workerNDL.begin(); it != workerNDL.end(); it++)
+		delete *it;
 }
 
 
@@ -0,0 +1,53 @@
+#include "NuclEvtGen.hh"
+#include <TRandom.h>
+#include <TStopwatch.h>
+#include <algorithm>
+#include <stdio.h>
+#include <math.h>
+
+/// reference cumulative-probability binary search selection
+unsigned int cumSelect(const std::vector<double>& cumprob, double x) {
+	return std::upper_bound(cumprob.begin(),cumprob.end(),x*cumprob.back())-cumprob.begin()-1;
+}
+
+/// compare selection throughput of PSelector alias tables against cumulative binary search, for 10- to 1000-way selections
+int main(int, char**) {
+	const unsigned int nRnd = 1<<16;		// pre-generated random inputs, cycled
+	const unsigned int nRep = 160;		// passes over inputs
+	const unsigned int nSel = nRnd*nRep;
+	const unsigned int nWays[] = {10, 30, 100, 300, 1000};
+	std::vector<double> rnd(nRnd);
+	for(unsigned int i=0; i<rnd.size(); i++) rnd[i] = gRandom->Uniform(0,1);
+	
+	printf("%6s %14s %14s %8s %12s\n","n","search [M/s]","alias [M/s]","speedup","max dev/sig");
+	for(unsigned int k=0; k<sizeof(nWays)/sizeof(nWays[0]); k++) {
+		const unsigned int n = nWays[k];
+		PSelector P;
+		std::vector<double> cumprob(1,0);
+		for(unsigned int i=0; i<n; i++) {
+			double p = gRandom->Exp(1.);
+			P.addProb(p);
+			cumprob.push_back(cumprob.back()+p);
+		}
+		P.select(&rnd[0]);	// build alias table outside timing
+		
+		std::vector<unsigned int> hSearch(n), hAlias(n);
+		TStopwatch W;
+		for(unsigned int i=0; i<nSel; i++) hSearch[cumSelect(cumprob,rnd[i%nRnd])]++;
+		W.Stop();
+		double tSearch = W.CpuTime();
+		W.Start(true);
+		for(unsigned int i=0; i<nSel; i++) { double x = rnd[i%nRnd]; hAlias[P.select(&x)]++; }
+		W.Stop();
+		double tAlias = W.CpuTime();
+		
+		// selection counts for one pass over inputs should match expected probabilities within statistics
+		double maxdev = 0;
+		for(unsigned int i=0; i<n; i++) {
+			double mu = nRnd*P.getProb(i);
+			if(mu > 0) maxdev = std::max(maxdev, fabs(hAlias[i]/double(nRep)-mu)/sqrt(mu));
+		}
+		printf("%6u %14.1f %14.1f %8.2f %12.2f\n", n, nSel/tSearch*1e-6, nSel/tAlias*1e-6, tSearch/tAlias, maxdev);
+	}
+	return 0;
+}
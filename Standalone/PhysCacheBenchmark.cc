@@ -0,0 +1,51 @@
+#include "PostOfficialAnalyzer.hh"
+#include "PathUtils.hh"
+#include <TStopwatch.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+/// scan listed runs, returning sum over events of a few read point values (to compare cached/uncached reads)
+double scanRuns(const std::vector<RunNum>& runs, double& dt, unsigned int& nEvts) {
+	PostOfficialAnalyzer PDS(true);
+	PDS.addRuns(runs);
+	TStopwatch W;
+	double s = 0;
+	PDS.startScan();
+	while(PDS.nextPoint()) {
+		PDS.recalibrateEnergy();
+		s += PDS.getEnergy() + PDS.wires[EAST][X_DIRECTION].center + PDS.runClock[WEST] + PDS.fType;
+	}
+	W.Stop();
+	dt = W.RealTime();
+	nEvts = PDS.nEvents;
+	return s;
+}
+
+/// time processed data scans with and without per-run column cache
+int main(int argc, char** argv) {
+	if(argc < 2) {
+		printf("Usage: %s <run number> [more run numbers...]\n",argv[0]);
+		return 0;
+	}
+	std::vector<RunNum> runs;
+	for(int i=1; i<argc; i++) runs.push_back(atoi(argv[i]));
+	
+	std::string cdir = getEnvSafe("UCNA_PHYS_CACHE",getEnvSafe("UCNA_ANA_PLOTS")+"/PhysCache");
+	
+	double dt[3];
+	unsigned int n[3];
+	double s[3];
+	ProcessedDataScanner::physCacheDir = "";
+	s[0] = scanRuns(runs,dt[0],n[0]);
+	ProcessedDataScanner::physCacheDir = cdir;
+	s[1] = scanRuns(runs,dt[1],n[1]);	// builds missing caches
+	s[2] = scanRuns(runs,dt[2],n[2]);
+	
+	const char* lbl[3] = {"TChain","cache (first pass)","cache"};
+	for(unsigned int i=0; i<3; i++)
+		printf("%20s: %i events in %.2fs (%.3g events/s), checksum %.8g\n",lbl[i],n[i],dt[i],dt[i]>0?n[i]/dt[i]:0.,s[i]);
+	if(s[0] != s[2])
+		printf("**** WARNING: cached scan does not match TChain scan!\n");
+	
+	return 0;
+}
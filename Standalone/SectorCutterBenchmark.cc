@@ -0,0 +1,69 @@
+#include "SectorCutter.hh"
+#include <TRandom3.h>
+#include <TStopwatch.h>
+#include <vector>
+#include <stdio.h>
+#include <math.h>
+
+/// compare raster SectorCutter::sector lookups against direct calculation, for identical results and speed
+int main(int, char**) {
+	const unsigned int nPts = 1<<21;
+	const unsigned int nRings[] = {1, 4, 6, 11, 20};
+	TRandom3 R(1);
+	bool ok = true;
+
+	printf("%6s %8s %10s %12s %12s %12s\n","rings","sectors","mismatch","exact[M/s]","raster[M/s]","batch[M/s]");
+	for(unsigned int k=0; k<sizeof(nRings)/sizeof(nRings[0]); k++) {
+		SectorCutter S(nRings[k],50.);
+
+		// random points over (and beyond) cut region, with a fraction placed exactly on ring and phi division boundaries
+		std::vector<float> x(nPts), y(nPts);
+		for(unsigned int i=0; i<nPts; i++) {
+			if(i%4) {
+				x[i] = R.Uniform(-60,60);
+				y[i] = R.Uniform(-60,60);
+				continue;
+			}
+			unsigned int s = R.Integer(S.nSectors());
+			float r0,r1,ph0,ph1;
+			S.sectorBounds(s,r0,r1,ph0,ph1);
+			double rr = i%8 ? r1 : R.Uniform(r0,r1);
+			double ph = i%8 ? R.Uniform(ph0,ph1) : ph0;
+			x[i] = rr*cos(ph);
+			y[i] = rr*sin(ph);
+		}
+
+		unsigned int nBad = 0;
+		for(unsigned int i=0; i<nPts; i++)
+			nBad += S.sector(x[i],y[i]) != S.sectorExact(x[i],y[i]);
+
+		// timing on points uniform over cut region, as for typical events
+		for(unsigned int i=0; i<nPts; i++) {
+			double rr = 50*sqrt(R.Uniform(0,1));
+			double ph = R.Uniform(0,2*M_PI);
+			x[i] = rr*cos(ph);
+			y[i] = rr*sin(ph);
+		}
+		std::vector<unsigned int> out(nPts);
+		unsigned int sSum = 0;
+		TStopwatch W;
+		for(unsigned int i=0; i<nPts; i++) sSum += S.sectorExact(x[i],y[i]);
+		W.Stop();
+		double tExact = W.CpuTime();
+		W.Start(true);
+		for(unsigned int i=0; i<nPts; i++) sSum -= S.sector(x[i],y[i]);
+		W.Stop();
+		double tRaster = W.CpuTime();
+		W.Start(true);
+		S.sectors(&x[0],&y[0],&out[0],nPts);
+		W.Stop();
+		double tBatch = W.CpuTime();
+		for(unsigned int i=0; i<nPts; i++) nBad += out[i] != S.sectorExact(x[i],y[i]);
+		if(nBad || sSum) ok = false;
+
+		printf("%6u %8u %10u %12.1f %12.1f %12.1f\n", nRings[k], S.nSectors(), nBad,
+			   nPts/tExact*1e-6, nPts/tRaster*1e-6, nPts/tBatch*1e-6);
+	}
+	printf(ok?"Raster sector lookups identical to direct calculation.\n":"*** Raster sector lookups differ from direct calculation! ***\n");
+	return ok?0:1;
+}
@@ -15,6 +15,7 @@ TF1 AsymmetryPlugin::averagerFit = TF1("averagerFit","pol0",0,neutronBetaEp);
 
 AsymmetryPlugin::AsymmetryPlugin(OctetAnalyzer* OA):
 OctetAnalyzerPlugin(OA,"asymmetry"), nEnergyBins(150), energyMax(1500), hAsym(NULL), hCxn(NULL), anChoice(ANCHOICE_C) {
+	parallelFill = true;
 	for(Side s = EAST; s <= WEST; ++s) {
 		myA->ignoreMissingHistos = true;
 		qPassesWC[s] = registerCoreHist("hPassedWC","Events Passing Wirechamber Energy",nEnergyBins, 0, energyMax, s);
@@ -37,6 +38,10 @@ OctetAnalyzerPlugin(OA,"asymmetry"), nEnergyBins(150), energyMax(1500), hAsym(NU
 	}
 }
 
+std::string AsymmetryPlugin::getConfig() const {
+	return "anChoice="+ctos(choiceLetter(anChoice));
+}
+
 void AsymmetryPlugin::fillCoreHists(ProcessedDataScanner& PDS, double weight) {
 	Side s = PDS.fSide;
 	if(!(s==EAST || s==WEST)) return;
@@ -21,6 +21,8 @@ public:
 	virtual void makePlots();
 	/// MC/data comparison
 	virtual void compareMCtoData(AnalyzerPlugin* AP);
+	/// settings affecting filled histograms
+	virtual std::string getConfig() const;
 		
 	unsigned int nEnergyBins;		///< number of bins for energy histograms
 	double energyMax;				///< energy range for energy histograms
@@ -29,6 +29,7 @@ void fitHighEnergyExcess(RunAccumulator* RA, quadHists* qh, double e0, double e1
 }
 
 HighEnergyExcessPlugin::HighEnergyExcessPlugin(OctetAnalyzer* OA): OctetAnalyzerPlugin(OA,"highenergy") {
+	parallelFill = true;
 	for(Side s = EAST; s <= WEST; ++s) {
 		qExcessr2[s] = registerCoreHist("Excessr2","Excess events radial distribution",10,0,80*80,s);
 		qExcessr2[s]->setAxisTitle(X_DIRECTION,"event radius squared [mm^{2}]");
@@ -2,6 +2,7 @@
 #include "GraphicsUtils.hh"
 
 MuonPlugin::MuonPlugin(OctetAnalyzer* OA): OctetAnalyzerPlugin(OA,"muon"), nEnergyBins(150), energyMax(1500) {
+	parallelFill = true;
 	for(Side s = EAST; s <= WEST; ++s) {
 		qMuonSpectra[s][false] = registerCoreHist("hMuonNoSub", "Tagged Muon Events Energy",
 													   nEnergyBins, 0, energyMax, s);
@@ -105,6 +105,12 @@ void OctetAnalyzer::setFillPoints(AFPState afp, GVState gv) {
 		it->second->setFillPoint(afp,gv);
 }
 
+void OctetAnalyzer::setCurrentState(AFPState afp, GVState gv) {
+	RunAccumulator::setCurrentState(afp,gv);
+	if(afp <= AFP_ON && (gv == GV_CLOSED || gv == GV_OPEN))
+		setFillPoints(afp,gv);
+}
+
 quadHists* OctetAnalyzer::getCoreHist(const std::string& qname) {
 	std::map<std::string,quadHists*>::iterator it = coreHists.find(qname);
 	smassert(it != coreHists.end());
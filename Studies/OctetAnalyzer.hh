@@ -66,6 +66,8 @@ public:
 	const quadHists* getCoreHist(const std::string& qname) const;
 	/// set all quadHists fill points
 	void setFillPoints(AFPState afp, GVState gv);
+	/// set current AFP, GV state, and matching fill points
+	virtual void setCurrentState(AFPState afp, GVState gv);
 	
 	/// fill data from a ProcessedDataScanner
 	virtual void loadProcessedData(AFPState afp, GVState gv, ProcessedDataScanner& PDS) { setFillPoints(afp,gv); RunAccumulator::loadProcessedData(afp, gv, PDS); }
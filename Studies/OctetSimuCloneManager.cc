@@ -1,15 +1,24 @@
 #include "OctetSimuCloneManager.hh"
 #include "PathUtils.hh"
+#include "SegmentManifest.hh"
 
 OctetSimuCloneManager::OctetSimuCloneManager(const std::string& dname, const std::string& bdir):
-outputDir(dname), baseDir(bdir), doPlots(false), doCompare(false), hoursOld(0), simFactor(1.0), nTot(0), stride(0), ownSimData(false), simData(NULL) {
+outputDir(dname), baseDir(bdir), doPlots(false), doCompare(false), hoursOld(0), simFactor(1.0), nTot(0), stride(0), rescanStale(false), fastTrig(false), validateTrig(false), ownSimData(false), simData(NULL), simCacheData(NULL) {
 	RunAccumulator::processedLocation = baseDir+"/"+outputDir+"/"+outputDir;
 }
 
 void OctetSimuCloneManager::scanOct(RunAccumulator& RA, const Octet& oct) {
 	if(!oct.getNRuns()) return;
+	std::string inflname = RA.basePath+"/"+oct.octName()+"/"+oct.octName();
+	SegmentManifest M(RA,oct,inflname);
+	double fAge = fileAge(inflname+".root");
+	if(!RunAccumulator::forceRescan && SegmentSaver::inflExists(inflname) && (M.isCurrent() || (!M.isTracked() && fAge < hoursOld*3600))) {
+		printf("Octet '%s' inputs unchanged since scan %.1fh ago; skipping\n",oct.octName().c_str(),fAge/3600);
+		return;
+	}
 	RunAccumulator* octRA = (RunAccumulator*)RA.makeAnalyzer(oct.octName(),"");
 	octRA->grouping = oct.grouping;
+	M.write(octRA->qOut);
 	processOctets(*octRA,oct.getSubdivs(subdivide(oct.grouping),false),hoursOld*3600,doPlots);
 	delete octRA;
 }
@@ -19,8 +28,20 @@ void OctetSimuCloneManager::scanOct(RunAccumulator& RA, unsigned int octn) {
 		scanOct(RA,oct);
 }
 
-void OctetSimuCloneManager::combineOcts(RunAccumulator& RA) {
-	RA.mergeOcts(Octet::loadOctets(QFile(getEnvSafe("UCNA_OCTET_LIST"))));
+bool OctetSimuCloneManager::combineOcts(RunAccumulator& RA) {
+	std::vector<Octet> octs = Octet::loadOctets(QFile(getEnvSafe("UCNA_OCTET_LIST")));
+	for(std::vector<Octet>::const_iterator it = octs.begin(); it != octs.end(); it++) {
+		if(!it->getNRuns()) continue;
+		std::string inflname = RA.basePath+"/"+it->octName()+"/"+it->octName();
+		if(!SegmentSaver::inflExists(inflname)) {
+			if(rescanStale) scanOct(RA,*it);
+			else printf("*** Octet '%s' has not been scanned; it will be missing from the merge!\n",it->octName().c_str());
+		} else if(rescanStale && SegmentManifest::storedDigest(inflname).size()) {
+			// optionally bring octets with changed inputs up to date (output without a manifest is taken as current)
+			scanOct(RA,*it);
+		}
+	}
+	return RA.mergeOcts(octs);
 }
 
 unsigned int OctetSimuCloneManager::recalcAllOctets(RunAccumulator& RA, bool doPlots) {
@@ -37,6 +58,18 @@ void OctetSimuCloneManager::setOctetSimdata(unsigned int octn) {
 	if(simData && ownSimData) delete simData;
 	ownSimData = true;
 	G4toPMT* G2P = new G4toPMT();
+	if(simCache.size()) {
+		if(!simCacheData) {
+			if(!fileExists(simCache)) {
+				std::vector<std::string> fnames;
+				for(unsigned int i=0; i<nTot; i++)
+					fnames.push_back(simFile+itos(i)+".root");
+				G4EventCache::build(fnames,simCache);
+			}
+			simCacheData = new G4EventCache(simCache);
+		}
+		G2P->setCache(simCacheData);
+	}
 	for(unsigned int i=0; i<stride; i++)
 		G2P->addFile(simFile+itos((stride*octn+i)%nTot)+".root");
 	G2P->PGen[EAST].xscatter = G2P->PGen[WEST].xscatter = 0.005;
@@ -49,7 +82,15 @@ void OctetSimuCloneManager::simOct(RunAccumulator& SimRA, const Octet& oct) {
 	smassert(simData);
 	RunAccumulator* octSim = (RunAccumulator*)SimRA.makeAnalyzer(oct.octName(),"");
 	octSim->grouping = oct.grouping;
+	for(Side s = EAST; s <= WEST; ++s) {
+		simData->PGen[s].fastTrig = fastTrig;
+		simData->PGen[s].validateTrig = validateTrig;
+		simData->PGen[s].resetTrigValidation();
+	}
 	octSim->simuClone(getEnvSafe("UCNA_ANA_PLOTS")+"/"+outputDir+"/"+oct.octName(), *simData, simFactor, hoursOld*3600, doPlots, doCompare);
+	if(validateTrig)
+		for(Side s = EAST; s <= WEST; ++s)
+			simData->PGen[s].reportTrigValidation();
 	delete octSim;
 }
 
@@ -3,6 +3,7 @@
 
 #include "RunAccumulator.hh"
 #include "PathUtils.hh"
+#include "G4toPMT.hh"
 #include <string>
 
 /// class for handling octet-by-octet matching data and simulation analyses
@@ -11,14 +12,14 @@ public:
 	/// constructor
 	OctetSimuCloneManager(const std::string& dname, const std::string& bdir = getEnvSafe("UCNA_ANA_PLOTS"));
 	/// destructor
-	virtual ~OctetSimuCloneManager() { setSimData(NULL); }
+	virtual ~OctetSimuCloneManager() { setSimData(NULL); delete simCacheData; }
 	
-	/// scan runs by provided run list
+	/// scan runs by provided run list (skipped if dependency manifest unchanged, or if untracked output is less than hoursOld old)
 	void scanOct(RunAccumulator& RA, const Octet& oct);
 	/// scan one octet of data, by octet number
 	void scanOct(RunAccumulator& RA, unsigned int octn);
-	/// combine all data octets
-	void combineOcts(RunAccumulator& RA);
+	/// combine all data octets (loading previous merge if unchanged), optionally first re-scanning missing or changed octets; return whether newly merged
+	bool combineOcts(RunAccumulator& RA);
 	
 	/// set simulation data source
 	void setSimData(Sim2PMT* s2p);
@@ -41,6 +42,10 @@ public:
 	float simFactor;		///< ratio of simulation to data events to produce
 	unsigned int nTot;		///< total number of individual sim files
 	unsigned int stride;	///< number of sim files to load in a chunk for each octet
+	std::string simCache;	///< columnar cache file for simulation inputs (built if missing; "" to read ROOT files directly)
+	bool rescanStale;		///< whether combineOcts re-scans missing octets, and octets whose manifest shows changed inputs
+	bool fastTrig;			///< whether to simulate triggers with tabulated PMT efficiencies
+	bool validateTrig;		///< whether to compare simulated trigger probabilities against the exact model, and report
 
 protected:
 
@@ -49,6 +54,7 @@ protected:
 
 	bool ownSimData;		///< whether this class ``owns'' simulation data
 	Sim2PMT* simData;		///< simulated data source to use
+	G4EventCache* simCacheData;	///< opened simulation input cache
 };
 
 #endif
@@ -196,20 +196,19 @@ void makeCorrectionsFile(int A, int Z, double Endpt, double M2_F, double M2_GT)
 	fout += itos(A)+"_"+itos(Z)+"_"+dtos(Endpt)+".txt";
 	
 	BetaSpectrumGenerator BSG(A,Z,Endpt);
-	BSG.M2_F = M2_F;
-	BSG.M2_GT = M2_GT;
-	if(A==1 && Z==1) { BSG.M2_F = 1; BSG.M2_GT = 3; } // neutron case
+	BSG.setMatrixElements(M2_F,M2_GT);
+	if(A==1 && Z==1) BSG.setMatrixElements(1,3); // neutron case
 		
 	QFile Q;
 	Stringmap sm;
 	sm.insert("A",A);
 	sm.insert("Z",Z);
 	sm.insert("endpt",Endpt);
-	sm.insert("W0",BSG.W0);
-	sm.insert("R",BSG.R);
-	sm.insert("M0",BSG.M0);
-	sm.insert("M2_F",BSG.M2_F);
-	sm.insert("M2_GT",BSG.M2_GT);
+	sm.insert("W0",BSG.getW0());
+	sm.insert("R",BSG.getR());
+	sm.insert("M0",BSG.getM0());
+	sm.insert("M2_F",BSG.getM2_F());
+	sm.insert("M2_GT",BSG.getM2_GT());
 	Q.insert("decayInfo",sm);
 	
 	for(double e = 0.5; e < Endpt; e+=1.) {
@@ -218,22 +217,22 @@ void makeCorrectionsFile(int A, int Z, double Endpt, double M2_F, double M2_GT)
 		m.insert("energy",e);
 		m.insert("W",W);
 		m.insert("beta",beta(e));
-		m.insert("F0m1",WilkinsonF0(Z,W,BSG.R)-1.0);
-		m.insert("L0m1",WilkinsonL0(Z,W,BSG.R)-1.0);
-		m.insert("RVm1",WilkinsonRV(W,BSG.W0,BSG.M0)-1.0);
-		m.insert("RAm1",WilkinsonRA(W,BSG.W0,BSG.M0)-1.0);
-		m.insert("Rm1",CombinedR(W,M2_F,M2_GT,BSG.W0,BSG.M0)-1.0);
+		m.insert("F0m1",WilkinsonF0(Z,W,BSG.getR())-1.0);
+		m.insert("L0m1",WilkinsonL0(Z,W,BSG.getR())-1.0);
+		m.insert("RVm1",WilkinsonRV(W,BSG.getW0(),BSG.getM0())-1.0);
+		m.insert("RAm1",WilkinsonRA(W,BSG.getW0(),BSG.getM0())-1.0);
+		m.insert("Rm1",CombinedR(W,M2_F,M2_GT,BSG.getW0(),BSG.getM0())-1.0);
 		m.insert("BiRWM",Bilenkii59_RWM(W));
-		m.insert("VCm1",WilkinsonVC(Z,W,BSG.W0,BSG.R)-1.0);
-		m.insert("ACm1",WilkinsonAC(Z,W,BSG.W0,BSG.R)-1.0);
-		m.insert("Cm1",CombinedC(Z,W,M2_F,M2_GT,BSG.W0,BSG.R)-1.0);
-		m.insert("Qm1",WilkinsonQ(Z,W,BSG.W0,BSG.M0)-1.0);
-		m.insert("g",Wilkinson_g_a2pi(W,BSG.W0,BSG.M0));
+		m.insert("VCm1",WilkinsonVC(Z,W,BSG.getW0(),BSG.getR())-1.0);
+		m.insert("ACm1",WilkinsonAC(Z,W,BSG.getW0(),BSG.getR())-1.0);
+		m.insert("Cm1",CombinedC(Z,W,M2_F,M2_GT,BSG.getW0(),BSG.getR())-1.0);
+		m.insert("Qm1",WilkinsonQ(Z,W,BSG.getW0(),BSG.getM0())-1.0);
+		m.insert("g",Wilkinson_g_a2pi(W,BSG.getW0(),BSG.getM0()));
 		m.insert("gS",Sirlin_g_a2pi(e,Endpt));
-		m.insert("hmg",shann_h_minus_g_a2pi(W,BSG.W0));
+		m.insert("hmg",shann_h_minus_g_a2pi(W,BSG.getW0()));
 		m.insert("h",shann_h_a2pi(e,Endpt));
 		m.insert("RWM",WilkinsonACorrection(W));
-		m.insert("S0",plainPhaseSpace(W,BSG.W0));
+		m.insert("S0",plainPhaseSpace(W,BSG.getW0()));
 		m.insert("S",BSG.decayProb(e));
 		m.insert("dSm1",BSG.spectrumCorrectionFactor(W)-1.0);
 		m.insert("A0",plainAsymmetry(e,0.5));
@@ -1,5 +1,6 @@
 #include "PositionBinnedPlugin.hh"
 #include "SMExcept.hh"
+#include "strutils.hh"
 
 PositionBinnedPlugin::PositionBinnedPlugin(RunAccumulator* RA, const std::string& nm, unsigned int nr, double r):
 AnalyzerPlugin(RA,nm), sects(nr,r) {
@@ -22,6 +23,10 @@ AnalyzerPlugin(RA,nm), sects(nr,r) {
 	myA->qOut.insert("SectorCutter_"+name,ms);
 }
 
+std::string PositionBinnedPlugin::getConfig() const {
+	return "sects="+itos(sects.n)+","+dtos(sects.r);
+}
+
 std::vector<fgbgPair*> PositionBinnedPlugin::allocateSegmentHistograms(TH1& hTemplate, AFPState a, Side s) {
 	std::vector<fgbgPair*> segHists;
 	std::string hname0 = hTemplate.GetName();
@@ -11,6 +11,8 @@ public:
 	PositionBinnedPlugin(RunAccumulator* RA, const std::string& nm, unsigned int nr, double r);
 	/// allocate histograms for each position segment
 	std::vector<fgbgPair*> allocateSegmentHistograms(TH1& hTemplate, AFPState a = AFP_OTHER, Side s = BOTH);
+	/// settings affecting filled histograms
+	virtual std::string getConfig() const;
 	
 	SectorCutter sects;		///< sector cutter for position binning
 };
@@ -1,7 +1,9 @@
 #include "PositionsPlugin.hh"
 #include "GraphicsUtils.hh"
+#include "strutils.hh"
 
 PositionsPlugin::PositionsPlugin(OctetAnalyzer* OA): OctetAnalyzerPlugin(OA,"position"), offSects(5,45.0) {
+	parallelFill = true;
 	for(unsigned int m=0; m<offSects.nSectors(); m++) {
 		for(AxisDirection d = X_DIRECTION; d <= Y_DIRECTION; ++d) {
 			poff[d].push_back(registerFGBGPair((d==X_DIRECTION?"pOff_X_":"pOff_Y_")+itos(m), "Type I Position Offsets",50,-25, 25));
@@ -25,6 +27,10 @@ PositionsPlugin::PositionsPlugin(OctetAnalyzer* OA): OctetAnalyzerPlugin(OA,"pos
 	}
 }
 
+std::string PositionsPlugin::getConfig() const {
+	return "offSects="+itos(offSects.n)+","+dtos(offSects.r);
+}
+
 void PositionsPlugin::fillCoreHists(ProcessedDataScanner& PDS, double weight) {
 	Side s = PDS.fSide;
 	if(PDS.fPID!=PID_BETA || !(s==EAST||s==WEST)) return;
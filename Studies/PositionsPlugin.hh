@@ -18,6 +18,8 @@ public:
 	virtual void makePlots();
 	/// MC/data comparison plots
 	virtual void compareMCtoData(AnalyzerPlugin* AP);
+	/// settings affecting filled histograms
+	virtual std::string getConfig() const;
 	
 	SectorCutter offSects;						///< sector cutter for position binning data
 	std::vector<fgbgPair*> poff[2];				///< East-West position offsets for [x/y direction] in each sector
@@ -2,9 +2,20 @@
 #include "GraphUtils.hh"
 #include "SMExcept.hh"
 #include "PostOfficialAnalyzer.hh"
+#include "ROOTThreads.hh"
+#include "CalDBSnapshot.hh"
+#include "SegmentManifest.hh"
+#include "strutils.hh"
 #include <time.h>
+#include <thread>
+#include <atomic>
+#include <exception>
 
-TRandom3 RunAccumulator::rnd_source;
+CounterRNG RunAccumulator::rnd_source;
+unsigned int RunAccumulator::simThreads = 0;
+bool RunAccumulator::simThreadsCheck = false;
+bool RunAccumulator::forceRescan = false;
+unsigned int RunAccumulator::dataThreads = 0;
 
 fgbgPair::fgbgPair(const std::string& nm, const std::string& ttl, AFPState a, Side s):
 baseName(nm), baseTitle(ttl), afp(a), mySide(s), doSubtraction(true), doTimeScale(true), isSubtracted(false) { }
@@ -173,6 +184,15 @@ AnalyzerPlugin* RunAccumulator::getPlugin(const std::string& nm) {
 	return it != myPlugins.end() ? it->second : NULL;
 }
 
+unsigned long long RunAccumulator::configHash() const {
+	unsigned long long h = layoutHash;
+	for(std::map<std::string,AnalyzerPlugin*>::const_iterator it = myPlugins.begin(); it != myPlugins.end(); it++) {
+		std::string c = it->first+"="+it->second->getConfig();
+		h = hashBytes(c.c_str(),c.size()+1,h);
+	}
+	return h;
+}
+
 void RunAccumulator::fillCoreHists(ProcessedDataScanner& PDS, double weight) {
 	for(std::map<std::string,AnalyzerPlugin*>::iterator it = myPlugins.begin(); it != myPlugins.end(); it++)
 		it->second->fillCoreHists(PDS,weight);
@@ -356,6 +376,7 @@ void RunAccumulator::simBgFlucts(const RunAccumulator& RefOA, double simfactor,
 		const fgbgPair& qhRef = RefOA.getFGBGPair(it->first);
 		double bgRatio = RefOA.getTotalTime(it->second->afp,GV_OPEN)[it->second->mySide]/RefOA.getTotalTime(it->second->afp,GV_CLOSED)[it->second->mySide];
 		for(unsigned int i=0; i<totalBins(it->second->h[GV_CLOSED]); i++) {
+			rnd_source.setStream(0, hashString(it->first), i);				// independent of histogram order and other draws
 			double rootn = qhRef.h[0]->GetBinError(i)*sqrt(simfactor);		// root(bg counts) from ref histogram errorbars
 			double n = rootn*rootn;											// background counts from reference histogram
 			double bgObsCounts = rnd_source.PoissonD(n);					// simulated background counts
@@ -420,17 +441,15 @@ void RunAccumulator::loadProcessedData(AFPState afp, GVState gv, ProcessedDataSc
 	setCurrentState(afp,gv);
 	if(!PDS.getnFiles())
 		return;
-	PDS.startScan();
 	unsigned int nScanned = 0;
-	while(PDS.nextPoint()) {
-		nScanned++;
-		if(PDS.withCals)
-			PDS.recalibrateEnergy();
-		if(PDS.fPID==PID_BETA && PDS.fType==TYPE_0_EVENT) {
-			runCounts.add(PDS.getRun(),1.0);
-			totalCounts[afp][gv]++;
+	if(loadProcessedParallel(afp,gv,PDS)) {
+		nScanned = PDS.nEvents;
+	} else {
+		PDS.startScan();
+		while(PDS.nextPoint()) {
+			nScanned++;
+			loadProcessedPoint(PDS);
 		}
-		fillCoreHists(PDS,PDS.physicsWeight);
 	}
 	printf("\tFG=%i: scanned %i points\n",gv,nScanned);
 	if(gv==GV_CLOSED)
@@ -440,6 +459,108 @@ void RunAccumulator::loadProcessedData(AFPState afp, GVState gv, ProcessedDataSc
 	PDS.writeCalInfo(qOut,"runcal");
 }
 
+void RunAccumulator::loadProcessedPoint(ProcessedDataScanner& PDS) {
+	if(PDS.withCals)
+		PDS.recalibrateEnergy();
+	if(PDS.fPID==PID_BETA && PDS.fType==TYPE_0_EVENT) {
+		runCounts.add(PDS.getRun(),1.0);
+		totalCounts[currentAFP][currentGV]++;
+	}
+	fillCoreHists(PDS,PDS.physicsWeight);
+}
+
+/// one worker's share of a parallel loadProcessedData
+struct ScanRangeJob {
+	ProcessedDataScanner* PDS;	///< scanner over runs covering event range
+	unsigned int e0;			///< first event to scan in PDS
+	unsigned int e1;			///< end of event range in PDS
+	RunAccumulator* RA;			///< histograms for event range
+	std::exception_ptr err;		///< exception thrown in worker
+};
+
+bool RunAccumulator::loadProcessedParallel(AFPState afp, GVState gv, ProcessedDataScanner& PDS) {
+	if(dataThreads < 2 || PDS.nEvents < 2) return false;
+	if(!myPlugins.size()) return false;
+	for(std::map<std::string,AnalyzerPlugin*>::const_iterator it = myPlugins.begin(); it != myPlugins.end(); it++)
+		if(!it->second->parallelFill) return false;
+	const std::vector<RunNum>& runs = PDS.getRunList();
+	const std::vector<unsigned int>& nn = PDS.getFileEvents();
+	if(runs.size() != nn.size()) return false;
+	const unsigned int nWorkers = dataThreads < PDS.nEvents ? dataThreads : PDS.nEvents;
+	
+	// histograms for each worker (must carry the same plugins, i.e. not added from outside after construction)
+	std::vector<ScanRangeJob> jobs(nWorkers);
+	bool ok = true;
+	for(unsigned int i=0; i<nWorkers; i++) {
+		jobs[i].PDS = NULL;
+		jobs[i].RA = (RunAccumulator*)makeAnalyzer("nameUnused","");
+		ok &= jobs[i].RA->myPlugins.size() == myPlugins.size();
+	}
+	// scanners over the runs spanned by each worker's contiguous event range
+	unsigned int f0 = 0;		// first file overlapping range
+	unsigned int nBefore = 0;	// events in files before f0
+	for(unsigned int i=0; ok && i<nWorkers; i++) {
+		const unsigned int e0 = (ULong64_t)PDS.nEvents*i/nWorkers;
+		const unsigned int e1 = (ULong64_t)PDS.nEvents*(i+1)/nWorkers;
+		while(e0 >= nBefore+nn[f0]) nBefore += nn[f0++];
+		std::vector<RunNum> rr;
+		unsigned int nSpan = 0;
+		for(unsigned int f = f0; nBefore+nSpan < e1; f++) {
+			rr.push_back(runs[f]);
+			nSpan += nn[f];
+		}
+		jobs[i].PDS = PDS.makeScanner();
+		if(!(ok = jobs[i].PDS != NULL)) break;
+		jobs[i].PDS->addRuns(rr);
+		if(jobs[i].PDS->nEvents != nSpan) {
+			SMExcept e("scannerMismatch");
+			e.insert("nEvents",jobs[i].PDS->nEvents);
+			e.insert("nExpected",nSpan);
+			for(std::vector<ScanRangeJob>::iterator it = jobs.begin(); it != jobs.end(); it++) { delete(it->PDS); delete(it->RA); }
+			throw(e);
+		}
+		jobs[i].e0 = e0-nBefore;
+		jobs[i].e1 = e1-nBefore;
+	}
+	if(!ok) {
+		for(std::vector<ScanRangeJob>::iterator it = jobs.begin(); it != jobs.end(); it++) { delete(it->PDS); delete(it->RA); }
+		return false;
+	}
+	printf("Scanning %i points on %i threads...\n",PDS.nEvents,nWorkers);
+	
+	enableROOTThreads();
+	std::vector<std::thread> workers;
+	for(unsigned int i=0; i<nWorkers; i++) {
+		ScanRangeJob* J = &jobs[i];
+		workers.push_back(std::thread([J,afp,gv]() {
+			try {
+				J->RA->setCurrentState(afp,gv);
+				for(unsigned int e = J->e0; e < J->e1; e++) {
+					J->PDS->speedload(e);
+					J->RA->loadProcessedPoint(*J->PDS);
+				}
+			} catch(...) { J->err = std::current_exception(); }
+		}));
+	}
+	for(std::vector<std::thread>::iterator it = workers.begin(); it != workers.end(); it++) it->join();
+	
+	// merge results in fixed pairwise tree order
+	std::exception_ptr err;
+	for(std::vector<ScanRangeJob>::iterator it = jobs.begin(); it != jobs.end(); it++) {
+		delete(it->PDS);
+		if(it->err && !err) err = it->err;
+	}
+	if(!err) {
+		for(unsigned int step = 1; step < jobs.size(); step *= 2)
+			for(unsigned int i = 0; i+step < jobs.size(); i += 2*step)
+				jobs[i].RA->addSegment(*jobs[i+step].RA);
+		addSegment(*jobs[0].RA);
+	}
+	for(std::vector<ScanRangeJob>::iterator it = jobs.begin(); it != jobs.end(); it++) delete(it->RA);
+	if(err) std::rethrow_exception(err);
+	return true;
+}
+
 void RunAccumulator::copyTimes(const RunAccumulator& RA) {
 	runTimes = RA.runTimes;
 	for(AFPState afp = AFP_OFF; afp<=AFP_OTHER; ++afp)
@@ -465,7 +586,7 @@ void RunAccumulator::loadSimData(Sim2PMT& simData, unsigned int nToSim, bool cou
 	while(!nToSim || (countAll?simData.nSimmed:simData.nCounted)<=nToSim) {
 		bool np = simData.nextPoint();
 		loadSimPoint(simData);
-		if(nToSim && !(int(simData.nSimmed)%(nToSim/20))) {
+		if(nToSim >= 20 && !(int(simData.nSimmed)%(nToSim/20))) {
 			if(nToSim>1e6) {
 				printf("* %s\n",simData.evtInfo().toString().c_str());
 			} else {
@@ -479,16 +600,17 @@ void RunAccumulator::loadSimData(Sim2PMT& simData, unsigned int nToSim, bool cou
 }
 
 void RunAccumulator::simForRun(Sim2PMT& simData, RunNum rn, unsigned int nToSim, bool countAll) {
-	RunInfo RI = CalDBSQL::getCDB()->getRunInfo(rn);
+	CalDB* CDB = CalDBSnapshot::getCDB();
+	RunInfo RI = CDB->getRunInfo(rn);
 	if(RI.gvState != GV_OPEN) { printf("Skipping simulation for background run "); RI.display(); return; }
 	smassert(RI.afpState <= AFP_OTHER);
 	
-	PMTCalibrator PCal(rn);
+	PMTCalibrator PCal(rn,CDB);
 	simData.setCalibrator(PCal);
 	simData.setAFP(RI.afpState);
 	loadSimData(simData,nToSim,countAll);
 	
-	double rntime = CalDBSQL::getCDB()->fiducialTime(rn)[BOTH];
+	double rntime = CDB->fiducialTime(rn)[BOTH];
 	runTimes.add(rn,rntime);
 	totalTime[RI.afpState][GV_OPEN] += rntime;
 }
@@ -510,6 +632,7 @@ unsigned int RunAccumulator::simMultiRuns(Sim2PMT& simData, const TagCounter<Run
 			// calculate alloted number of events for this run
 			nGranted += it->second;
 			int nToSim = int((nGranted/nRequested)*nCounts)-nSimmed;
+			if(nToSim < 1) nToSim = 1;	// earlier runs' extra events may exhaust this run's share
 			// simulate alloted requests and re-scale to requested counts
 			RunAccumulator* subRA = (RunAccumulator*)makeAnalyzer("nameUnused","");
 			subRA->simForRun(simData, it->first, nToSim, true);
@@ -523,6 +646,246 @@ unsigned int RunAccumulator::simMultiRuns(Sim2PMT& simData, const TagCounter<Run
 	return nSimmed;
 }
 
+/// one run's share of a parallel simMultiRuns
+struct SimRunJob {
+	RunNum rn;						///< run number
+	AFPState afp;					///< run AFP state
+	double rntime;					///< run fiducial time
+	double nReq;					///< requested counts for run
+	unsigned int nToSim;			///< events (countAll) or counts to simulate
+	bool countAll;					///< whether to count all thrown events, or only counted events
+	std::vector<SimSpan> spans;		///< input spans to draw events from, in order
+	PMTCalibrator* PCal;			///< calibrator for run
+	RunAccumulator* RA;				///< histograms for run
+	std::vector<SimSpan> used;		///< input spans consumed
+	unsigned int nSimmed;			///< number of events thrown
+	double nCounted;				///< number of events counted
+	std::exception_ptr err;			///< exception thrown in worker
+};
+
+/// take n events from concatenated spans after skipping the first skip; continues past the end of the last span
+std::vector<SimSpan> takeSpans(const std::vector<SimSpan>& src, ULong64_t skip, ULong64_t n) {
+	std::vector<SimSpan> v;
+	smassert(src.size());
+	for(std::vector<SimSpan>::const_iterator it = src.begin(); it != src.end() && n; it++) {
+		const bool last = it+1 == src.end();
+		if(!last && skip >= it->n) { skip -= it->n; continue; }
+		SimSpan sp = *it;
+		sp.first += skip;
+		sp.n = (!last && it->n-skip < n) ? it->n-skip : n;
+		skip = 0;
+		n -= sp.n;
+		v.push_back(sp);
+	}
+	return v;
+}
+
+/// simulate one run's job on a cursor
+void runSimJob(SimRunJob& J, Sim2PMT& C) {
+	C.setCalibrator(*J.PCal);
+	C.setAFP(J.afp);
+	C.resetSimCounters();
+	J.RA->isSimulated = true;
+	J.RA->setCurrentState(J.afp,GV_OPEN);
+	
+	std::vector<SimSpan>::const_iterator sp = J.spans.begin();
+	ULong64_t a = sp->first;
+	ULong64_t left = sp->n;
+	const unsigned int nToSim = J.nToSim?J.nToSim:C.nEvents;
+	while((J.countAll?C.nSimmed:C.nCounted) <= nToSim) {
+		if(sp->n && !left) {
+			++sp;
+			smassert(sp != J.spans.end());
+			a = sp->first;
+			left = sp->n;
+		}
+		if(!J.used.size() || J.used.back().sub != sp->sub || J.used.back().first+J.used.back().n != a) {
+			SimSpan u = { a, 0, sp->sub };
+			J.used.push_back(u);
+		}
+		C.loadStreamEvent(a++,sp->sub);
+		J.used.back().n++;
+		left--;
+		J.RA->loadSimPoint(C);
+	}
+	J.nSimmed = C.nSimmed;
+	J.nCounted = C.nCounted;
+	
+	J.RA->runTimes.add(J.rn,J.rntime);
+	J.RA->totalTime[J.afp][GV_OPEN] += J.rntime;
+	if(J.countAll) J.RA->scaleData(J.nReq/J.nCounted);
+	printf("From %i input points, simulated %i/%i requested events for Run %i\n",J.nSimmed,(int)J.nCounted,(int)J.nReq,J.rn);
+}
+
+/// run simulation jobs on worker pool, one worker per cursor
+void runSimJobs(std::vector<SimRunJob>& jobs, const std::vector<Sim2PMT*>& cursors) {
+	enableROOTThreads();
+	std::atomic<unsigned int> nextJob(0);
+	std::vector<std::thread> workers;
+	for(unsigned int i=0; i<cursors.size(); i++) {
+		Sim2PMT* C = cursors[i];
+		workers.push_back(std::thread([&jobs,&nextJob,C]() {
+			for(unsigned int j = nextJob++; j < jobs.size(); j = nextJob++) {
+				try { runSimJob(jobs[j],*C); }
+				catch(...) { jobs[j].err = std::current_exception(); }
+			}
+		}));
+	}
+	for(std::vector<std::thread>::iterator it = workers.begin(); it != workers.end(); it++) it->join();
+}
+
+/// merge job results into jobs[0].RA in fixed pairwise tree order
+void mergeSimJobs(std::vector<SimRunJob>& jobs) {
+	for(unsigned int step = 1; step < jobs.size(); step *= 2)
+		for(unsigned int i = 0; i+step < jobs.size(); i += 2*step)
+			jobs[i].RA->addSegment(*jobs[i+step].RA);
+}
+
+/// count saved histograms differing (in any bin content or error) between two simulation results
+unsigned int compareSimResults(const RunAccumulator& A, const RunAccumulator& B) {
+	smassert(A.sameLayout(B));
+	unsigned int nDiff = 0;
+	for(unsigned int h=0; h<A.getNSaved(); h++) {
+		const TH1* ha = A.getSavedHist(h);
+		const TH1* hb = B.getSavedHist(h);
+		for(int i=0; i<ha->GetNcells(); i++) {
+			if(ha->GetBinContent(i) == hb->GetBinContent(i) && ha->GetBinError(i) == hb->GetBinError(i)) continue;
+			printf("\t%s differs at bin %i: %g vs. %g\n",ha->GetName(),i,ha->GetBinContent(i),hb->GetBinContent(i));
+			nDiff++;
+			break;
+		}
+	}
+	return nDiff;
+}
+
+bool RunAccumulator::simMultiRunsParallel(Sim2PMT& simData, const TagCounter<RunNum>& runReqs, unsigned int nCounts, unsigned int& nSimmed,
+										  std::vector<SimSpan>& used, const std::vector<SimSpan>* replay) {
+	if(!simThreads || !simData.nEvents || !runReqs.nTags()) return false;
+	// all plugins must be safe to fill concurrently
+	for(std::map<std::string,AnalyzerPlugin*>::const_iterator it = myPlugins.begin(); it != myPlugins.end(); it++)
+		if(!it->second->parallelFill) return false;
+	
+	// independent cursors for each worker
+	std::vector<Sim2PMT*> cursors;
+	const unsigned int nWorkers = simThreads < (unsigned int)runReqs.nTags() ? simThreads : runReqs.nTags();
+	for(unsigned int i=0; i<nWorkers; i++) {
+		Sim2PMT* C = simData.makeCursor();
+		if(!C) { smassert(!i); return false; }
+		cursors.push_back(C);
+	}
+	// every random draw must come from the cursor's own per-event stream, or results depend on thread scheduling
+	for(std::vector<Sim2PMT*>::iterator it = cursors.begin(); it != cursors.end(); it++) {
+		for(Side s = EAST; s <= WEST; ++s) {
+			if((*it)->PGen[s].getRNG() == &(*it)->simRNG) continue;
+			printf("Simulation generators share a random source; parallel simulation refused.\n");
+			for(std::vector<Sim2PMT*>::iterator it2 = cursors.begin(); it2 != cursors.end(); it2++) delete(*it2);
+			return false;
+		}
+	}
+	
+	// plan jobs (database access and histogram creation stay on this thread)
+	const ULong64_t a0 = simData.nextStreamIndex();
+	const double nRequested = runReqs.total();
+	smassert(nRequested);
+	std::vector<SimSpan> src;
+	if(replay) src = *replay;
+	else { SimSpan s0 = {a0, 0, 0}; src.push_back(s0); }
+	std::vector<SimRunJob> jobs;
+	CalDB* CDB = CalDBSnapshot::getCDB();
+	double nBefore = 0;
+	ULong64_t nTaken = 0;
+	for(std::map<RunNum,double>::const_iterator it = runReqs.counts.begin(); it != runReqs.counts.end(); it++) {
+		RunInfo RI = CDB->getRunInfo(it->first);
+		if(RI.gvState != GV_OPEN) { printf("Skipping simulation for background run "); RI.display(); continue; }
+		smassert(RI.afpState <= AFP_OTHER);
+		SimRunJob J;
+		J.rn = it->first;
+		J.afp = RI.afpState;
+		J.rntime = CDB->fiducialTime(it->first)[BOTH];
+		J.nReq = it->second;
+		J.countAll = nCounts;
+		if(nCounts) {
+			// same apportionment as serial simMultiRuns: contiguous run of events from source spans
+			int n = int(((nBefore+it->second)/nRequested)*nCounts)-(int)nTaken;
+			J.nToSim = n>0?n:1;
+			J.spans = takeSpans(src, nTaken, J.nToSim+1);
+			nTaken += J.nToSim+1;
+		} else {
+			// each run starts at its share of the input, on its own random sub-stream
+			J.nToSim = (unsigned int)it->second;
+			SimSpan s = { a0 + (ULong64_t)(simData.nEvents*(nBefore/nRequested)), 0, (unsigned int)jobs.size()+1 };
+			J.spans.push_back(s);
+		}
+		nBefore += it->second;
+		J.PCal = new PMTCalibrator(J.rn,CDB);
+		J.RA = (RunAccumulator*)makeAnalyzer("nameUnused","");
+		J.nSimmed = 0;
+		J.nCounted = 0;
+		jobs.push_back(J);
+	}
+	printf("Simulating %i runs on %i threads...\n",(int)jobs.size(),nWorkers);
+	
+	// run jobs on worker pool
+	runSimJobs(jobs,cursors);
+	for(std::vector<Sim2PMT*>::iterator it = cursors.begin(); it != cursors.end(); it++)
+		for(Side s = EAST; s <= WEST; ++s)
+			simData.PGen[s].addTrigValidation((*it)->PGen[s]);
+	
+	// optionally re-run all jobs on one thread, to verify results are independent of thread count
+	std::vector<SimRunJob> checkJobs;
+	if(simThreadsCheck && nWorkers > 1) {
+		checkJobs = jobs;
+		for(std::vector<SimRunJob>::iterator it = checkJobs.begin(); it != checkJobs.end(); it++) {
+			it->RA = (RunAccumulator*)makeAnalyzer("nameUnused","");
+			it->used.clear();
+			it->err = std::exception_ptr();
+		}
+		std::vector<Sim2PMT*> oneCursor(1,cursors[0]);
+		runSimJobs(checkJobs,oneCursor);
+	}
+	for(std::vector<Sim2PMT*>::iterator it = cursors.begin(); it != cursors.end(); it++) delete(*it);
+	
+	// merge results in fixed pairwise tree order
+	nSimmed = 0;
+	used.clear();
+	ULong64_t aEnd = a0;
+	std::exception_ptr err;
+	for(std::vector<SimRunJob>::iterator it = jobs.begin(); it != jobs.end(); it++) {
+		delete(it->PCal);
+		if(it->err && !err) err = it->err;
+		nSimmed += it->nSimmed;
+		for(std::vector<SimSpan>::const_iterator sit = it->used.begin(); sit != it->used.end(); sit++) {
+			used.push_back(*sit);
+			if(sit->first+sit->n > aEnd) aEnd = sit->first+sit->n;
+		}
+	}
+	for(std::vector<SimRunJob>::iterator it = checkJobs.begin(); it != checkJobs.end(); it++)
+		if(it->err && !err) err = it->err;
+	unsigned int nMismatched = 0;
+	if(!err) {
+		mergeSimJobs(jobs);
+		if(checkJobs.size()) {
+			mergeSimJobs(checkJobs);
+			nMismatched = compareSimResults(*jobs[0].RA,*checkJobs[0].RA);
+			printf("Thread-count check: %i histograms differ between %i-thread and 1-thread simulation.\n",nMismatched,nWorkers);
+		}
+		if(jobs.size() && !nMismatched) addSegment(*jobs[0].RA);
+	}
+	for(std::vector<SimRunJob>::iterator it = jobs.begin(); it != jobs.end(); it++) delete(it->RA);
+	for(std::vector<SimRunJob>::iterator it = checkJobs.begin(); it != checkJobs.end(); it++) delete(it->RA);
+	if(err) std::rethrow_exception(err);
+	if(nMismatched) {
+		SMExcept e("simThreadsMismatch");
+		e.insert("nThreads",nWorkers);
+		e.insert("nMismatched",nMismatched);
+		throw(e);
+	}
+	
+	// continue serial scanning past all used input
+	simData.seekStream(aEnd);
+	return true;
+}
+
 void RunAccumulator::makeOutput(bool doPlots) {
 	if(needsSubtraction)
 		bgSubtractAll();
@@ -551,7 +914,17 @@ unsigned int RunAccumulator::mergeDir() {
 }
 
 
-void RunAccumulator::mergeOcts(const std::vector<Octet>& Octs) {
+bool RunAccumulator::mergeOcts(const std::vector<Octet>& Octs) {
+	SegmentManifest M(*this,Octs,basePath,dataPath+"/"+name);
+	if(!forceRescan && M.isCurrent() && inflExists(dataPath+"/"+name)) {
+		printf("No octets in '%s' changed since previous merge; loading previous merge\n",basePath.c_str());
+		RunAccumulator* prevRA = (RunAccumulator*)makeAnalyzer(name,dataPath+"/"+name);
+		addSegment(*prevRA);
+		qOut.transfer(prevRA->qOut,"Octet");
+		delete(prevRA);
+		return false;
+	}
+	M.write(qOut);
 	for(std::vector<Octet>::const_iterator octit = Octs.begin(); octit != Octs.end(); octit++) {
 		std::string inflname = basePath+"/"+octit->octName()+"/"+octit->octName();
 		if(!inflExists(inflname)) {
@@ -564,6 +937,7 @@ void RunAccumulator::mergeOcts(const std::vector<Octet>& Octs) {
 		qOut.insert("Octet",octit->toStringmap());
 	}
 	makeOutput();
+	return true;
 }
 
 
@@ -596,7 +970,7 @@ unsigned int RunAccumulator::simuClone(const std::string& basedata, Sim2PMT& sim
 	int nCloned = 0;
 	
 	// check if simulation is already up-to-date
-	if(getInflAge() && getInflAge() < replaceIfOlder) {
+	if(!forceRescan && getInflAge() && getInflAge() < replaceIfOlder) {
 		printf("\tSimulations in '%s' already recently generated, update skipped...\n",basePath.c_str());
 		return nCloned;
 	}
@@ -644,7 +1018,7 @@ unsigned int RunAccumulator::simuClone(const std::string& basedata, Sim2PMT& sim
 		for(std::map<RunNum,double>::iterator it = origRA->runCounts.counts.begin(); it != origRA->runCounts.counts.end(); it++) {
 			nCloned++;
 			if(!it->first || !it->second) continue;
-			RunInfo RI = CalDBSQL::getCDB()->getRunInfo(it->first);
+			RunInfo RI = CalDBSnapshot::getCDB()->getRunInfo(it->first);
 			// no simulation for background runs
 			if(RI.gvState != GV_OPEN) {
 				runCounts.add(it->first,0);
@@ -664,24 +1038,38 @@ unsigned int RunAccumulator::simuClone(const std::string& basedata, Sim2PMT& sim
 		AFPState bigafp = countRequests[AFP_OFF].total()>=countRequests[AFP_ON].total()?AFP_OFF:AFP_ON;
 		AFPState smallafp = bigafp?AFP_OFF:AFP_ON;
 		smassert(countRequests[bigafp].nTags());
-		// determine starting point in simulation data to which we can return later
+		// determine starting point in simulation data to which we can return later (reproducibly chosen from seed)
+		unsigned int rseed = countRequests[bigafp].counts.begin()->first;
+		simData.setStartSeed(rseed);
 		unsigned int startEvt = 0;
 		while(!startEvt) {
 			simData.startScan(true);
 			startEvt = simData.getCurrentEvent();
 		}
-		unsigned int rseed = countRequests[bigafp].counts.begin()->first;
-		PMTGenerator::sim_rnd_source.SetSeed(rseed);
-		RunAccumulator::rnd_source.SetSeed(rseed);
-		unsigned int nSimmed = simMultiRuns(simData, countRequests[bigafp]);
-		// return to starting point or continue on with different data
+		// random streams keyed by (rseed, input event) regardless of which run each event lands in
+		simData.setRNGSeed(rseed,rseed);
+		RunAccumulator::rnd_source.setBaseSeed(rseed);
+		const unsigned int startPasses = simData.nScanPasses;
+		unsigned int nSimmed = 0;
+		std::vector<SimSpan> simSpans;
+		const bool parallel = simMultiRunsParallel(simData, countRequests[bigafp], 0, nSimmed, simSpans);
+		if(!parallel) nSimmed = simMultiRuns(simData, countRequests[bigafp]);
+		// return to starting point (parallel: replay the same input spans) or continue on with different data
 		if(simPerfectAsym) {
-			PMTGenerator::sim_rnd_source.SetSeed(rseed);
-			RunAccumulator::rnd_source.SetSeed(rseed);
-			simData.gotoEvent(startEvt);
-			simMultiRuns(simData, countRequests[smallafp], nSimmed);
+			RunAccumulator::rnd_source.setBaseSeed(rseed);
+			if(parallel) {
+				unsigned int nReplayed;
+				std::vector<SimSpan> replaySpans;
+				simMultiRunsParallel(simData, countRequests[smallafp], nSimmed, nReplayed, replaySpans, &simSpans);
+			} else {
+				simData.gotoEvent(startEvt);
+				simData.nScanPasses = startPasses;
+				simMultiRuns(simData, countRequests[smallafp], nSimmed);
+			}
 		} else {
-			simMultiRuns(simData, countRequests[smallafp]);
+			unsigned int nSimmed2;
+			if(!parallel || !simMultiRunsParallel(simData, countRequests[smallafp], 0, nSimmed2, simSpans))
+				simMultiRuns(simData, countRequests[smallafp]);
 		}
 		
 		// clone background counts in original data
@@ -785,15 +1173,19 @@ unsigned int processOctets(RunAccumulator& RA, const std::vector<Octet>& Octs, d
 		
 		if(octit->grouping > GROUP_FGBG) {
 			// make sub-Analyzer for this octet, to load data if already available, otherwise re-process
+			// unchanged segments (manifest digest covers all runs below) are loaded whole; changed ones are re-merged from their subdivisions
 			RunAccumulator* subRA;
 			std::string inflname = RA.basePath+"/"+octit->octName()+"/"+octit->octName();
+			SegmentManifest M(RA,*octit,inflname);
 			double fAge = fileAge(inflname+".root");
-			if(SegmentSaver::inflExists(inflname) && fAge < replaceIfOlder) {
-				printf("Octet '%s' already scanned %.1fh ago; skipping\n",octit->octName().c_str(),fAge/3600);
+			if(!RunAccumulator::forceRescan && SegmentSaver::inflExists(inflname) && (M.isCurrent() || (!M.isTracked() && fAge < replaceIfOlder))) {
+				printf("Octet '%s' inputs unchanged since scan %.1fh ago; skipping\n",octit->octName().c_str(),fAge/3600);
 				subRA = (RunAccumulator*)RA.makeAnalyzer(octit->octName(),inflname);
 			} else {
+				if(SegmentSaver::inflExists(inflname)) M.displayChanges();
 				subRA = (RunAccumulator*)RA.makeAnalyzer(octit->octName(),"");
 				subRA->grouping = octit->grouping;
+				M.write(subRA->qOut);
 				nproc += processOctets(*subRA,octit->getSubdivs(subdivide(octit->grouping),false),replaceIfOlder, doPlots);
 			}
 			RA.addSegment(*subRA);
@@ -10,6 +10,7 @@
 #include "Octet.hh"
 #include "AnalysisDB.hh"
 #include <TRandom3.h>
+#include "CounterRNG.hh"
 
 class AnalyzerPlugin;
 
@@ -89,6 +90,11 @@ public:
 	
 	/// fill data from a ProcessedDataScanner
 	virtual void loadProcessedData(AFPState afp, GVState gv, ProcessedDataScanner& PDS);
+	/// load single current event from ProcessedDataScanner
+	virtual void loadProcessedPoint(ProcessedDataScanner& PDS);
+	/// loadProcessedData with PDS's events split over dataThreads worker threads, each filling a makeAnalyzer copy;
+	/// returns false (loading nothing) if PDS or any plugin does not support this
+	bool loadProcessedParallel(AFPState afp, GVState gv, ProcessedDataScanner& PDS);
 	/// fill data from simulations
 	virtual void loadSimData(Sim2PMT& simData, unsigned int nToSim = 0, bool countAll = false);
 	/// load single current event from simulator
@@ -97,6 +103,10 @@ public:
 	void simForRun(Sim2PMT& simData, RunNum rn, unsigned int nToSim, bool countAll = false);
 	/// simulate for many runs, possibly apportioning a fixed number of counts among them; return number of events thrown
 	unsigned int simMultiRuns(Sim2PMT& simData, const TagCounter<RunNum>& runReqs, unsigned int nCounts = 0);
+	/// simMultiRuns with runs spread over simThreads worker threads, each on its own cursor into simData's input;
+	/// fills input spans used, optionally re-using (in order) spans from a previous pass. Returns false if simData does not support cursors, or any plugin is not parallelFill-safe.
+	bool simMultiRunsParallel(Sim2PMT& simData, const TagCounter<RunNum>& runReqs, unsigned int nCounts, unsigned int& nSimmed,
+							  std::vector<SimSpan>& used, const std::vector<SimSpan>* replay = NULL);
 	/// simulate background fluctuations based on "reference" data
 	void simBgFlucts(const RunAccumulator& RefOA, double simfactor, bool addFluctCounts = true);
 	/// perform background subtraction
@@ -111,7 +121,7 @@ public:
 	TagCounter<RunNum> runCounts;	///< type-0 event counts by run, for re-simulation
 	
 	/// set current AFP, GV state
-	void setCurrentState(AFPState afp, GVState gv);
+	virtual void setCurrentState(AFPState afp, GVState gv);
 	/// fill core histograms in plugins from data point
 	virtual void fillCoreHists(ProcessedDataScanner& PDS, double weight);
 	/// calculate results from filled histograms
@@ -126,6 +136,8 @@ public:
 	void addPlugin(AnalyzerPlugin* AP);
 	/// get plugin by name
 	AnalyzerPlugin* getPlugin(const std::string& nm);
+	/// hash of analyzer configuration (plugins, their settings, saved histogram layout), for dependency tracking
+	unsigned long long configHash() const;
 	
 	/// location of errorbar estimates for low-rate histograms
 	virtual std::string estimatorHistoLocation() const { return processedLocation; }
@@ -146,12 +158,16 @@ public:
 	unsigned int mergeDir();
 	/// merge simulations, checking match against data
 	void mergeSims(const std::string& basedata, RunAccumulator* origRA=NULL);
-	/// merge individual analyzed octets
-	void mergeOcts(const std::vector<Octet>& Octs);
+	/// merge individual analyzed octets (previous merge loaded instead if none changed); return whether newly merged
+	bool mergeOcts(const std::vector<Octet>& Octs);
 	/// copy times from another RunAccumulator (for simulations)
 	void copyTimes(const RunAccumulator& RA);
 	
 	bool simPerfectAsym;	///< whether to simulate "perfect" asymmetry by re-using simulation events
+	static unsigned int simThreads;	///< number of worker threads for simulation cloning (0 for serial)
+	static bool simThreadsCheck;	///< whether to re-run parallel simulation on one thread and require identical results
+	static unsigned int dataThreads;	///< number of worker threads for processed data scanning (0 for serial)
+	static bool forceRescan;	///< whether to re-scan/re-merge all segments regardless of manifests or output age
 	
 	/// store AnalysisDB number for uploading
 	void uploadAnaNumber(AnaNumber& AN, GVState g = GV_OTHER, AFPState a = AFP_OTHER);
@@ -168,7 +184,7 @@ protected:
 	std::vector<AnaNumber> anaResults[GV_OTHER+1][AFP_OTHER+1];	///< analysis results in each GV/AFP category
 	
 	std::map<std::string,AnalyzerPlugin*> myPlugins;	///< analysis plugins
-	static TRandom3 rnd_source;							///< random number source
+	static CounterRNG rnd_source;						///< random number source, keyed by (histogram, bin) for background fluctuations
 	
 	/// get matching RunAccumulator with "master" histograms for estimating error bars on low-counts bins
 	RunAccumulator* getErrorEstimator();
@@ -178,7 +194,7 @@ protected:
 class AnalyzerPlugin: private NoCopy {
 public:
 	/// constructor
-	AnalyzerPlugin(RunAccumulator* RA, const std::string& nm): name(nm), myA(RA) { }
+	AnalyzerPlugin(RunAccumulator* RA, const std::string& nm): name(nm), myA(RA), parallelFill(false) { }
 	/// destructor
 	virtual ~AnalyzerPlugin() {}
 	/// create or load a FG/BG TH1F* set
@@ -194,6 +210,7 @@ public:
 	RunAccumulator* myA;			///< RunAccumulator with which this plugin is associated
 	AFPState currentAFP;			///< current state of AFP during data scanning
 	GVState currentGV;				///< current foreground/background status during data scanning
+	bool parallelFill;				///< whether fillCoreHists only touches this plugin's own histograms, so copies may fill concurrently
 	
 	/// virtual routine for filling core histograms from data point
 	virtual void fillCoreHists(ProcessedDataScanner& PDS, double weight) = 0;
@@ -205,6 +222,8 @@ public:
 	/// virtual routine for MC/Data comparison plots/calculations
 	/// NOTE: this MUST NOT change the contents of saved histograms (calculated ones are OK)
 	virtual void compareMCtoData(AnalyzerPlugin*) {}
+	/// settings affecting filled histograms (cuts, binning choices...), for dependency tracking of processed output
+	virtual std::string getConfig() const { return ""; }
 
 protected:
 	std::vector<fgbgPair*> myHists;	///< histograms registered by this plugin
@@ -213,7 +232,8 @@ protected:
 	void makeRatesSummary();
 };
 
-/// process a set of octets; return number of processed pulse-pairs
+/// process a set of octets, re-using previous output for segments whose dependency manifest is unchanged
+/// (or, for output without a manifest, less than replaceIfOlder seconds old) unless RunAccumulator::forceRescan; return number of processed pulse-pairs
 unsigned int processOctets(RunAccumulator& RA, const std::vector<Octet>& O, double replaceIfOlder = 0, bool doPlots = true);
 /// re-process a set of octets using previously booked histograms; return number of processed pulse-pairs
 unsigned int recalcOctets(RunAccumulator& RA, const std::vector<Octet>& Octs, bool doPlots);
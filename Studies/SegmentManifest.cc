@@ -0,0 +1,129 @@
+#include "SegmentManifest.hh"
+#include "RunAccumulator.hh"
+#include "PostOfficialAnalyzer.hh"
+#include "CalDBSnapshot.hh"
+#include "PathUtils.hh"
+#include "strutils.hh"
+#include <stdio.h>
+
+/// long long to string
+static std::string lltos(long long i) {
+	char c[32];
+	sprintf(c,"%lld",i);
+	return std::string(c);
+}
+
+/// replay file records (size, modification time, hash) seen in previous manifests, by file name
+static std::map<std::string,Stringmap> knownFiles;
+/// per-run dependency records already computed this session
+static std::map<RunNum,Stringmap> runRecords;
+
+/// get dependency record for run, re-hashing replay file only if its stamp is unknown or changed
+static const Stringmap& runRecord(RunNum rn) {
+	std::map<RunNum,Stringmap>::const_iterator it = runRecords.find(rn);
+	if(it != runRecords.end()) return it->second;
+
+	static PostOfficialAnalyzer POA;
+	Stringmap m;
+	m.insert("run",itos(rn));
+	std::string fname = POA.locateRun(rn);
+	long long fsize, fmtime;
+	fileStamp(fname,fsize,fmtime);
+	m.insert("file",fname);
+	m.insert("size",lltos(fsize));
+	m.insert("mtime",lltos(fmtime));
+	std::map<std::string,Stringmap>::const_iterator kit = knownFiles.find(fname);
+	if(fname.size() && kit != knownFiles.end()
+	   && kit->second.getDefault("size","") == lltos(fsize) && kit->second.getDefault("mtime","") == lltos(fmtime))
+		m.insert("fileHash",kit->second.getDefault("fileHash",""));
+	else
+		m.insert("fileHash",hashToString(fileHash(fname)));
+	m.insert("calHash",hashToString(CalDBSnapshot::runDigest(*CalDBSnapshot::getCDB(),rn)));
+	return runRecords[rn] = m;
+}
+
+SegmentManifest::SegmentManifest(const RunAccumulator& RA, const Octet& oct, const std::string& inflname) {
+	loadPrevious(inflname);
+
+	summary.insert("runs",hashToString(hashString(oct.toStringmap().toString())));
+	summary.insert("config",hashToString(RA.configHash()));
+	unsigned long long h = hashString(summary.getDefault("runs","")+"/"+summary.getDefault("config",""));
+
+	std::vector<RunNum> rns = oct.getAllRuns();
+	for(std::vector<RunNum>::const_iterator it = rns.begin(); it != rns.end(); it++) {
+		const Stringmap& r = runRecord(*it);
+		runDeps.push_back(r);
+		std::string inputs = r.getDefault("fileHash","")+"/"+r.getDefault("calHash","");
+		h = hashString(itos(*it)+":"+inputs,h);
+		std::map<RunNum,Stringmap>::const_iterator pit = prevRuns.find(*it);
+		if(pit == prevRuns.end() || pit->second.getDefault("fileHash","")+"/"+pit->second.getDefault("calHash","") != inputs)
+			changedRuns.push_back(*it);
+	}
+
+	digest = hashToString(h);
+	summary.insert("digest",digest);
+}
+
+SegmentManifest::SegmentManifest(const RunAccumulator& RA, const std::vector<Octet>& octs, const std::string& basePath, const std::string& inflname) {
+	loadPrevious(inflname);
+
+	summary.insert("config",hashToString(RA.configHash()));
+	unsigned long long h = hashString(summary.getDefault("config",""));
+	bool complete = true;
+	unsigned int nSegs = 0;
+	for(std::vector<Octet>::const_iterator it = octs.begin(); it != octs.end(); it++) {
+		if(!it->getNRuns()) continue;
+		std::string d = storedDigest(basePath+"/"+it->octName()+"/"+it->octName());
+		complete &= d.size() > 0;
+		h = hashString(it->octName()+":"+d,h);
+		nSegs++;
+	}
+	summary.insert("segments",itos(nSegs));
+
+	// merging anything without a manifest is never considered up-to-date
+	if(complete) digest = hashToString(h);
+	summary.insert("digest",digest);
+}
+
+void SegmentManifest::loadPrevious(const std::string& inflname) {
+	if(!fileExists(inflname+".txt")) return;
+	QFile Q(inflname+".txt");
+	prevSummary = Q.getFirst("depManifest");
+	prevDigest = prevSummary.getDefault("digest","");
+	std::vector<Stringmap> rs = Q.retrieve("depRun");
+	for(std::vector<Stringmap>::const_iterator it = rs.begin(); it != rs.end(); it++) {
+		prevRuns[it->getDefaultI("run",0)] = *it;
+		std::string fname = it->getDefault("file","");
+		if(fname.size()) knownFiles[fname] = *it;
+	}
+}
+
+void SegmentManifest::displayChanges() const {
+	if(!isTracked()) {
+		printf("\tNo dependency manifest for previous output.\n");
+		return;
+	}
+	if(prevSummary.getDefault("config","") != summary.getDefault("config",""))
+		printf("\tAnalyzer configuration changed.\n");
+	if(prevSummary.getDefault("runs","") != summary.getDefault("runs",""))
+		printf("\tRun list changed.\n");
+	if(changedRuns.size()) {
+		printf("\tInputs changed for %i runs:",(int)changedRuns.size());
+		for(std::vector<RunNum>::const_iterator it = changedRuns.begin(); it != changedRuns.end(); it++)
+			printf(" %i",*it);
+		printf("\n");
+	}
+}
+
+void SegmentManifest::write(QFile& Q) const {
+	Q.erase("depManifest");
+	Q.erase("depRun");
+	Q.insert("depManifest",summary);
+	for(std::vector<Stringmap>::const_iterator it = runDeps.begin(); it != runDeps.end(); it++)
+		Q.insert("depRun",*it);
+}
+
+std::string SegmentManifest::storedDigest(const std::string& inflname) {
+	if(!fileExists(inflname+".txt")) return "";
+	return QFile(inflname+".txt").getFirst("depManifest").getDefault("digest","");
+}
@@ -0,0 +1,49 @@
+#ifndef SEGMENTMANIFEST_HH
+#define SEGMENTMANIFEST_HH
+
+#include "QFile.hh"
+#include "Octet.hh"
+#include "Types.hh"
+#include <string>
+#include <vector>
+#include <map>
+
+class RunAccumulator;
+
+/// Dependency manifest for an analyzed segment (octet, quad, pair...), stored in the segment's .txt output.
+/// Records hashes of the run list, of each run's replay file and calibration records, and of the analyzer
+/// configuration, so a segment is re-processed only when something it was computed from actually changes.
+/// Replay files are only re-read for hashing when their size or modification time differs from the previous manifest.
+class SegmentManifest {
+public:
+	/// constructor, for processing octet with RA into output inflname (previous output, if present, is read for comparison)
+	SegmentManifest(const RunAccumulator& RA, const Octet& oct, const std::string& inflname);
+	/// constructor, for merging octets already processed into basePath/[octName]/[octName]
+	SegmentManifest(const RunAccumulator& RA, const std::vector<Octet>& octs, const std::string& basePath, const std::string& inflname);
+
+	/// whether previous output was made from identical inputs
+	bool isCurrent() const { return digest.size() && prevDigest == digest; }
+	/// whether previous output has a manifest to compare against
+	bool isTracked() const { return prevDigest.size(); }
+	/// print summary of changes relative to previous output
+	void displayChanges() const;
+	/// store manifest in output QFile (replacing any previous manifest)
+	void write(QFile& Q) const;
+	/// combined digest stored with segment output ("" if none)
+	static std::string storedDigest(const std::string& inflname);
+
+	std::string digest;				///< combined hash of all dependencies ("" if any are unknown)
+	std::string prevDigest;			///< combined hash stored with previous output ("" if none)
+	Stringmap summary;				///< run list, configuration and input hashes, combined digest
+	std::vector<Stringmap> runDeps;	///< per-run records: replay file, size, modification time, file hash, calibration hash
+	std::vector<RunNum> changedRuns;///< runs with inputs changed (or added) since previous output
+
+protected:
+	/// load previous manifest from segment output
+	void loadPrevious(const std::string& inflname);
+
+	Stringmap prevSummary;					///< previous output summary
+	std::map<RunNum,Stringmap> prevRuns;	///< previous output per-run records
+};
+
+#endif
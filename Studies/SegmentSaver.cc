@@ -1,8 +1,12 @@
 #include "SegmentSaver.hh"
 #include "Types.hh"
 #include "PathUtils.hh"
+#include "strutils.hh"
 #include "SMExcept.hh"
 #include <TString.h>
+#include <TProfile.h>
+#include <TArrayF.h>
+#include <TArrayD.h>
 
 TH1* SegmentSaver::tryLoad(const std::string& hname) {
 	if(!fIn) return NULL;
@@ -23,28 +27,48 @@ TH1* SegmentSaver::tryLoad(const std::string& hname) {
 	return h;
 }
 
+void SegmentSaver::addSavedHist(const std::string& hname, TH1* h) {
+	smassert(savedIndex.find(hname)==savedIndex.end());	// don't duplicate names!
+	savedIndex.insert(std::make_pair(hname,(unsigned int)savedHists.size()));
+	savedHists.push_back(h);
+	savedHistInfo i;
+	i.name = hname;
+	i.isProfile = h->InheritsFrom("TProfile") || h->InheritsFrom("TProfile2D");
+	i.fastAdd = !i.isProfile && (dynamic_cast<TArrayF*>(h) || dynamic_cast<TArrayD*>(h));
+	savedInfo.push_back(i);
+	// hash over names, including terminating 0, and binning of each axis
+	layoutHash = hashBytes(hname.c_str(),hname.size()+1,layoutHash);
+	const TAxis* axes[3] = {h->GetXaxis(), h->GetYaxis(), h->GetZaxis()};
+	for(unsigned int a=0; a<3; a++) {
+		double b[3] = {(double)axes[a]->GetNbins(), axes[a]->GetXmin(), axes[a]->GetXmax()};
+		layoutHash = hashBytes(b,sizeof(b),layoutHash);
+		const TArrayD* xb = axes[a]->GetXbins();
+		if(xb->GetSize()) layoutHash = hashBytes(xb->GetArray(),xb->GetSize()*sizeof(double),layoutHash);
+	}
+}
+
 TH1* SegmentSaver::registerSavedHist(const std::string& hname, const std::string& title,unsigned int nbins, float xmin, float xmax) {
-	smassert(saveHists.find(hname)==saveHists.end());	// don't duplicate names!
+	smassert(savedIndex.find(hname)==savedIndex.end());	// don't duplicate names!
 	TH1* h = tryLoad(hname);
 	if(!h)
 		h = registeredTH1F(hname,title,nbins,xmin,xmax);
-	saveHists.insert(std::make_pair(hname,h));
+	addSavedHist(hname,h);
 	return h;
 }
 
 TH1* SegmentSaver::registerSavedHist(const std::string& hname, const TH1& hTemplate) {
-	smassert(saveHists.find(hname)==saveHists.end());	// don't duplicate names!
+	smassert(savedIndex.find(hname)==savedIndex.end());	// don't duplicate names!
 	TH1* h = tryLoad(hname);
 	if(!h) {
 		h = (TH1*)addObject(hTemplate.Clone(hname.c_str()));
 		h->Reset();
 	}
-	saveHists.insert(std::make_pair(hname,h));
+	addSavedHist(hname,h);
 	return h;
 }
 
 SegmentSaver::SegmentSaver(OutputManager* pnt, const std::string& nm, const std::string& inflName):
-OutputManager(nm,pnt), ignoreMissingHistos(false), inflname(inflName), isCalculated(false), inflAge(0) {
+OutputManager(nm,pnt), ignoreMissingHistos(false), inflname(inflName), isCalculated(false), layoutHash(0xCBF29CE484222325ULL), inflAge(0) {
 	// open file to load existing data
 	fIn = (inflname.size())?(new TFile((inflname+".root").c_str(),"READ")):NULL;
 	smassert(!fIn || !fIn->IsZombie());
@@ -65,43 +89,88 @@ bool SegmentSaver::inflExists(const std::string& inflName) {
 	return fileExists(inflName+".root") && fileExists(inflName+".txt");
 }
 
-TH1* SegmentSaver::getSavedHist(const std::string& hname) {
-	std::map<std::string,TH1*>::iterator it = saveHists.find(hname);
-	smassert(it != saveHists.end());
+unsigned int SegmentSaver::getSavedHandle(const std::string& hname) const {
+	std::map<std::string,unsigned int>::const_iterator it = savedIndex.find(hname);
+	smassert(it != savedIndex.end());
 	return it->second;
 }
 
+TH1* SegmentSaver::getSavedHist(const std::string& hname) {
+	return savedHists[getSavedHandle(hname)];
+}
+
 const TH1* SegmentSaver::getSavedHist(const std::string& hname) const {
-	std::map<std::string,TH1*>::const_iterator it = saveHists.find(hname);
-	smassert(it != saveHists.end());
-	return it->second;
+	return savedHists[getSavedHandle(hname)];
 }
 
 void SegmentSaver::zeroSavedHists() {
-	for(std::map<std::string,TH1*>::iterator it = saveHists.begin(); it != saveHists.end(); it++)
-		it->second->Reset();
+	for(std::vector<TH1*>::iterator it = savedHists.begin(); it != savedHists.end(); it++)
+		(*it)->Reset();
 }
 
 void SegmentSaver::scaleData(double s) {
 	if(s==1.) return;
-	for(std::map<std::string,TH1*>::iterator it = saveHists.begin(); it != saveHists.end(); it++)
-		if(it->second->ClassName() != TString("TProfile"))
-			it->second->Scale(s);
+	for(unsigned int i=0; i<savedHists.size(); i++)
+		if(!savedInfo[i].isProfile)
+			savedHists[i]->Scale(s);
 }
 
 bool SegmentSaver::isEquivalent(const SegmentSaver& S) const {
-	if(saveHists.size() != S.saveHists.size()) return false;
-	for(std::map<std::string,TH1*>::const_iterator it = saveHists.begin(); it != saveHists.end(); it++) {
-		std::map<std::string,TH1*>::const_iterator otherit = S.saveHists.find(it->first);
-		if(otherit == S.saveHists.end()) return false;
-		// TODO other checks?
+	if(savedHists.size() != S.savedHists.size()) return false;
+	if(sameLayout(S)) return true;
+	for(std::vector<savedHistInfo>::const_iterator it = savedInfo.begin(); it != savedInfo.end(); it++)
+		if(S.savedIndex.find(it->name) == S.savedIndex.end()) return false;
+	return true;
+}
+
+/// add bin contents (and errors, statistics) of b to a, directly on float/double storage arrays;
+/// returns false (doing nothing) if histograms are not simple matching types
+static bool addBinArrays(TH1* a, const TH1* b) {
+	const int n = a->GetNcells();
+	if(b->GetNcells() != n || a->IsA() != b->IsA() || a->GetBufferLength() || b->GetBufferLength()) return false;
+	TH1* bb = const_cast<TH1*>(b);
+	TArrayD* wa = a->GetSumw2();
+	const TArrayD* wb = bb->GetSumw2();
+	if((wa->GetSize() != 0) != (wb->GetSize() != 0)) return false;
+	
+	// statistics, before contents change
+	Double_t sa[TH1::kNstat], sb[TH1::kNstat];
+	for(int i=0; i<TH1::kNstat; i++) sa[i] = sb[i] = 0;
+	a->GetStats(sa);
+	bb->GetStats(sb);
+	const double nEntries = a->GetEntries() + b->GetEntries();
+	
+	if(TArrayF* fa = dynamic_cast<TArrayF*>(a)) {
+		Float_t* xa = fa->GetArray();
+		const Float_t* xb = dynamic_cast<const TArrayF*>(b)->GetArray();
+		for(int i=0; i<n; i++) xa[i] += xb[i];
+	} else if(TArrayD* da = dynamic_cast<TArrayD*>(a)) {
+		Double_t* xa = da->GetArray();
+		const Double_t* xb = dynamic_cast<const TArrayD*>(b)->GetArray();
+		for(int i=0; i<n; i++) xa[i] += xb[i];
+	} else return false;
+	if(wa->GetSize()) {
+		Double_t* xa = wa->GetArray();
+		const Double_t* xb = wb->GetArray();
+		for(int i=0; i<n; i++) xa[i] += xb[i];
 	}
+	
+	for(int i=0; i<TH1::kNstat; i++) sa[i] += sb[i];
+	a->PutStats(sa);
+	a->SetEntries(nEntries);
 	return true;
 }
 
 void SegmentSaver::addSegment(const SegmentSaver& S) {
 	smassert(isEquivalent(S));
-	// add histograms
-	for(std::map<std::string,TH1*>::const_iterator it = saveHists.begin(); it != saveHists.end(); it++)
-		it->second->Add(S.getSavedHist(it->first));
+	// same registration order: add by handle, directly on bin arrays where possible
+	if(sameLayout(S)) {
+		for(unsigned int i=0; i<savedHists.size(); i++)
+			if(!savedInfo[i].fastAdd || !addBinArrays(savedHists[i],S.savedHists[i]))
+				savedHists[i]->Add(S.savedHists[i]);
+		return;
+	}
+	// otherwise, match by name
+	for(unsigned int i=0; i<savedHists.size(); i++)
+		savedHists[i]->Add(S.getSavedHist(savedInfo[i].name));
 }
@@ -5,6 +5,7 @@
 #include <TH1.h>
 #include <TFile.h>
 #include <map>
+#include <vector>
 #include <string>
 
 /// class for saving, retrieving, and summing histograms from file
@@ -30,6 +31,14 @@ public:
 	TH1* getSavedHist(const std::string& hname);
 	/// get core histogram by name, const version
 	const TH1* getSavedHist(const std::string& hname) const;
+	/// get integer handle (registration order index) for named core histogram
+	unsigned int getSavedHandle(const std::string& hname) const;
+	/// get core histogram by handle
+	TH1* getSavedHist(unsigned int h) { return savedHists[h]; }
+	/// get core histogram by handle, const version
+	const TH1* getSavedHist(unsigned int h) const { return savedHists[h]; }
+	/// number of core histograms
+	unsigned int getNSaved() const { return savedHists.size(); }
 	/// zero out all saved histograms
 	void zeroSavedHists();
 	/// scale all saved histograms by a factor
@@ -39,6 +48,8 @@ public:
 	virtual void addSegment(const SegmentSaver& S);
 	/// check if this is equivalent layout to another SegmentSaver
 	virtual bool isEquivalent(const SegmentSaver& S) const;
+	/// check if another SegmentSaver registered the same histogram names in the same order (so handles match)
+	bool sameLayout(const SegmentSaver& S) const { return savedHists.size() == S.savedHists.size() && layoutHash == S.layoutHash; }
 	
 	bool ignoreMissingHistos;	///< whether to quietly ignore missing histograms in input file
 	
@@ -60,8 +71,20 @@ protected:
 	
 	/// attempt to load histogram from input file
 	TH1* tryLoad(const std::string& hname);
+	/// add histogram to registry
+	void addSavedHist(const std::string& hname, TH1* h);
 	
-	std::map<std::string,TH1*> saveHists;		///< saved histograms
+	/// registry metadata for each saved histogram
+	struct savedHistInfo {
+		std::string name;	///< histogram name
+		bool isProfile;		///< whether histogram is a TProfile (not scaled)
+		bool fastAdd;		///< whether bin contents may be added directly as float or double arrays
+	};
+	
+	std::vector<TH1*> savedHists;					///< saved histograms, indexed by handle
+	std::vector<savedHistInfo> savedInfo;			///< saved histogram metadata, indexed by handle
+	std::map<std::string,unsigned int> savedIndex;	///< handle lookup by histogram name
+	unsigned long long layoutHash;					///< hash of registered names and binnings, in order
 	double inflAge;								///< age of input file [s]; 0 for brand-new files
 };
 
@@ -81,7 +81,7 @@ void SimAsymmetryPlugin::fillCoreHists(ProcessedDataScanner& PDS, double weight)
 		((TProfile*)(qBCT[S2P.primSide][S2P.fType]->fillPoint))->Fill(S2P.getErecon(),beta(S2P.ePrim)*S2P.costheta);
 		((TProfile*)(qBeta[S2P.primSide][S2P.fType]->fillPoint))->Fill(S2P.getErecon(),beta(S2P.ePrim));
 		((TProfile*)(qCosth[S2P.primSide][S2P.fType]->fillPoint))->Fill(S2P.getErecon(),S2P.costheta);
-		((TProfile*)(qAsymAcc[S2P.primSide][S2P.fType]->fillPoint))->Fill(S2P.getErecon(),correctedAsymmetry(S2P.ePrim,S2P.costheta));
+		((TProfile*)(qAsymAcc[S2P.primSide][S2P.fType]->fillPoint))->Fill(S2P.getErecon(),correctedAsymmetryTab(S2P.ePrim,S2P.costheta));
 		if( (S2P.fType == TYPE_II_EVENT?otherSide(s):s) != S2P.primSide)
 			qWrongSide[s][S2P.fType]->fillPoint->Fill(S2P.getErecon(),weight);
 	}
@@ -1,5 +1,6 @@
 #include "WirechamberGainMapPlugins.hh"
 #include "Sim2PMT.hh"
+#include "strutils.hh"
 #include <time.h>
 #include <TProfile.h>
 
@@ -14,6 +15,10 @@ WirechamberGainMapPluginBase::WirechamberGainMapPluginBase(RunAccumulator* RA, u
 	}
 }
 
+std::string WirechamberGainMapPluginBase::getConfig() const {
+	return PositionBinnedPlugin::getConfig()+";chgprx="+itos(myChgPrx);
+}
+
 bool WirechamberGainMapPluginBase::evtLoc(const ProcessedDataScanner& PDS, Side& s, unsigned int& m, float& x, float& y) const {
 	s = PDS.fSide;
 	if(!(PDS.fType == TYPE_0_EVENT && PDS.fPID == PID_BETA && 400 <= PDS.getEnergy() && PDS.getEnergy() <= 600)) return false;
@@ -37,6 +42,10 @@ void WirechamberGainMapPluginBase::fillCoreHists(ProcessedDataScanner& PDS, doub
 }
 
 void WirechamberGainMapPluginBase::genPosmap(const std::string& pmapNameBase) const {
+	if(!myA->runCounts.counts.size()) {
+		printf("*** No runs in '%s'; position map '%s' not generated!\n",myA->name.c_str(),pmapNameBase.c_str());
+		return;
+	}
 	// name for position map
 	std::string pmapname = pmapNameBase+"_"+itos(myA->runCounts.counts.begin()->first)+"-"+itos(myA->runCounts.counts.rbegin()->first)+"/"+itos(time(NULL));
 	// Calibration DB to write output to
@@ -17,6 +17,8 @@ public:
 	
 	/// generate position map, upload to CalDB
 	void genPosmap(const std::string& pmapNameBase) const;
+	/// settings affecting filled histograms
+	virtual std::string getConfig() const;
 	
 	std::vector<fgbgPair*> sectHists[BOTH];	///< reconstructed energy histograms for each sector
 	fgbgPair* sectGains[BOTH];				///< prior average gains in each sector